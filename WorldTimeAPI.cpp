@@ -1,663 +1,1596 @@
-#include "WorldTimeAPI.h"
-
-#ifdef ARDUINO
-
-#if defined(ESP8266)
-#include <ESP8266WiFi.h>
-#include <ESP8266HTTPClient.h>
-
-//On ESP8266 there is missing String(const char* cstr, unsigned int length) constructor
-
-class StringE2 : public String {
-public:
-	using String::String;
-
-	StringE2(const char* cstr, unsigned int length) {
-		init();
-		if (cstr)
-			copy(cstr, length);
-	}
-};
-
-
-#elif defined(ESP32)
-#include <WiFi.h>
-#include <HTTPClient.h>
-#endif
-
-#endif // ARDUINO
-
-
-void WorldTimeAPIResult::clear() {
-	timezone[0] = 0;
-	abbreviation[0] = 0;
-#if defined(ARDUINO)
-#ifdef ESP8266
-	client_ip.clear();
-#else
-	client_ip = IPAddress();
-#endif // ESP8266
-	
-#else
-	client_ip[0] = 0;
-#endif // defined(ESP8266) || defined(ESP32)
-	datetime = DateTimeTZSysSync::Zero;
-	httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
-	error = "";
-	wasDST = false;
-}
-
-
-
-TimeZoneInfo WorldTimeAPIResult::toTimeZoneInfo() const {
-	TimeZoneInfo ret;
-	ret.keyName = timezone;
-	ret.timeZone = datetime.getTimeZone();
-	ret.DST = datetime.getDST();
-	if (wasDST) {
-#if _MSC_VER && !__INTEL_COMPILER
-		//Specific code for MVSC
-		strncpy_s(ret.daylightABR, abbreviation, (sizeof(ret.daylightABR) / sizeof(char)) - 1);
-
-#else
-		strncpy(ret.daylightABR, abbreviation, (sizeof(ret.daylightABR) / sizeof(char)) - 1);
-#endif
-		ret.daylightABR[(sizeof(ret.daylightABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
-
-		//Trying to guess standard abbreviation
-		//CET -> CESR
-		//NZST -> NZDT
-		bool DS_found = false;
-		int len = (int)strnlen(abbreviation, (sizeof(ret.standardABR) / sizeof(char)) - 1);
-		bool isD = false;
-		ret.standardABR[len] = 0; //Null termination
-		--len;
-		if (len >= 2 && abbreviation[len] == 'T' && (isD = abbreviation[len - 1] == 'D' || abbreviation[len - 1] == 'S')) {
-			if (isD) {
-				//For example HDT found and will be set to HST
-				ret.standardABR[len] = abbreviation[len];
-				--len;
-				ret.standardABR[len] = 'S';
-				--len;
-			}
-			else {
-				//For example CEST found and will be set to CET
-				ret.standardABR[len] = abbreviation[len];
-				len -= 2;
-			}
-			for (int cnt = 0; len >= 0; len--, cnt++) {
-				//Just copy
-				ret.standardABR[len] = abbreviation[len];
-			}
-		}
-		else {
-			//Special
-			//GMT -> BST
-			//IST -> GMT
-			if (strncmp(abbreviation, "GMT", 4) == 0) {
-#if _MSC_VER && !__INTEL_COMPILER
-				//Specific code for MVSC
-				strncpy_s(ret.standardABR, "IST", (sizeof(ret.standardABR) / sizeof(char)) - 1);
-#else
-				strncpy(ret.standardABR, "IST", (sizeof(ret.standardABR) / sizeof(char)) - 1);
-#endif
-				ret.standardABR[(sizeof(ret.standardABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
-			}
-			else if (strncmp(abbreviation, "BST", 4) == 0) {
-#if _MSC_VER && !__INTEL_COMPILER
-				//Specific code for MVSC
-				strncpy_s(ret.standardABR, "GMT", (sizeof(ret.standardABR) / sizeof(char)) - 1);
-#else
-				strncpy(ret.standardABR, "GMT", (sizeof(ret.standardABR) / sizeof(char)) - 1);
-#endif
-				ret.standardABR[(sizeof(ret.standardABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
-			}
-			else {
-#if _MSC_VER && !__INTEL_COMPILER
-				//Specific code for MVSC
-				strncpy_s(ret.standardABR, abbreviation, (sizeof(ret.standardABR) / sizeof(char)) - 1);
-#else
-				strncpy(ret.standardABR, abbreviation, (sizeof(ret.standardABR) / sizeof(char)) - 1);
-#endif
-				ret.standardABR[(sizeof(ret.standardABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
-			}
-		}
-	}
-	//else {
-		//Cannot guess, because we don't know if DST is used from WorldTimeAPI now
-	//}
-
-	//TODO fill missing fields
-
-	return ret;
-}
-
-#ifdef ARDUINO
-WorldTimeAPI_HttpCode WorldTimeAPI::getListOfTimeZones(String& list, const char* tz) {
-	String url = URL_TimeZone;
-#else
-WorldTimeAPI_HttpCode WorldTimeAPI::getListOfTimeZones(std::string& list, const char* tz) {
-	std::string url = URL_TimeZone;
-#endif // !ARDUINO
-	if (tz != NULL) {
-		url += '/';
-		url += tz;
-	}
-	url += ".txt";
-
-	int httpCode = requestGET(url.c_str(), list);
-	if (list.length() > 6 && strncmp("abbrev", list.c_str(), 6) == 0 && tz != NULL) {
-		//Time zone info was get, so return only one time zone name
-		list = tz;
-	}
-	return (WorldTimeAPI_HttpCode)httpCode;
-} 
-
-const WorldTimeAPIResult& WorldTimeAPI::getByTimeZone(const char* tz) {
-	if (tz == NULL) {
-		//tz cannot be NULL
-		lastRes.clear();
-		lastRes.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
-		return lastRes;
-	}
-#ifdef ARDUINO
-	String url = URL_TimeZone;
-#else
-	std::string url = URL_TimeZone;
-#endif // ARDUINO
-	url += '/';
-	url += tz;
-
-	return getAndParseTZ(url.c_str());
-}
-
-const WorldTimeAPIResult& WorldTimeAPI::getByIP(const char* IP) {
-#ifdef ARDUINO
-	String url = URL_IP;
-#else
-	std::string url = URL_IP;
-#endif // ARDUINO
-	if (IP != NULL) {
-		url += '/';
-		url += IP;
-	}
-
-	return getAndParseTZ(url.c_str());
-}
-
-#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
-const WorldTimeAPIResult& WorldTimeAPI::getByIP(const IPAddress& IP) {
-	lastRes.clear();
-
-#ifdef  ESP8266
-	if (!(IP.isV4() && IP.isSet())) {
-		//Unset IP or IPV6
-		lastRes.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
-		return lastRes;
-	}
-#endif //  ESP8266
-
-	String url = URL_IP;
-	url += '/';
-	url += IP.toString();
-
-	return getAndParseTZ(url.c_str());
-}
-#endif // !SJSONP_UNDER_OS
-
-
-const WorldTimeAPIResult& WorldTimeAPI::getAndParseTZ(const char* url) {
-	lastRes.clear();
-	int httpCode;
-#if defined(ARDUINO)
-	String response;
-#else
-	std::string response;
-#endif // !defined(ARDUINO)
-
-	httpCode = requestGET(url, response);
-	lastRes.httpCode = (WorldTimeAPI_HttpCode)httpCode;
-
-	//Serial.println(response);
-
-	if (lastRes.httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
-		//GET request successfull
-		WorldTimeAPIResHelper resHelper(&lastRes);
-		SimpleJSONTextParser parser;
-		parser.onItemFound = jsonItemTZ;
-		parser.onTextItemFound = jsonTextTZ;
-		parser.onObjArrFound = jsonControlTZ;
-//{"abbreviation":"CEST","client_ip":"185.142.49.50","datetime":"2022-06-16T13:57:27.659132+02:00","day_of_week":4,"day_of_year":167,"dst":true,"dst_from":"2022-03-27T01:00:00+00:00","dst_offset":3600,"dst_until":"2022-10-30T01:00:00+00:00","raw_offset":3600,"timezone":"Europe/Bratislava","unixtime":1655380647,"utc_datetime":"2022-06-16T11:57:27.659132+00:00","utc_offset":"+02:00","week_number":24}
-		int result = parser.parseJSON(response.c_str(), (int)response.length(), &resHelper);
-		//Serial.println(result);
-		if (!resHelper.foundFlags.allValidFound()) {
-			if (lastRes.httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) lastRes.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_MISSING;
-		}
-		else if (result <= 0) {
-			if (lastRes.httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) lastRes.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_RESPONSE;
-		}
-		else {
-			//Parsing OK
-			DSTAdjustment adj;
-			lastRes.wasDST = false;
-			if (!resHelper.dst_null) {
-				//Creating fake DST adjustment - TODO
-				//TODO there may be problem at winter or at south hemisphere
-
-				resHelper.dst_from += resHelper.tz.getTimeZoneOffset();
-				date_s tmp = resHelper.dst_from.getDateStruct();
-				DSTTransitionRule startRule = DSTTransitionRule::Date(resHelper.dst_from.getHours(), tmp.month, tmp.day);
-
-				resHelper.dst_until += resHelper.tz.getTimeZoneOffset() + (((int64_t)resHelper.dst_offset) * SECOND);
-				tmp = resHelper.dst_until.getDateStruct();
-				DSTTransitionRule endRule = DSTTransitionRule::Date(resHelper.dst_until.getHours(), tmp.month, tmp.day);
-
-				lastRes.wasDST = resHelper.dst;
-				adj = DSTAdjustment::fromTotalMinutesOffset(startRule, endRule, resHelper.dst_offset / 60, lastRes.wasDST);
-			}
-
-			resHelper.unixtime += resHelper.tz.getTimeZoneOffset() + adj.getDSTOffset();
-			lastRes.datetime = DateTimeTZSysSync(resHelper.unixtime, resHelper.tz, adj, lastRes.wasDST);
-		}
-	}
-	else if(lastRes.httpCode > WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE && response.length() > 0) {
-		//Trying to parse error
-		WorldTimeAPIResHelper resHelper(&lastRes);
-		SimpleJSONTextParser parser;
-		parser.onItemFound = jsonItemERR;
-		parser.onTextItemFound = jsonTextERR;
-		parser.onObjArrFound = jsonControlTZ;
-		parser.parseJSON(response.c_str(), (int)response.length(), &resHelper);
-	}
-	return lastRes;
-}
-
-bool WorldTimeAPI::jsonItemTZ(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr) {
-	if (depth != 1) return true; //We need only depth 1 here
-
-	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
-	if (keyLength == 12 && strncmp("abbreviation", key, 12) == 0) {
-		if (res.foundFlags.abbreviation_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-		}
-		res.foundFlags.abbreviation_found = true;
-		return false; //ERROR
-	}
-	else if (keyLength == 9 && strncmp("client_ip", key, 9) == 0) {
-		if (res.foundFlags.client_ip_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-		}
-		res.foundFlags.client_ip_found = true;
-		return false; //ERROR
-	}
-	else if (keyLength == 3 && strncmp("dst", key, 3) == 0) {
-		if (res.foundFlags.dst_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.dst_found = true;
-		if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Bool) {
-			res.dst = parsedVal.Value.Bool;
-		}
-		else if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Null) {
-			res.dst_null = true; //Null found
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-			return false; //ERROR: wrong type
-		}
-	}
-	else if (keyLength == 8 && strncmp("dst_from", key, 8) == 0) { //Can return null
-		if (res.foundFlags.dst_from_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.dst_from_found = true;
-		if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Null) {
-			res.dst_null = true; //Null found
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-			return false; //ERROR: wrong type
-		}
-	}
-	else if (keyLength == 10 && strncmp("dst_offset", key, 10) == 0) {
-		if (res.foundFlags.dst_offset_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.dst_offset_found = true;
-		if (parsedVal.Type >= SimpleJSONTextParser::Number::NT_Int8 && parsedVal.Type <= SimpleJSONTextParser::Number::NT_Uint16) {
-			//Valid number found
-			res.dst_offset = parsedVal.Value.Int16;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-			return false; //ERROR: wrong type
-		}
-	}
-	else if (keyLength == 9 && strncmp("dst_until", key, 9) == 0) { //Can return null
-		if (res.foundFlags.dst_until_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.dst_until_found = true;
-		if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Null) {
-			res.dst_null = true; //Null found
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-			return false; //ERROR: wrong type
-		}
-	}
-	else if (keyLength == 10 && strncmp("raw_offset", key, 10) == 0) {
-		if (res.foundFlags.raw_offset_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.raw_offset_found = true;
-		if (parsedVal.Type >= SimpleJSONTextParser::Number::NT_Int8 && parsedVal.Type <= SimpleJSONTextParser::Number::NT_Uint16) {
-			//Valid number found
-			res.tz = TimeZone::fromTotalMinutesOffset(parsedVal.Value.Int16/60);
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-			return false; //ERROR: wrong type
-		}
-	}
-	else if (keyLength == 8 && strncmp("timezone", key, 8) == 0) {
-		if (res.foundFlags.timezone_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-		}
-		res.foundFlags.timezone_found = true;
-		return false; //ERROR
-	}
-	else if (keyLength == 12 && strncmp("utc_datetime", key, 12) == 0) {
-		if (res.foundFlags.unixtime_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-		}
-		res.foundFlags.unixtime_found = true;
-		return false; //ERROR
-	}
-	else if (keyLength == 5 && strncmp("error", key, 5) == 0) {
-		//WorldTimeAPI sent error
-		res.foundFlags.error_found = true;
-		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
-		}
-		return false; //ERROR
-	}
-	return true;
-}
-
-bool WorldTimeAPI::jsonTextTZ(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr) {
-	if (depth != 1) return true; //We need only depth 1 here
-
-	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
-	if (keyLength == 12 && strncmp("abbreviation", key, 12) == 0) {
-		if (res.foundFlags.abbreviation_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.abbreviation_found = true;
-		SimpleJSONTextParser::unescapeAndCopy(res.result_ptr->abbreviation, sizeof(WorldTimeAPIResult::abbreviation) / sizeof(char), value, valueLength);
-	}
-	else if (keyLength == 9 && strncmp("client_ip", key, 9) == 0) {
-		if (res.foundFlags.client_ip_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.client_ip_found = true;
-#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
-		char client_ip[WTAPI_TZ_CLIENT_IP_SIZE];
-		SimpleJSONTextParser::unescapeAndCopy(client_ip, WTAPI_TZ_CLIENT_IP_SIZE, value, valueLength); //Copy and unescape IP
-		//Parse IP
-		//Serial.println(client_ip);
-		if (!res.result_ptr->client_ip.fromString(client_ip)) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
-			return false; //ERROR parsing failed
-		}
-#else
-		SimpleJSONTextParser::unescapeAndCopy(res.result_ptr->client_ip, sizeof(WorldTimeAPIResult::client_ip) / sizeof(char), value, valueLength);
-#endif // (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
-	}
-	else if (keyLength == 3 && strncmp("dst", key, 3) == 0) {
-		if (res.foundFlags.dst_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-		}
-		res.foundFlags.dst_found = true;
-		return false; //ERROR
-	}
-	else if (keyLength == 8 && strncmp("dst_from", key, 8) == 0) {
-		if (res.foundFlags.dst_from_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.dst_from_found = true;
-		DateTime tmp;
-		if (res.dst_from.parse(value, valueLength, "y-M-dTHH:mm:sszzz", true) <= 0) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
-			return false; //Parsing error
-		}
-	}
-	else if (keyLength == 10 && strncmp("dst_offset", key, 10) == 0) {
-		if (res.foundFlags.dst_offset_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-		}
-		res.foundFlags.dst_offset_found = true;
-		return false; //ERROR
-	}
-	else if (keyLength == 9 && strncmp("dst_until", key, 9) == 0) {
-		if (res.foundFlags.dst_until_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.dst_until_found = true;
-		if (res.dst_until.parse(value, valueLength, "y-M-dTHH:mm:sszzz", true) <= 0) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
-			return false; //Parsing error
-		}
-	}
-	else if (keyLength == 10 && strncmp("raw_offset", key, 10) == 0) {
-		if (res.foundFlags.raw_offset_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-		}
-		else {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
-		}
-		res.foundFlags.raw_offset_found = true;
-		return false; //ERROR
-	}
-	else if (keyLength == 8 && strncmp("timezone", key, 8) == 0) {
-		if (res.foundFlags.timezone_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.timezone_found = true;
-		SimpleJSONTextParser::unescapeAndCopy(res.result_ptr->timezone, sizeof(WorldTimeAPIResult::timezone) / sizeof(char), value, valueLength);
-	}
-	else if (keyLength == 12 && strncmp("utc_datetime", key, 12) == 0) {
-		if (res.foundFlags.unixtime_found) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
-			return false; //Same key found
-		}
-		res.foundFlags.unixtime_found = true;
-		if (res.unixtime.parse(value, valueLength, "y-M-dTHH:mm:ss.FFFFFFzzz", true) <= 0) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
-			return false; //Parsing error
-		}
-	}
-	else if (keyLength == 5 && strncmp("error", key, 5) == 0) {
-		//WorldTimeAPI sent error
-		res.foundFlags.error_found = true;
-		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE || res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
-		}
-#ifdef ARDUINO
-#ifdef ESP8266
-		res.result_ptr->error = (String)StringE2(value, valueLength);
-#else
-		res.result_ptr->error = String(value, valueLength);
-#endif //ESP8266
-#else
-		res.result_ptr->error = std::string(value, valueLength);
-#endif // ARDUINO
-		return false; //ERROR found
-	}
-	return true;
-}
-
-bool WorldTimeAPI::jsonControlTZ(JSONItemType type, const char* key, int keyLength, int depth, int index, void* owner_ptr) {
-	bool isArrJSON = (type == JSONItemType::JIT_ArrayBegin && depth == 0);
-	if (isArrJSON) {
-		WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
-		res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_PARTIAL_TIMEZONE;
-	}
-
-	return !isArrJSON; //Returns true when JSON is object, false when JSON is array
-}
-
-bool WorldTimeAPI::jsonItemERR(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr) {
-	if (depth != 1) return true; //We need only depth 1 here
-
-	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
-	if (keyLength == 5 && strncmp("error", key, 5) == 0) {
-		//WorldTimeAPI sent error
-		res.foundFlags.error_found = true;
-		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
-		}
-		return false; //ERROR found
-	}
-	return true;
-}
-
-bool WorldTimeAPI::jsonTextERR(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr) {
-	if (depth != 1) return true; //We need only depth 1 here
-
-	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
-	if (keyLength == 5 && strncmp("error", key, 5) == 0) {
-		//WorldTimeAPI sent error
-		res.foundFlags.error_found = true;
-		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE || res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
-			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
-		}
-#ifdef ARDUINO
-#ifdef ESP8266
-		res.result_ptr->error = (String)StringE2(value, valueLength);
-#else
-		res.result_ptr->error = String(value, valueLength);
-#endif //ESP8266
-#else
-		res.result_ptr->error = std::string(value, valueLength);
-#endif // ARDUINO
-		return false; //ERROR found
-	}
-	return true;
-}
-
-
-
-const char* WorldTimeAPI::URL_TimeZone = "http://worldtimeapi.org/api/timezone";
-const char* WorldTimeAPI::URL_IP = "http://worldtimeapi.org/api/ip";
-
-
-#if defined(SJSONP_UNDER_OS)
-WorldTimeAPI_HttpCode WorldTimeAPI::requestGET(const char* url, std::string& resp) {
-	std::string cmd = "curl -is \"";
-	cmd += url;
-	cmd += '"';
-
-	resp = ssystem(cmd.c_str());
-	int httpCode = 0;
-
-	if (resp.length() > 5 && strncmp("curl:", resp.c_str(), 5) == 0) {
-		//CURL error
-		resp = "";
-		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
-	}
-	else if (resp.length() > 4 && strncmp("HTTP", resp.c_str(), 4) == 0) {
-		//HTTP header found
-		size_t respLen = resp.length();
-		size_t p1 = resp.find(' ');
-		if (p1 != std::string::npos) {
-			//Parsing http code
-			++p1;
-			for (; p1 < respLen && resp[p1] >= '0' && resp[p1] <= '9'; p1++) {
-				httpCode *= 10;
-				httpCode += resp[p1] - '0';
-			}
-			p1 = resp.find("\r\n\r\n", p1);
-			if (p1 != std::string::npos) {
-				resp = resp.substr(p1 + 4);
-				return (WorldTimeAPI_HttpCode)httpCode;
-			}
-		}
-	}
-	
-	//ERROR
-	resp = "";
-	return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
-}
-#elif defined(ARDUINO)
-WorldTimeAPI_HttpCode WorldTimeAPI::requestGET(const char* url, String& resp) {
-	resp = "";
-	WiFiClient client;
-	HTTPClient http;
-	http.setTimeout(1000);
-
-	if (http.begin(client, url)) {
-		int httpCode = http.GET();
-
-		// httpCode will be negative on error
-		if (httpCode > 0) {
-			resp = http.getString();
-		}
-		return (WorldTimeAPI_HttpCode)httpCode;
-	}
-	else {
-		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
-	}
-}
-#endif // !SJSONP_UNDER_OS
-
-
-#if defined(SJSONP_UNDER_OS)
-/**
-* @brief Calls command (CMD) and retrieves it's result.
-* @param command Command to call.
-* @return Returns response to command.
-*/
-std::string WorldTimeAPI::ssystem(const char* command) {
-	char tmpname[L_tmpnam];
-	tmpnam_s(tmpname, L_tmpnam);
-	std::string scommand = command;
-	std::string cmd = scommand + " > \"" + tmpname + "\" 2>&1";
-	std::system(cmd.c_str());
-	std::ifstream file(tmpname, std::ios::in | std::ios::binary);
-	std::stringstream buffer;
-	if (file) {
-		buffer << file.rdbuf();
-	}
-	remove(tmpname);
-	return buffer.str();
-}
-#endif // !SJSONP_UNDER_OS
+#include "WorldTimeAPI.h"
+#include "WorldTimeAPITransport.h"
+
+#ifdef WTAPI_COUNT_ALLOCATIONS
+#include <new>
+#include <stdlib.h>
+#endif // WTAPI_COUNT_ALLOCATIONS
+
+
+WorldTimeAPI::WorldTimeAPI(WorldTimeAPITransport* transport_) {
+	setTransport(transport_);
+#ifdef WTAPI_THREAD_SAFE
+	idleResponses.reserve(WTAPI_MAX_IDLE_RESPONSES); //Returning buffer does not allocate
+#endif // WTAPI_THREAD_SAFE
+}
+
+WorldTimeAPI::~WorldTimeAPI() {
+#ifdef WTAPI_BACKGROUND_REFRESH
+	{
+		std::unique_lock<std::mutex> lock(cacheMutex);
+		refreshDone.wait(lock, [this] { return refreshCount == 0; });
+	}
+#endif // WTAPI_BACKGROUND_REFRESH
+#ifdef WTAPI_HEDGING
+	waitForHedges(); //Losing requests still use transport and DNS cache
+#endif // WTAPI_HEDGING
+#ifdef WTAPI_THREAD_SAFE
+	for (WorldTimeAPIResponse* idle : idleResponses) {
+		delete idle;
+	}
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+	delete response;
+#endif // WTAPI_THREAD_SAFE
+}
+
+void WorldTimeAPI::setTransport(WorldTimeAPITransport* transport_) {
+#ifdef WTAPI_HEDGING
+	waitForHedges();
+#endif // WTAPI_HEDGING
+	if (transport_ != NULL) {
+		transport = transport_;
+		return;
+	}
+#if defined(SJSONP_UNDER_OS)
+	transport = &WorldTimeAPICurlTransport::global();
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+	transport = &WorldTimeAPIHTTPClientTransport::global();
+#else
+	transport = NULL;
+#endif // SJSONP_UNDER_OS
+}
+
+void WorldTimeAPIResult::clear() {
+	timezoneId = 0;
+	errorId = 0;
+	abbreviation[0] = 0;
+	clientIP = 0;
+	datetime = DateTimeTZSysSync::Zero;
+	httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	wasDST = false;
+	stale = false;
+	rawOffset = 0;
+	dstOffset = 0;
+	dstFrom = 0;
+	dstUntil = 0;
+}
+
+int WorldTimeAPIResult::clientIPToString(char* buffer, int bufferSize) const {
+	if (bufferSize <= 0) return 0;
+	if (clientIP == 0) {
+		buffer[0] = 0;
+		return 0;
+	}
+	int len = snprintf(buffer, bufferSize, "%u.%u.%u.%u", (unsigned)(clientIP >> 24), (unsigned)((clientIP >> 16) & 0xFF),
+		(unsigned)((clientIP >> 8) & 0xFF), (unsigned)(clientIP & 0xFF));
+	return len < bufferSize ? len : bufferSize - 1;
+}
+
+
+
+TimeZoneInfo WorldTimeAPIResult::toTimeZoneInfo() const {
+	TimeZoneInfo ret;
+	ret.keyName = timezone();
+	ret.timeZone = datetime.getTimeZone();
+	ret.DST = datetime.getDST();
+	if (wasDST) {
+#if _MSC_VER && !__INTEL_COMPILER
+		//Specific code for MVSC
+		strncpy_s(ret.daylightABR, abbreviation, (sizeof(ret.daylightABR) / sizeof(char)) - 1);
+
+#else
+		strncpy(ret.daylightABR, abbreviation, (sizeof(ret.daylightABR) / sizeof(char)) - 1);
+#endif
+		ret.daylightABR[(sizeof(ret.daylightABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
+
+		//Trying to guess standard abbreviation
+		//CET -> CESR
+		//NZST -> NZDT
+		bool DS_found = false;
+		int len = (int)strnlen(abbreviation, (sizeof(ret.standardABR) / sizeof(char)) - 1);
+		bool isD = false;
+		ret.standardABR[len] = 0; //Null termination
+		--len;
+		if (len >= 2 && abbreviation[len] == 'T' && (isD = abbreviation[len - 1] == 'D' || abbreviation[len - 1] == 'S')) {
+			if (isD) {
+				//For example HDT found and will be set to HST
+				ret.standardABR[len] = abbreviation[len];
+				--len;
+				ret.standardABR[len] = 'S';
+				--len;
+			}
+			else {
+				//For example CEST found and will be set to CET
+				ret.standardABR[len] = abbreviation[len];
+				len -= 2;
+			}
+			for (int cnt = 0; len >= 0; len--, cnt++) {
+				//Just copy
+				ret.standardABR[len] = abbreviation[len];
+			}
+		}
+		else {
+			//Special
+			//GMT -> BST
+			//IST -> GMT
+			if (strncmp(abbreviation, "GMT", 4) == 0) {
+#if _MSC_VER && !__INTEL_COMPILER
+				//Specific code for MVSC
+				strncpy_s(ret.standardABR, "IST", (sizeof(ret.standardABR) / sizeof(char)) - 1);
+#else
+				strncpy(ret.standardABR, "IST", (sizeof(ret.standardABR) / sizeof(char)) - 1);
+#endif
+				ret.standardABR[(sizeof(ret.standardABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
+			}
+			else if (strncmp(abbreviation, "BST", 4) == 0) {
+#if _MSC_VER && !__INTEL_COMPILER
+				//Specific code for MVSC
+				strncpy_s(ret.standardABR, "GMT", (sizeof(ret.standardABR) / sizeof(char)) - 1);
+#else
+				strncpy(ret.standardABR, "GMT", (sizeof(ret.standardABR) / sizeof(char)) - 1);
+#endif
+				ret.standardABR[(sizeof(ret.standardABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
+			}
+			else {
+#if _MSC_VER && !__INTEL_COMPILER
+				//Specific code for MVSC
+				strncpy_s(ret.standardABR, abbreviation, (sizeof(ret.standardABR) / sizeof(char)) - 1);
+#else
+				strncpy(ret.standardABR, abbreviation, (sizeof(ret.standardABR) / sizeof(char)) - 1);
+#endif
+				ret.standardABR[(sizeof(ret.standardABR) / sizeof(char)) - 1] = 0; //Just be sure it is null terminated
+			}
+		}
+	}
+	//else {
+		//Cannot guess, because we don't know if DST is used from WorldTimeAPI now
+	//}
+
+	//TODO fill missing fields
+
+	return ret;
+}
+
+#ifdef ARDUINO
+WorldTimeAPI_HttpCode WorldTimeAPI::getListOfTimeZones(String& list, const char* tz) {
+#else
+WorldTimeAPI_HttpCode WorldTimeAPI::getListOfTimeZones(std::string& list, const char* tz) {
+#endif // !ARDUINO
+	char url[WTAPI_URL_SIZE];
+	int len = snprintf(url, sizeof(url), "%s%s%s.txt", URL_TimeZone, tz != NULL ? "/" : "", tz != NULL ? tz : "");
+	if (len < 0 || len >= (int)sizeof(url)) {
+		return WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+	}
+
+	WorldTimeAPIResponse* response = acquireResponse();
+	int httpCode = throttledGET(url, *response, WorldTimeAPIClock::now() + timeout);
+	WorldTimeAPIStringView body = response->getBody();
+#ifdef ARDUINO
+	list = "";
+	list.concat(body.data, body.length);
+#else
+	list.assign(body.data, body.length);
+#endif // ARDUINO
+	releaseResponse(response);
+	if (list.length() > 6 && strncmp("abbrev", list.c_str(), 6) == 0 && tz != NULL) {
+		//Time zone info was get, so return only one time zone name
+		list = tz;
+	}
+	return (WorldTimeAPI_HttpCode)httpCode;
+} 
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+/**
+* @brief State of streamed list of time zones. Names are split to lines and filtered by prefix
+* while they are received.
+*/
+struct WorldTimeAPIListHelper {
+	WorldTimeAPI_TimeZoneCallback callback;
+	void* owner;
+	const char* prefix;
+	size_t prefixLength;
+	char line[WTAPI_LIST_LINE_SIZE];
+	size_t lineLength;
+	bool skip;    //Rest of line does not match prefix or it is too long
+	bool stopped;
+
+	/**
+	* @brief Passes finished line to callback.
+	*/
+	inline void endLine() {
+		if (!skip && lineLength > 0 && lineLength >= prefixLength) {
+			line[lineLength] = 0;
+			if (!callback(line, lineLength, owner)) {
+				stopped = true;
+			}
+		}
+		lineLength = 0;
+		skip = false;
+	}
+
+	static bool onChunk(const char* data, size_t length, void* owner_ptr) {
+		WorldTimeAPIListHelper* helper = (WorldTimeAPIListHelper*)owner_ptr;
+		for (size_t i = 0; i < length && !helper->stopped; i++) {
+			char c = data[i];
+			if (c == '\n') {
+				helper->endLine();
+			}
+			else if (c == '\r' || helper->skip) {
+				continue;
+			}
+			else if (helper->lineLength < helper->prefixLength && c != helper->prefix[helper->lineLength]) {
+				helper->skip = true; //Prefix does not match
+			}
+			else if (helper->lineLength >= WTAPI_LIST_LINE_SIZE - 1) {
+				helper->skip = true; //Line is too long to be time zone name
+			}
+			else {
+				helper->line[helper->lineLength++] = c;
+			}
+		}
+		return !helper->stopped;
+	}
+};
+
+WorldTimeAPI_HttpCode WorldTimeAPI::getListOfTimeZones(WorldTimeAPI_TimeZoneCallback onTimeZoneName, void* owner, const char* prefix) {
+	if (onTimeZoneName == NULL) {
+		return WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+	}
+	WorldTimeAPIListHelper helper;
+	helper.callback = onTimeZoneName;
+	helper.owner = owner;
+	helper.prefix = prefix != NULL ? prefix : "";
+	helper.prefixLength = strlen(helper.prefix);
+	helper.lineLength = 0;
+	helper.skip = false;
+	helper.stopped = false;
+
+	//Only area of prefix is requested, for example "Europe" for "Europe/B"
+	char url[WTAPI_DNS_HOST_SIZE + WTAPI_LIST_LINE_SIZE + 32];
+	const char* slash = strchr(helper.prefix, '/');
+	int areaLength = slash != NULL ? (int)(slash - helper.prefix) : 0;
+	if (areaLength > 0 && areaLength < WTAPI_LIST_LINE_SIZE) {
+		snprintf(url, sizeof(url), "%s/%.*s.txt", URL_TimeZone, areaLength, helper.prefix);
+	}
+	else {
+		snprintf(url, sizeof(url), "%s.txt", URL_TimeZone);
+	}
+
+	WorldTimeAPI_HttpCode httpCode = throttledStream(url, WorldTimeAPIListHelper::onChunk, &helper, WorldTimeAPIClock::now() + timeout);
+	if (httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK && !helper.stopped) {
+		helper.endLine(); //Last line may not end with new line
+	}
+	return httpCode;
+}
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+const WorldTimeAPIResult& WorldTimeAPI::getByTimeZone(const char* tz) {
+#ifdef WTAPI_THREAD_SAFE
+	WorldTimeAPIResult res;
+	getByTimeZone(tz, res);
+	return publishLastResult(res);
+#else
+	getByTimeZone(tz, lastRes);
+	return lastRes;
+#endif // WTAPI_THREAD_SAFE
+}
+
+#ifdef WTAPI_TZ_TABLE
+const WorldTimeAPIResult& WorldTimeAPI::getByTimeZone(WorldTimeAPI_TzId tz) {
+#ifdef WTAPI_THREAD_SAFE
+	WorldTimeAPIResult res;
+	getByTimeZone(tz, res);
+	return publishLastResult(res);
+#else
+	getByTimeZone(tz, lastRes);
+	return lastRes;
+#endif // WTAPI_THREAD_SAFE
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPI::getByTimeZone(WorldTimeAPI_TzId tz, WorldTimeAPIResult& result, uint32_t timeout) {
+	if (!WorldTimeAPIZones::isValid(tz)) {
+		//Unknown ID, request is not sent
+		result.clear();
+		result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+		return result.httpCode;
+	}
+	return getByTimeZone(WorldTimeAPIZones::name(tz), result, timeout);
+}
+#endif // WTAPI_TZ_TABLE
+
+WorldTimeAPI_HttpCode WorldTimeAPI::getByTimeZone(const char* tz, WorldTimeAPIResult& result, uint32_t timeout) {
+	if (tz == NULL) {
+		//tz cannot be NULL
+		result.clear();
+		result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+		return result.httpCode;
+	}
+	char url[WTAPI_URL_SIZE];
+	int len = snprintf(url, sizeof(url), "%s/%s%s", URL_TimeZone, tz, format == WorldTimeAPI_Format::WTA_FORMAT_TEXT ? ".txt" : "");
+	if (len < 0 || len >= (int)sizeof(url)) {
+		//Name is too long
+		result.clear();
+		result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+		return result.httpCode;
+	}
+
+#ifdef WTAPI_TZIF
+	if (tzSource != WorldTimeAPI_TZSource::WTA_TZ_SOURCE_NETWORK && resolveLocalTZ(tz, result)) {
+		if (tzSource == WorldTimeAPI_TZSource::WTA_TZ_SOURCE_CROSS_CHECK) {
+			WorldTimeAPIResult remote;
+			if (fetchTZ(url, remote, timeout) == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK && !sameTZ(result, remote)) {
+				//Local tzdata is outdated
+				result = remote;
+			}
+		}
+		return result.httpCode;
+	}
+#endif // WTAPI_TZIF
+
+	return fetchTZ(url, result, timeout);
+}
+
+const WorldTimeAPIResult& WorldTimeAPI::getByIP(const char* IP) {
+#ifdef WTAPI_THREAD_SAFE
+	WorldTimeAPIResult res;
+	getByIP(IP, res);
+	return publishLastResult(res);
+#else
+	getByIP(IP, lastRes);
+	return lastRes;
+#endif // WTAPI_THREAD_SAFE
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPI::getByIP(const char* IP, WorldTimeAPIResult& result, uint32_t timeout) {
+	char url[WTAPI_URL_SIZE];
+	int len = snprintf(url, sizeof(url), "%s%s%s%s", URL_IP, IP != NULL ? "/" : "", IP != NULL ? IP : "",
+		format == WorldTimeAPI_Format::WTA_FORMAT_TEXT ? ".txt" : "");
+	if (len < 0 || len >= (int)sizeof(url)) {
+		result.clear();
+		result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+		return result.httpCode;
+	}
+
+#ifdef WTAPI_IP_CACHE
+	uint32_t address = 0;
+	if (ipCache != NULL && IP != NULL && parseIPv4(IP, address)) {
+		WorldTimeAPIIPCache::Entry entry;
+		if (ipCache->lookup(address, entry) && resolveIPCache(entry, address, result)) {
+			return result.httpCode;
+		}
+		if (fetchTZ(url, result, timeout) == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
+			toIPCacheEntry(result, entry);
+			ipCache->learn(address, entry);
+		}
+		return result.httpCode;
+	}
+#endif // WTAPI_IP_CACHE
+
+	return fetchTZ(url, result, timeout);
+}
+
+#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+const WorldTimeAPIResult& WorldTimeAPI::getByIP(const IPAddress& IP) {
+#ifdef WTAPI_THREAD_SAFE
+	WorldTimeAPIResult res;
+	getByIP(IP, res);
+	return publishLastResult(res);
+#else
+	getByIP(IP, lastRes);
+	return lastRes;
+#endif // WTAPI_THREAD_SAFE
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPI::getByIP(const IPAddress& IP, WorldTimeAPIResult& result, uint32_t timeout) {
+#ifdef  ESP8266
+	if (!(IP.isV4() && IP.isSet())) {
+		//Unset IP or IPV6
+		result.clear();
+		result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+		return result.httpCode;
+	}
+#endif //  ESP8266
+
+	char ip[WTAPI_TZ_CLIENT_IP_SIZE];
+	snprintf(ip, sizeof(ip), "%u.%u.%u.%u", (unsigned)IP[0], (unsigned)IP[1], (unsigned)IP[2], (unsigned)IP[3]);
+	return getByIP(ip, result, timeout);
+}
+#endif // !SJSONP_UNDER_OS
+
+
+WorldTimeAPI_HttpCode WorldTimeAPI::getByURL(const char* url, WorldTimeAPIResult& result, uint32_t timeout) {
+	if (url == NULL) {
+		result.clear();
+		result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+		return result.httpCode;
+	}
+	return fetchTZ(url, result, timeout);
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPI::fetchTZ(const char* url, WorldTimeAPIResult& result, uint32_t timeout) {
+#ifdef WTAPI_THREAD_SAFE
+	if (cacheMaxAge > 0) {
+		bool refresh = false;
+		{
+			std::lock_guard<std::mutex> lock(cacheMutex);
+			auto it = cache.find(url);
+			if (it != cache.end()) {
+				CacheEntry& entry = it->second;
+				uint32_t age = WorldTimeAPIClock::elapsed(entry.fetchedAt);
+				if (age < cacheMaxAge) {
+					result = entry.result;
+					return result.httpCode; //Fresh
+				}
+				if (age - cacheMaxAge < cacheMaxStale) {
+					result = entry.result;
+					result.stale = true;
+					if (entry.refreshing) {
+						return result.httpCode; //Refresh is already running
+					}
+					entry.refreshing = true;
+					refresh = true;
+				}
+			}
+		}
+
+		if (refresh) {
+#ifdef WTAPI_BACKGROUND_REFRESH
+			startRefresh(url);
+#else
+			//This caller refreshes result, other callers get stale result meanwhile
+			WorldTimeAPIResult fresh;
+			refreshTZ(url, fresh);
+			if (!fresh.hasError()) {
+				result = fresh;
+			}
+#endif // WTAPI_BACKGROUND_REFRESH
+			return result.httpCode;
+		}
+
+		//Not cached or too old
+		fetchShared(url, result, timeout);
+		if (!result.hasError()) {
+			storeTZ(url, result);
+		}
+		return result.httpCode;
+	}
+#endif // WTAPI_THREAD_SAFE
+	return fetchShared(url, result, timeout);
+}
+
+#ifdef WTAPI_THREAD_SAFE
+const WorldTimeAPIResult& WorldTimeAPI::publishLastResult(const WorldTimeAPIResult& result) {
+	std::lock_guard<std::mutex> lock(lastResMutex);
+
+	//Waiting until readers of hidden buffer finish (they read it before previous swap)
+	uint8_t next = 1 - lastResIndex.load();
+	while (lastResReaders[next].load() != 0) {
+		WorldTimeAPIClock::relax();
+	}
+	lastResBuffers[next] = result;
+	lastResIndex.store(next);
+	return lastResBuffers[next];
+}
+
+void WorldTimeAPI::getLastResult(WorldTimeAPIResult& result) const {
+	while (true) {
+		uint8_t index = lastResIndex.load();
+		lastResReaders[index]++;
+		if (lastResIndex.load() == index) {
+			//Buffer is still published, so writer will not rewrite it until reader finishes
+			result = lastResBuffers[index];
+			lastResReaders[index]--;
+			return;
+		}
+		//Buffers were swapped meanwhile
+		lastResReaders[index]--;
+	}
+}
+
+WorldTimeAPIResult WorldTimeAPI::getLastResult() const {
+	WorldTimeAPIResult result;
+	getLastResult(result);
+	return result;
+}
+
+void WorldTimeAPI::setCache(uint32_t maxAge, uint32_t maxStale) {
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	cacheMaxAge = maxAge;
+	cacheMaxStale = maxStale;
+	if (maxAge == 0) {
+		cache.clear();
+	}
+}
+
+void WorldTimeAPI::clearCache() {
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	cache.clear();
+}
+
+void WorldTimeAPI::storeTZ(const char* url, const WorldTimeAPIResult& result) {
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	auto it = cache.find(url);
+	if (it == cache.end()) {
+		if (cache.size() >= WTAPI_CACHE_MAX_ENTRIES) {
+			//Removing oldest entry, which is not being refreshed
+			auto oldest = cache.end();
+			uint32_t oldestAge = 0;
+			for (auto e = cache.begin(); e != cache.end(); ++e) {
+				uint32_t age = WorldTimeAPIClock::elapsed(e->second.fetchedAt);
+				if (!e->second.refreshing && (oldest == cache.end() || age > oldestAge)) {
+					oldest = e;
+					oldestAge = age;
+				}
+			}
+			if (oldest == cache.end()) return;
+			cache.erase(oldest);
+		}
+		it = cache.emplace(url, CacheEntry()).first;
+	}
+	it->second.result = result;
+	it->second.result.stale = false;
+	it->second.fetchedAt = WorldTimeAPIClock::now();
+	it->second.refreshing = false;
+}
+
+void WorldTimeAPI::refreshTZ(const char* url, WorldTimeAPIResult& fresh) {
+	fetchShared(url, fresh, 0);
+	if (!fresh.hasError()) {
+		storeTZ(url, fresh);
+		return;
+	}
+	//Refresh failed, stale result is kept
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	auto it = cache.find(url);
+	if (it != cache.end()) {
+		it->second.refreshing = false;
+	}
+}
+#endif // WTAPI_THREAD_SAFE
+
+#ifdef WTAPI_BACKGROUND_REFRESH
+void WorldTimeAPI::startRefresh(const char* url) {
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		refreshCount++;
+	}
+	std::string urlStr = url; //URL of caller does not exist after return
+	std::thread([this, urlStr]() {
+		WorldTimeAPIResult fresh;
+		refreshTZ(urlStr.c_str(), fresh);
+
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		refreshCount--;
+		refreshDone.notify_all();
+	}).detach();
+}
+#endif // WTAPI_BACKGROUND_REFRESH
+
+WorldTimeAPI_HttpCode WorldTimeAPI::fetchShared(const char* url, WorldTimeAPIResult& result, uint32_t timeout) {
+	if (timeout == 0) {
+		timeout = this->timeout;
+	}
+	uint32_t deadline = WorldTimeAPIClock::now() + timeout;
+#ifdef WTAPI_THREAD_SAFE
+	Flight* flight = NULL;
+	{
+		std::unique_lock<std::mutex> lock(flightsMutex);
+		Flight* freeSlot = NULL;
+		for (uint8_t i = 0; i < WTAPI_MAX_FLIGHTS; i++) {
+			if (flights[i].users == 0) {
+				if (freeSlot == NULL) freeSlot = &flights[i];
+			}
+			else if (!flights[i].done && strcmp(flights[i].url, url) == 0) {
+				flight = &flights[i];
+				break;
+			}
+		}
+
+		if (flight != NULL) {
+			//Same request is in progress, waiting for its result
+			flight->users++;
+			bool finished = flight->cv.wait_for(lock, std::chrono::milliseconds(timeout), [flight] { return flight->done; });
+			if (finished) {
+				result = flight->result;
+			}
+			else {
+				//Deadline of this caller passed before the request finished
+				result.clear();
+				result.httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+			}
+			flight->users--;
+			return result.httpCode;
+		}
+
+		if (freeSlot != NULL && strlen(url) < sizeof(freeSlot->url)) {
+			//No request for this URL in progress, this caller will send it
+			flight = freeSlot;
+			strcpy(flight->url, url);
+			flight->done = false;
+			flight->users = 1;
+		}
+	}
+
+	if (flight == NULL) {
+		//All slots are used (or URL is too long), so request is not shared
+		getAndParseTZ(url, result, deadline);
+		return result.httpCode;
+	}
+
+	getAndParseTZ(url, flight->result, deadline);
+	{
+		std::lock_guard<std::mutex> lock(flightsMutex);
+		flight->done = true;
+		result = flight->result;
+		flight->users--;
+		flight->cv.notify_all();
+	}
+#else
+	getAndParseTZ(url, result, deadline);
+#endif // WTAPI_THREAD_SAFE
+	return result.httpCode;
+}
+
+void WorldTimeAPI::getAndParseTZ(const char* url, WorldTimeAPIResult& result, uint32_t deadline) {
+	WorldTimeAPIResponse* response = acquireResponse();
+	WorldTimeAPI_HttpCode httpCode = throttledGET(url, *response, deadline);
+
+	//Format of response is given by extension in URL
+	size_t urlLength = strlen(url);
+	WorldTimeAPI_Format format = (urlLength > 4 && strcmp(url + urlLength - 4, ".txt") == 0) ? WorldTimeAPI_Format::WTA_FORMAT_TEXT : WorldTimeAPI_Format::WTA_FORMAT_JSON;
+
+	//Body is parsed in receive buffer, it is not copied
+	WorldTimeAPIStringView body = response->getBody();
+	parseResponse(body.data, (int)body.length, format, result, httpCode, transport != NULL && transport->isTrusted());
+	releaseResponse(response);
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPI::parseResponse(const char* body, int bodyLength, WorldTimeAPI_Format format, WorldTimeAPIResult& result, WorldTimeAPI_HttpCode httpCode, bool trusted) {
+	result.clear();
+	result.httpCode = httpCode;
+
+	if (result.httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
+		//GET request successfull
+		WorldTimeAPIResHelper resHelper(&result);
+		int parseRes;
+		if (format == WorldTimeAPI_Format::WTA_FORMAT_TEXT) {
+//abbreviation: CEST\nclient_ip: 185.142.49.50\ndatetime: 2022-06-16T13:57:27.659132+02:00\nday_of_week: 4\nday_of_year: 167\ndst: true\ndst_from: 2022-03-27T01:00:00+00:00\ndst_offset: 3600\n ...
+			parseRes = parseText(body, bodyLength, resHelper, false);
+		}
+		else {
+			SimpleJSONTextParser parser;
+			parser.onItemFound = jsonItemTZ;
+			parser.onTextItemFound = jsonTextTZ;
+			parser.onObjArrFound = jsonControlTZ;
+//{"abbreviation":"CEST","client_ip":"185.142.49.50","datetime":"2022-06-16T13:57:27.659132+02:00","day_of_week":4,"day_of_year":167,"dst":true,"dst_from":"2022-03-27T01:00:00+00:00","dst_offset":3600,"dst_until":"2022-10-30T01:00:00+00:00","raw_offset":3600,"timezone":"Europe/Bratislava","unixtime":1655380647,"utc_datetime":"2022-06-16T11:57:27.659132+00:00","utc_offset":"+02:00","week_number":24}
+			parseRes = trusted ? parser.parseJSON<SimpleJSONTrusted>(body, bodyLength, &resHelper) : parser.parseJSON<SimpleJSONStrict>(body, bodyLength, &resHelper);
+		}
+		//Serial.println(parseRes);
+		if (!resHelper.foundFlags.allValidFound()) {
+			if (result.httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_MISSING;
+		}
+		else if (parseRes <= 0) {
+			if (result.httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_RESPONSE;
+		}
+		else {
+			//Parsing OK
+			finishTZ(resHelper, result);
+		}
+	}
+	else if(result.httpCode > WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE && bodyLength > 0) {
+		//Trying to parse error
+		WorldTimeAPIResHelper resHelper(&result);
+		if (format == WorldTimeAPI_Format::WTA_FORMAT_TEXT && body[0] != '{') {
+			parseText(body, bodyLength, resHelper, true);
+		}
+		else {
+			SimpleJSONTextParser parser;
+			parser.onItemFound = jsonItemERR;
+			parser.onTextItemFound = jsonTextERR;
+			parser.onObjArrFound = jsonControlTZ;
+			if (trusted) parser.parseJSON<SimpleJSONTrusted>(body, bodyLength, &resHelper);
+			else parser.parseJSON<SimpleJSONStrict>(body, bodyLength, &resHelper);
+		}
+	}
+	return result.httpCode;
+}
+
+void WorldTimeAPI::finishTZ(WorldTimeAPIResHelper& resHelper, WorldTimeAPIResult& result) {
+	DSTAdjustment adj;
+	result.wasDST = false;
+	result.rawOffset = resHelper.raw_offset;
+	if (!resHelper.dst_null) {
+		result.dstOffset = resHelper.dst_offset;
+		result.dstFrom = resHelper.dst_from;
+		result.dstUntil = resHelper.dst_until;
+
+		//DST starts at local standard time and ends at local DST time
+		DSTTransitionRule startRule = inferDSTRule(resHelper.dst_from + resHelper.raw_offset);
+		DSTTransitionRule endRule = inferDSTRule(resHelper.dst_until + resHelper.raw_offset + resHelper.dst_offset);
+
+		//Rules are recurring, so it does not matter, whether dates are from current, last or next DST period
+		//(API returns last DST period in winter and on south hemisphere DST period goes over new year)
+		result.wasDST = resHelper.dst;
+		adj = DSTAdjustment::fromTotalMinutesOffset(startRule, endRule, resHelper.dst_offset / 60, result.wasDST);
+	}
+
+	resHelper.unixtime += resHelper.tz.getTimeZoneOffset() + adj.getDSTOffset();
+	result.datetime = DateTimeTZSysSync(resHelper.unixtime, resHelper.tz, adj, result.wasDST);
+}
+
+DSTTransitionRule WorldTimeAPI::inferDSTRule(int64_t localTime) {
+	WorldTimeAPICalendar::Rule rule = WorldTimeAPICalendar::inferRule(localTime);
+	int8_t hour = (int8_t)(rule.time / 3600);
+	static const WeekOfMonth weeks[5] = { WeekOfMonth::First, WeekOfMonth::Second, WeekOfMonth::Third, WeekOfMonth::Fourth, WeekOfMonth::Last };
+	static const DayOfWeek weekdays[7] = { DayOfWeek::Sunday, DayOfWeek::Monday, DayOfWeek::Tuesday, DayOfWeek::Wednesday,
+		DayOfWeek::Thursday, DayOfWeek::Friday, DayOfWeek::Saturday };
+	return DSTTransitionRule(hour, (Months)rule.month, weeks[rule.week - 1], weekdays[rule.day]);
+}
+
+bool WorldTimeAPI::parseIPv4(const char* text, uint32_t& address) {
+	uint32_t ret = 0;
+	for (int i = 0; i < 4; i++) {
+		if (*text < '0' || *text > '9') return false;
+		uint32_t octet = 0;
+		int digits = 0;
+		for (; *text >= '0' && *text <= '9'; text++, digits++) {
+			octet = octet * 10 + (*text - '0');
+		}
+		if (digits > 3 || octet > 255) return false;
+		ret = (ret << 8) | octet;
+		if (i < 3 && *text++ != '.') return false;
+	}
+	if (*text != 0) return false;
+	address = ret;
+	return true;
+}
+
+#if defined(SJSONP_UNDER_OS)
+bool WorldTimeAPI::finishNow(WorldTimeAPIResHelper& resHelper, WorldTimeAPIResult& result) {
+	int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	int64_t unixTime = (micros >= 0) ? micros / 1000000 : (micros - 999999) / 1000000;
+
+	//Date is formatted the same way as in response, so it is parsed the same way
+	char buffer[40];
+	int len = WorldTimeAPICalendar::formatISO(buffer, sizeof(buffer), unixTime, (int32_t)(micros - unixTime * 1000000));
+	if (resHelper.unixtime.parse(buffer, len, "y-M-dTHH:mm:ss.FFFFFFzzz", true) <= 0) {
+		return false;
+	}
+
+	finishTZ(resHelper, result);
+	result.httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK;
+	return true;
+}
+#endif // SJSONP_UNDER_OS
+
+#ifdef WTAPI_IP_CACHE
+bool WorldTimeAPI::resolveIPCache(const WorldTimeAPIIPCache::Entry& entry, uint32_t ip, WorldTimeAPIResult& result) {
+	bool noDST = (entry.flags & WorldTimeAPIIPCache::FLAG_NO_DST) != 0;
+	bool dst = false;
+	if (!noDST) {
+		//DST period of entry may be from another year, so DST state is found from rules
+		int64_t now = (int64_t)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		int64_t local = now + entry.rawOffset;
+		WorldTimeAPICalendar::Rule start = WorldTimeAPICalendar::inferRule(entry.dstFrom + entry.rawOffset);
+		WorldTimeAPICalendar::Rule end = WorldTimeAPICalendar::inferRule(entry.dstUntil + entry.rawOffset + entry.dstOffset);
+		int32_t y;
+		uint8_t m, d;
+		WorldTimeAPICalendar::civilFromDays(WorldTimeAPICalendar::daysFromUnix(local), y, m, d);
+		int64_t from = WorldTimeAPICalendar::ruleTime(start, y);
+		int64_t until = WorldTimeAPICalendar::ruleTime(end, y) - entry.dstOffset;
+		dst = (from < until) ? (local >= from && local < until) : (local >= from || local < until);
+	}
+	if (dst != ((entry.flags & WorldTimeAPIIPCache::FLAG_DST) != 0)) {
+		return false;
+	}
+
+	result.clear();
+	WorldTimeAPIResHelper resHelper(&result);
+	result.timezoneId = entry.timezoneId;
+	result.clientIP = ip;
+	memcpy(result.abbreviation, entry.abbreviation, WTAPI_TZ_ABR_NAME_SIZE);
+	result.abbreviation[WTAPI_TZ_ABR_NAME_SIZE - 1] = 0;
+
+	resHelper.tz = TimeZone::fromTotalMinutesOffset(entry.rawOffset / 60);
+	resHelper.raw_offset = entry.rawOffset;
+	resHelper.dst = dst;
+	resHelper.dst_null = noDST;
+	resHelper.dst_offset = entry.dstOffset;
+	resHelper.dst_from = entry.dstFrom;
+	resHelper.dst_until = entry.dstUntil;
+	return finishNow(resHelper, result);
+}
+
+void WorldTimeAPI::toIPCacheEntry(const WorldTimeAPIResult& result, WorldTimeAPIIPCache::Entry& entry) {
+	memset(&entry, 0, sizeof(entry));
+	entry.rawOffset = result.rawOffset;
+	entry.dstOffset = result.dstOffset;
+	entry.timezoneId = result.timezoneId;
+	entry.dstFrom = result.dstFrom;
+	entry.dstUntil = result.dstUntil;
+	memcpy(entry.abbreviation, result.abbreviation, sizeof(entry.abbreviation));
+	if (result.wasDST) {
+		entry.flags |= WorldTimeAPIIPCache::FLAG_DST;
+	}
+	if (result.dstFrom == 0 && result.dstUntil == 0) {
+		entry.flags |= WorldTimeAPIIPCache::FLAG_NO_DST;
+	}
+}
+#endif // WTAPI_IP_CACHE
+
+#ifdef WTAPI_TZIF
+bool WorldTimeAPI::resolveLocalTZ(const char* tz, WorldTimeAPIResult& result) {
+	int64_t unixTime = (int64_t)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	WorldTimeAPITZif::ZoneState state;
+	if (!WorldTimeAPITZif::global().lookup(tz, unixTime, state)) {
+		return false;
+	}
+
+	result.clear();
+	WorldTimeAPIResHelper resHelper(&result);
+	result.timezoneId = WorldTimeAPIIntern::global().intern(tz);
+	if (result.timezoneId == 0) {
+		result.clear();
+		return false; //Name cannot be kept
+	}
+	strncpy(result.abbreviation, state.abbreviation, WTAPI_TZ_ABR_NAME_SIZE - 1);
+	result.abbreviation[WTAPI_TZ_ABR_NAME_SIZE - 1] = 0;
+
+	resHelper.tz = TimeZone::fromTotalMinutesOffset(state.stdOffset / 60);
+	resHelper.raw_offset = state.stdOffset;
+	resHelper.dst = state.isDST;
+	resHelper.dst_null = !state.hasDST;
+	resHelper.dst_offset = (int16_t)state.dstOffset;
+	resHelper.dst_from = state.dstFrom;
+	resHelper.dst_until = state.dstUntil;
+	return finishNow(resHelper, result);
+}
+
+bool WorldTimeAPI::sameTZ(const WorldTimeAPIResult& a, const WorldTimeAPIResult& b) {
+	return a.wasDST == b.wasDST && strcmp(a.abbreviation, b.abbreviation) == 0 &&
+		a.datetime.getTimeZone().getTimeZoneOffset() == b.datetime.getTimeZone().getTimeZoneOffset();
+}
+#endif // WTAPI_TZIF
+
+int WorldTimeAPI::parseText(const char* text, int textSize, WorldTimeAPIResHelper& res, bool errorOnly) {
+	int index = 0;
+	int i = 0;
+	while (i < textSize && text[i] != 0) {
+		//Scanning one line: "key: value"
+		int lineStart = i;
+		int colon = -1;
+		for (; i < textSize && text[i] != '\n' && text[i] != 0; i++) {
+			if (colon < 0 && text[i] == ':') colon = i;
+		}
+		int lineEnd = i;
+		if (lineEnd > lineStart && text[lineEnd - 1] == '\r') lineEnd--;
+		if (i < textSize && text[i] == '\n') i++;
+
+		if (lineEnd == lineStart) {
+			continue; //Empty line
+		}
+		if (colon < 0) {
+			if (index == 0 && !errorOnly) {
+				//List of time zones was returned instead of time zone info
+				res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_PARTIAL_TIMEZONE;
+			}
+			return -lineStart; //ERROR: line without key
+		}
+
+		const char* key = text + lineStart;
+		int keyLength = colon - lineStart;
+		int valueStart = colon + 1;
+		if (valueStart < lineEnd && text[valueStart] == ' ') valueStart++;
+		const char* value = text + valueStart;
+		int valueLength = lineEnd - valueStart;
+
+		bool cont;
+		if (errorOnly) {
+			cont = jsonTextERR(key, keyLength, value, valueLength, 1, index, &res);
+		}
+		else {
+			cont = textItemTZ(key, keyLength, value, valueLength, index, res);
+		}
+		if (!cont) {
+			return -lineStart; //ERROR: user error
+		}
+		index++;
+	}
+	return i;
+}
+
+bool WorldTimeAPI::textItemTZ(const char* key, int keyLength, const char* value, int valueLength, int index, WorldTimeAPIResHelper& res) {
+	//Text format has no types, so type of value is given by key
+	bool isItem = (keyLength == 3 && strncmp("dst", key, 3) == 0) ||
+		(keyLength == 10 && (strncmp("dst_offset", key, 10) == 0 || strncmp("raw_offset", key, 10) == 0));
+	bool isNullable = (keyLength == 8 && strncmp("dst_from", key, 8) == 0) ||
+		(keyLength == 9 && strncmp("dst_until", key, 9) == 0);
+
+	if (valueLength == 0 && (isItem || isNullable)) {
+		return jsonItemTZ(JSONItemType::JIT_Null, key, keyLength, SimpleJSONTextParser::Number::Null, 1, index, &res);
+	}
+	else if (isItem) {
+		if (valueLength == 4 && strncmp("true", value, 4) == 0) {
+			return jsonItemTZ(JSONItemType::JIT_Bool, key, keyLength, SimpleJSONTextParser::Number(true), 1, index, &res);
+		}
+		else if (valueLength == 5 && strncmp("false", value, 5) == 0) {
+			return jsonItemTZ(JSONItemType::JIT_Bool, key, keyLength, SimpleJSONTextParser::Number(false), 1, index, &res);
+		}
+		SimpleJSONTextParser::Number parsedVal;
+		if (parsedVal.parse(value, valueLength) != valueLength) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
+			return false; //ERROR: not a number
+		}
+		return jsonItemTZ(JSONItemType::JIT_Number, key, keyLength, parsedVal, 1, index, &res);
+	}
+	return jsonTextTZ(key, keyLength, value, valueLength, 1, index, &res);
+}
+
+bool WorldTimeAPI::jsonItemTZ(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr) {
+	if (depth != 1) return true; //We need only depth 1 here
+
+	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
+	if (keyLength == 12 && strncmp("abbreviation", key, 12) == 0) {
+		if (res.foundFlags.abbreviation_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+		}
+		res.foundFlags.abbreviation_found = true;
+		return false; //ERROR
+	}
+	else if (keyLength == 9 && strncmp("client_ip", key, 9) == 0) {
+		if (res.foundFlags.client_ip_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+		}
+		res.foundFlags.client_ip_found = true;
+		return false; //ERROR
+	}
+	else if (keyLength == 3 && strncmp("dst", key, 3) == 0) {
+		if (res.foundFlags.dst_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.dst_found = true;
+		if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Bool) {
+			res.dst = parsedVal.Value.Bool;
+		}
+		else if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Null) {
+			res.dst_null = true; //Null found
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+			return false; //ERROR: wrong type
+		}
+	}
+	else if (keyLength == 8 && strncmp("dst_from", key, 8) == 0) { //Can return null
+		if (res.foundFlags.dst_from_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.dst_from_found = true;
+		if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Null) {
+			res.dst_null = true; //Null found
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+			return false; //ERROR: wrong type
+		}
+	}
+	else if (keyLength == 10 && strncmp("dst_offset", key, 10) == 0) {
+		if (res.foundFlags.dst_offset_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.dst_offset_found = true;
+		if (parsedVal.Type >= SimpleJSONTextParser::Number::NT_Int8 && parsedVal.Type <= SimpleJSONTextParser::Number::NT_Uint16) {
+			//Valid number found
+			res.dst_offset = parsedVal.Value.Int16;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+			return false; //ERROR: wrong type
+		}
+	}
+	else if (keyLength == 9 && strncmp("dst_until", key, 9) == 0) { //Can return null
+		if (res.foundFlags.dst_until_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.dst_until_found = true;
+		if (parsedVal.Type == SimpleJSONTextParser::Number::NT_Null) {
+			res.dst_null = true; //Null found
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+			return false; //ERROR: wrong type
+		}
+	}
+	else if (keyLength == 10 && strncmp("raw_offset", key, 10) == 0) {
+		if (res.foundFlags.raw_offset_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.raw_offset_found = true;
+		if (parsedVal.Type >= SimpleJSONTextParser::Number::NT_Int8 && parsedVal.Type <= SimpleJSONTextParser::Number::NT_Uint16) {
+			//Valid number found
+			res.tz = TimeZone::fromTotalMinutesOffset(parsedVal.Value.Int16/60);
+			res.raw_offset = parsedVal.Value.Int16;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+			return false; //ERROR: wrong type
+		}
+	}
+	else if (keyLength == 8 && strncmp("timezone", key, 8) == 0) {
+		if (res.foundFlags.timezone_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+		}
+		res.foundFlags.timezone_found = true;
+		return false; //ERROR
+	}
+	else if (keyLength == 12 && strncmp("utc_datetime", key, 12) == 0) {
+		if (res.foundFlags.unixtime_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+		}
+		res.foundFlags.unixtime_found = true;
+		return false; //ERROR
+	}
+	else if (keyLength == 5 && strncmp("error", key, 5) == 0) {
+		//WorldTimeAPI sent error
+		res.foundFlags.error_found = true;
+		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
+		}
+		return false; //ERROR
+	}
+	return true;
+}
+
+bool WorldTimeAPI::jsonTextTZ(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr) {
+	if (depth != 1) return true; //We need only depth 1 here
+
+	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
+	if (keyLength == 12 && strncmp("abbreviation", key, 12) == 0) {
+		if (res.foundFlags.abbreviation_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.abbreviation_found = true;
+		SimpleJSONTextParser::unescapeAndCopy(res.result_ptr->abbreviation, sizeof(WorldTimeAPIResult::abbreviation) / sizeof(char), value, valueLength);
+	}
+	else if (keyLength == 9 && strncmp("client_ip", key, 9) == 0) {
+		if (res.foundFlags.client_ip_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.client_ip_found = true;
+		char client_ip[WTAPI_TZ_NAME_SIZE];
+		SimpleJSONTextParser::unescapeAndCopy(client_ip, WTAPI_TZ_NAME_SIZE, value, valueLength); //Copy and unescape IP
+		//Parse IP, IPv6 address is kept as unknown (0)
+		if (!parseIPv4(client_ip, res.result_ptr->clientIP) && strchr(client_ip, ':') == NULL) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
+			return false; //ERROR parsing failed
+		}
+	}
+	else if (keyLength == 3 && strncmp("dst", key, 3) == 0) {
+		if (res.foundFlags.dst_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+		}
+		res.foundFlags.dst_found = true;
+		return false; //ERROR
+	}
+	else if (keyLength == 8 && strncmp("dst_from", key, 8) == 0) {
+		if (res.foundFlags.dst_from_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.dst_from_found = true;
+		if (!WorldTimeAPICalendar::parseISO(value, valueLength, res.dst_from)) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
+			return false; //Parsing error
+		}
+	}
+	else if (keyLength == 10 && strncmp("dst_offset", key, 10) == 0) {
+		if (res.foundFlags.dst_offset_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+		}
+		res.foundFlags.dst_offset_found = true;
+		return false; //ERROR
+	}
+	else if (keyLength == 9 && strncmp("dst_until", key, 9) == 0) {
+		if (res.foundFlags.dst_until_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.dst_until_found = true;
+		if (!WorldTimeAPICalendar::parseISO(value, valueLength, res.dst_until)) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
+			return false; //Parsing error
+		}
+	}
+	else if (keyLength == 10 && strncmp("raw_offset", key, 10) == 0) {
+		if (res.foundFlags.raw_offset_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+		}
+		else {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_TYPE;
+		}
+		res.foundFlags.raw_offset_found = true;
+		return false; //ERROR
+	}
+	else if (keyLength == 8 && strncmp("timezone", key, 8) == 0) {
+		if (res.foundFlags.timezone_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.timezone_found = true;
+		char timezone[WTAPI_TZ_NAME_SIZE];
+		SimpleJSONTextParser::unescapeAndCopy(timezone, WTAPI_TZ_NAME_SIZE, value, valueLength);
+		res.result_ptr->timezoneId = WorldTimeAPIIntern::global().intern(timezone);
+		if (res.result_ptr->timezoneId == 0 && timezone[0] != 0) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_INTERN_FULL;
+			return false; //Name cannot be kept
+		}
+	}
+	else if (keyLength == 12 && strncmp("utc_datetime", key, 12) == 0) {
+		if (res.foundFlags.unixtime_found) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_FIELD_DOUBLE;
+			return false; //Same key found
+		}
+		res.foundFlags.unixtime_found = true;
+		if (res.unixtime.parse(value, valueLength, "y-M-dTHH:mm:ss.FFFFFFzzz", true) <= 0) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_WRONG_VALUE_FORMAT;
+			return false; //Parsing error
+		}
+	}
+	else if (keyLength == 5 && strncmp("error", key, 5) == 0) {
+		//WorldTimeAPI sent error
+		res.foundFlags.error_found = true;
+		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE || res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
+		}
+		res.result_ptr->errorId = WorldTimeAPIErrors::global().store(value, valueLength);
+		return false; //ERROR found
+	}
+	return true;
+}
+
+bool WorldTimeAPI::jsonControlTZ(JSONItemType type, const char* key, int keyLength, int depth, int index, void* owner_ptr) {
+	bool isArrJSON = (type == JSONItemType::JIT_ArrayBegin && depth == 0);
+	if (isArrJSON) {
+		WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
+		res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_PARTIAL_TIMEZONE;
+	}
+
+	return !isArrJSON; //Returns true when JSON is object, false when JSON is array
+}
+
+bool WorldTimeAPI::jsonItemERR(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr) {
+	if (depth != 1) return true; //We need only depth 1 here
+
+	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
+	if (keyLength == 5 && strncmp("error", key, 5) == 0) {
+		//WorldTimeAPI sent error
+		res.foundFlags.error_found = true;
+		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
+		}
+		return false; //ERROR found
+	}
+	return true;
+}
+
+bool WorldTimeAPI::jsonTextERR(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr) {
+	if (depth != 1) return true; //We need only depth 1 here
+
+	WorldTimeAPIResHelper& res = *reinterpret_cast<WorldTimeAPIResHelper*>(owner_ptr);
+	if (keyLength == 5 && strncmp("error", key, 5) == 0) {
+		//WorldTimeAPI sent error
+		res.foundFlags.error_found = true;
+		if (res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE || res.result_ptr->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
+			res.result_ptr->httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ERROR_RESPONSE;
+		}
+		res.result_ptr->errorId = WorldTimeAPIErrors::global().store(value, valueLength);
+		return false; //ERROR found
+	}
+	return true;
+}
+
+
+
+void WorldTimeAPI::setRateLimit(float requestsPerSecond, uint16_t burst) {
+	limiter.setRate(requestsPerSecond, burst);
+}
+
+void WorldTimeAPI::setRetryPolicy(uint8_t maxRetries_, uint32_t baseDelay, uint32_t maxDelay) {
+	maxRetries = maxRetries_;
+	limiter.setBackoff(baseDelay, maxDelay);
+}
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+WorldTimeAPI_HttpCode WorldTimeAPI::throttledGET(const char* url, WorldTimeAPIResponse& resp, uint32_t deadline) {
+	WorldTimeAPI_HttpCode httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	for (uint8_t attempt = 0; attempt <= maxRetries; attempt++) {
+		if (!breaker.allow()) {
+			//API is failing, request is not sent
+			resp.setError(WorldTimeAPI_HttpCode::WTA_ERROR_CIRCUIT_OPEN);
+			return WorldTimeAPI_HttpCode::WTA_ERROR_CIRCUIT_OPEN;
+		}
+
+		uint32_t left = remaining(deadline);
+		int32_t wait = limiter.reserve(left < maxThrottleWait ? left : maxThrottleWait);
+		if (wait < 0) {
+			//Request would wait too long, so it is not sent at all
+			breaker.cancel();
+			resp.setError(WorldTimeAPI_HttpCode::WTA_HTTP_CODE_TOO_MANY_REQUESTS);
+			return WorldTimeAPI_HttpCode::WTA_HTTP_CODE_TOO_MANY_REQUESTS;
+		}
+		WorldTimeAPIClock::sleep((uint32_t)wait);
+
+		left = remaining(deadline);
+		if (left == 0) {
+			breaker.cancel();
+			resp.setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT);
+			return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+		}
+
+#ifdef WTAPI_ENDPOINTS
+		httpCode = failoverGET(url, resp, deadline);
+#else
+		httpCode = sendGET(url, resp, left);
+#endif // WTAPI_ENDPOINTS
+		breaker.onResponse(httpCode);
+		if (!limiter.onResponse(httpCode, resp.getRetryAfter())) {
+			break; //Not throttled
+		}
+	}
+	return httpCode;
+}
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#ifdef WTAPI_ENDPOINTS
+WorldTimeAPI_HttpCode WorldTimeAPI::failoverGET(const char* url, WorldTimeAPIResponse& resp, uint32_t deadline) {
+	size_t baseLength = strlen(URL_Base);
+	if (endpoints == NULL || strncmp(url, URL_Base, baseLength) != 0) {
+		return sendGET(url, resp, remaining(deadline));
+	}
+
+	WorldTimeAPI_HttpCode httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+	uint32_t tried = 0;
+	while (true) {
+		uint32_t left = remaining(deadline);
+		if (left == 0) break;
+		int8_t index = endpoints->select(tried);
+		if (index < 0) break; //All endpoints failed
+		tried |= 1UL << index;
+
+		//When another endpoint can be tried, this one gets only part of time, so failover fits to deadline
+		uint32_t slice = left;
+		if (endpoints->available(tried) > 0) {
+			uint32_t latency = endpoints->getLatency(index);
+			slice = (latency > 0 && latency * 4 + 1000 < left / 2) ? latency * 4 + 1000 : left / 2;
+		}
+
+		char endpointURL[WTAPI_URL_SIZE];
+		int len = snprintf(endpointURL, sizeof(endpointURL), "%s%s", endpoints->getURL(index), url + baseLength);
+		if (len < 0 || len >= (int)sizeof(endpointURL)) {
+			httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+			break; //URL is too long
+		}
+		uint32_t start = WorldTimeAPIClock::now();
+		httpCode = sendGET(endpointURL, resp, slice);
+		endpoints->onResponse(index, httpCode, WorldTimeAPIClock::elapsed(start));
+		if (!WorldTimeAPIEndpoints::isFailure(httpCode)) break;
+	}
+	return httpCode;
+}
+#endif // WTAPI_ENDPOINTS
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+WorldTimeAPI_HttpCode WorldTimeAPI::throttledStream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t deadline) {
+	WorldTimeAPI_HttpCode httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	for (uint8_t attempt = 0; attempt <= maxRetries; attempt++) {
+		if (!breaker.allow()) {
+			//API is failing, request is not sent
+			return WorldTimeAPI_HttpCode::WTA_ERROR_CIRCUIT_OPEN;
+		}
+
+		uint32_t left = remaining(deadline);
+		int32_t wait = limiter.reserve(left < maxThrottleWait ? left : maxThrottleWait);
+		if (wait < 0) {
+			//Request would wait too long, so it is not sent at all
+			breaker.cancel();
+			return WorldTimeAPI_HttpCode::WTA_HTTP_CODE_TOO_MANY_REQUESTS;
+		}
+		WorldTimeAPIClock::sleep((uint32_t)wait);
+
+		left = remaining(deadline);
+		if (left == 0) {
+			breaker.cancel();
+			return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+		}
+
+		//Body is passed to callback only for successful response, so throttled request can be retried
+		uint32_t retryAfter = 0;
+		size_t baseLength = strlen(URL_Base);
+		int8_t index = (endpoints != NULL && strncmp(url, URL_Base, baseLength) == 0) ? endpoints->select() : -1;
+		if (index >= 0) {
+			//Body may be partially passed to callback, so failed stream is not sent to another endpoint
+			char endpointURL[WTAPI_URL_SIZE];
+			int len = snprintf(endpointURL, sizeof(endpointURL), "%s%s", endpoints->getURL(index), url + baseLength);
+			if (len < 0 || len >= (int)sizeof(endpointURL)) {
+				breaker.cancel();
+				return WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR; //URL is too long
+			}
+			uint32_t start = WorldTimeAPIClock::now();
+			httpCode = transport->stream(endpointURL, onChunk, owner, &retryAfter, left, dnsCache);
+			endpoints->onResponse(index, httpCode, WorldTimeAPIClock::elapsed(start));
+		}
+		else {
+			httpCode = transport->stream(url, onChunk, owner, &retryAfter, left, dnsCache);
+		}
+		breaker.onResponse(httpCode);
+		if (!limiter.onResponse(httpCode, retryAfter)) {
+			break; //Not throttled
+		}
+	}
+	return httpCode;
+}
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+WorldTimeAPI_HttpCode WorldTimeAPI::sendGET(const char* url, WorldTimeAPIResponse& resp, uint32_t timeout) {
+#ifdef WTAPI_HEDGING
+	uint32_t hedgeDelay = getHedgeDelay();
+	if (hedgeDelay > 0 && hedgeDelay < timeout) {
+		std::shared_ptr<Hedge> hedge = std::make_shared<Hedge>();
+		std::string urlStr = url;
+		hedge->startTime = WorldTimeAPIClock::now();
+		uint32_t deadline = hedge->startTime + timeout;
+
+		std::unique_lock<std::mutex> lock(hedge->mutex);
+		startHedged(hedge, urlStr, timeout, dnsCache, transport);
+		if (!hedge->cv.wait_for(lock, std::chrono::milliseconds(hedgeDelay), [&hedge] { return hedge->done; })) {
+			//Primary request is late, sending hedged request if rate limiter allows it
+			uint32_t left = remaining(deadline);
+			if (left > 0 && limiter.reserve(0) == 0) {
+				startHedged(hedge, urlStr, left, dnsCache, transport);
+			}
+			hedge->cv.wait(lock, [&hedge] { return hedge->done; });
+		}
+
+		//Body of faster request is moved to receive buffer
+		resp.clear();
+		resp.getBuffer().swap(hedge->resp);
+		resp.setBodyOnly(hedge->httpCode, hedge->retryAfter);
+		WorldTimeAPI_HttpCode httpCode = hedge->httpCode;
+		lock.unlock();
+		if (httpCode > WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+			addLatencySample(WorldTimeAPIClock::elapsed(hedge->startTime));
+		}
+		return httpCode;
+	}
+#endif // WTAPI_HEDGING
+
+	uint32_t start = WorldTimeAPIClock::now();
+	WorldTimeAPI_HttpCode httpCode = transport->fetch(url, resp, timeout, dnsCache);
+#ifdef WTAPI_HEDGING
+	if (httpCode > WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+		addLatencySample(WorldTimeAPIClock::elapsed(start));
+	}
+#endif // WTAPI_HEDGING
+	return httpCode;
+}
+
+WorldTimeAPIResponse* WorldTimeAPI::acquireResponse() {
+#ifdef WTAPI_THREAD_SAFE
+	{
+		std::lock_guard<std::mutex> lock(responsesMutex);
+		if (!idleResponses.empty()) {
+			WorldTimeAPIResponse* idle = idleResponses.back();
+			idleResponses.pop_back();
+			return idle;
+		}
+	}
+	WorldTimeAPIResponse* created = new WorldTimeAPIResponse();
+	created->getArena().setCapacity(arenaSize);
+	return created;
+#else
+	if (response == NULL) {
+		response = new WorldTimeAPIResponse();
+		response->getArena().setCapacity(arenaSize);
+	}
+	return response;
+#endif // WTAPI_THREAD_SAFE
+}
+
+void WorldTimeAPI::releaseResponse(WorldTimeAPIResponse* resp) {
+	//Memory of lookup is released at once, block of arena stays for next lookup
+	size_t used = resp->getArena().getHighWater();
+	resp->clear();
+#ifdef WTAPI_THREAD_SAFE
+	{
+		std::lock_guard<std::mutex> lock(responsesMutex);
+		if (used > arenaHighWater) arenaHighWater = used;
+		if (idleResponses.size() < WTAPI_MAX_IDLE_RESPONSES) {
+			idleResponses.push_back(resp);
+			return;
+		}
+	}
+	delete resp; //Enough buffers are kept for usual concurrency
+#else
+	if (used > arenaHighWater) arenaHighWater = used;
+#endif // WTAPI_THREAD_SAFE
+}
+
+void WorldTimeAPI::setArenaSize(size_t size) {
+#ifdef WTAPI_THREAD_SAFE
+	std::lock_guard<std::mutex> lock(responsesMutex);
+	for (WorldTimeAPIResponse* idle : idleResponses) {
+		idle->getArena().setCapacity(size);
+	}
+#else
+	if (response != NULL) {
+		response->getArena().setCapacity(size);
+	}
+#endif // WTAPI_THREAD_SAFE
+	arenaSize = size;
+	arenaHighWater = 0;
+}
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#ifdef WTAPI_HEDGING
+void WorldTimeAPI::setHedging(float percentile, uint32_t minDelay) {
+	std::lock_guard<std::mutex> lock(latencyMutex);
+	hedgePercentile = (percentile > 0 && percentile < 1) ? percentile : 0;
+	hedgeMinDelay = minDelay;
+}
+
+void WorldTimeAPI::startHedged(const std::shared_ptr<Hedge>& hedge, const std::string& url, uint32_t timeout, WorldTimeAPIDNSCache* dns,
+	WorldTimeAPITransport* transport) {
+	//Must be called with locked hedge mutex
+	hedge->sent++;
+	{
+		std::lock_guard<std::mutex> lock(hedgeMutex);
+		hedgeCount++;
+	}
+	std::thread([this, hedge, url, timeout, dns, transport]() {
+		std::string resp;
+		uint32_t retryAfter = 0;
+		WorldTimeAPI_HttpCode httpCode = transport->get(url.c_str(), resp, &retryAfter, timeout, dns);
+
+		{
+			std::lock_guard<std::mutex> lock(hedge->mutex);
+			hedge->finished++;
+			//First response or last failed request, unless another request was faster
+			if (!hedge->done && (httpCode > WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE || hedge->finished == hedge->sent)) {
+				hedge->done = true;
+				hedge->httpCode = httpCode;
+				hedge->resp = std::move(resp);
+				hedge->retryAfter = retryAfter;
+				hedge->cv.notify_all();
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(hedgeMutex);
+		hedgeCount--;
+		hedgeDone.notify_all();
+	}).detach();
+}
+
+void WorldTimeAPI::waitForHedges() {
+	std::unique_lock<std::mutex> lock(hedgeMutex);
+	hedgeDone.wait(lock, [this] { return hedgeCount == 0; });
+}
+
+void WorldTimeAPI::addLatencySample(uint32_t latency) {
+	std::lock_guard<std::mutex> lock(latencyMutex);
+	latencySamples[latencyPos] = latency;
+	latencyPos = (latencyPos + 1) % LATENCY_SAMPLES;
+	if (latencyCount < LATENCY_SAMPLES) latencyCount++;
+}
+
+uint32_t WorldTimeAPI::getHedgeDelay() {
+	std::lock_guard<std::mutex> lock(latencyMutex);
+	if (hedgePercentile <= 0 || latencyCount < 16) {
+		return 0; //Disabled or not enough samples
+	}
+	uint32_t sorted[LATENCY_SAMPLES];
+	memcpy(sorted, latencySamples, latencyCount * sizeof(uint32_t));
+	uint8_t n = (uint8_t)(hedgePercentile * (latencyCount - 1));
+	std::nth_element(sorted, sorted + n, sorted + latencyCount);
+	return (sorted[n] > hedgeMinDelay) ? sorted[n] : hedgeMinDelay;
+}
+#endif // WTAPI_HEDGING
+
+uint32_t WorldTimeAPI::parseRetryAfter(const char* value, int valueLength) {
+	int i = 0;
+	for (; i < valueLength && (value[i] == ' ' || value[i] == '\t'); i++); //Skipping white characters
+	uint32_t seconds = 0;
+	int digits = 0;
+	for (; i < valueLength && value[i] >= '0' && value[i] <= '9'; i++, digits++) {
+		if (seconds < 100000000) {
+			seconds *= 10;
+			seconds += value[i] - '0';
+		}
+	}
+	for (; i < valueLength && (value[i] == ' ' || value[i] == '\t' || value[i] == '\r'); i++);
+	if (digits == 0 || i != valueLength) {
+		return 0; //Not delta seconds (may be HTTP date)
+	}
+	return seconds;
+}
+
+#ifdef WTAPI_COUNT_ALLOCATIONS
+#ifdef WTAPI_THREAD_SAFE
+static std::atomic<uint32_t> allocationCount(0);
+#else
+static volatile uint32_t allocationCount = 0;
+#endif // WTAPI_THREAD_SAFE
+
+uint32_t WorldTimeAPI::getAllocationCount() {
+	return allocationCount;
+}
+
+void* operator new(size_t size) {
+	allocationCount++;
+	void* ptr = malloc(size > 0 ? size : 1);
+#if defined(__cpp_exceptions)
+	if (ptr == NULL) throw std::bad_alloc();
+#endif
+	return ptr;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	free(ptr);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* ptr, size_t) noexcept {
+	free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+	free(ptr);
+}
+#endif
+#endif // WTAPI_COUNT_ALLOCATIONS
+
+const char* WorldTimeAPI::URL_Base = "http://worldtimeapi.org/api";
+const char* WorldTimeAPI::URL_TimeZone = "http://worldtimeapi.org/api/timezone";
+const char* WorldTimeAPI::URL_IP = "http://worldtimeapi.org/api/ip";
@@ -1,419 +1,1395 @@
-/**
- * @file WorldTimeAPI.h
- * @brief This file contains base class cliend side of WorldTimeAPI.
- *
- * @see WorldTimeAPI
- *
- * # Credits
- * @author Matej Fito
- * @date Jun 15, 2022
- */
-
-#ifndef WORLD_TIME_API_H_
-#define WORLD_TIME_API_H_
-
-#include "DateTime.h"
-#include "SimpleJSONParser.h"
-
-#if defined(SJSONP_UNDER_OS)
-#include <fstream>
-#include <sstream>
-#include <stdlib.h>
-#include <stdio.h>
-
-#elif defined(ARDUINO)
-
-#if defined(ESP8266) || defined(ESP32)
-#include <IPAddress.h>
-#endif
-
-
-
-#endif // !SJSONP_UNDER_OS
-
-#define WTAPI_TZ_NAME_SIZE        (45)
-#define WTAPI_TZ_ABR_NAME_SIZE    (8)
-#define WTAPI_TZ_CLIENT_IP_SIZE   (3 * 4 + 3 + 1)
-
-//WorldTimeAPI http codes
-typedef enum {
-	/**
-	* Full time zone was not specified and list of time zones was returned.
-	* To get that list, call getListOfTimeZones(). This can be set only when calling getByTimeZone().
-	*/
-	WTA_ERROR_PARTIAL_TIMEZONE = -108,
-	/**
-	* Wrong argument set.
-	*/
-	WTA_ERROR_ARGUMENT_ERROR = -107,
-	/**
-	* Same JSON field found multiple times
-	*/
-	WTA_ERROR_FIELD_DOUBLE = -106,
-	/**
-	* Some fields from JSON response are missing
-	*/
-	WTA_ERROR_FIELD_MISSING = -105,
-	/**
-	* Some value in JSON response has incorrect format
-	*/
-	WTA_ERROR_WRONG_VALUE_FORMAT = -104,
-	/**
-	* Some value in JSON was out of range
-	*/
-	WTA_ERROR_VALUE_OUT_OF_RANGE = -103,
-	/**
-	* Some value type in JSON response has differrent type as expected
-	*/
-	WTA_ERROR_WRONG_VALUE_TYPE = -102,
-	/**
-	* JSON response parsing failed or wrong response returned
-	*/
-	WTA_ERROR_WRONG_RESPONSE = -101,
-	/**
-	* JSON response contains "error" field with error message
-	*/
-	WTA_ERROR_ERROR_RESPONSE = -100,
-
-
-
-	//ESP8266 and ESP32 codes
-	WTA_HTTP_ERROR_CONNECTION_FAILED = -1,
-	WTA_HTTP_ERROR_SEND_HEADER_FAILED = -2,
-	WTA_HTTP_ERROR_SEND_PAYLOAD_FAILED = -3,
-	WTA_HTTP_ERROR_NOT_CONNECTED = -4,
-	WTA_HTTP_ERROR_CONNECTION_LOST = -5,
-	WTA_HTTP_ERROR_NO_STREAM = -6,
-	WTA_HTTP_ERROR_NO_HTTP_SERVER = -7,
-	WTA_HTTP_ERROR_TOO_LESS_RAM = -8,
-	WTA_HTTP_ERROR_ENCODING = -9,
-	WTA_HTTP_ERROR_STREAM_WRITE = -10,
-	WTA_HTTP_ERROR_READ_TIMEOUT = -11,
-
-	WTA_HTTP_NO_CODE = 0,
-	WTA_HTTP_CODE_CONTINUE = 100,
-	WTA_HTTP_CODE_SWITCHING_PROTOCOLS = 101,
-	WTA_HTTP_CODE_PROCESSING = 102,
-	WTA_HTTP_CODE_OK = 200,
-	WTA_HTTP_CODE_CREATED = 201,
-	WTA_HTTP_CODE_ACCEPTED = 202,
-	WTA_HTTP_CODE_NON_AUTHORITATIVE_INFORMATION = 203,
-	WTA_HTTP_CODE_NO_CONTENT = 204,
-	WTA_HTTP_CODE_RESET_CONTENT = 205,
-	WTA_HTTP_CODE_PARTIAL_CONTENT = 206,
-	WTA_HTTP_CODE_MULTI_STATUS = 207,
-	WTA_HTTP_CODE_ALREADY_REPORTED = 208,
-	WTA_HTTP_CODE_IM_USED = 226,
-	WTA_HTTP_CODE_MULTIPLE_CHOICES = 300,
-	WTA_HTTP_CODE_MOVED_PERMANENTLY = 301,
-	WTA_HTTP_CODE_FOUND = 302,
-	WTA_HTTP_CODE_SEE_OTHER = 303,
-	WTA_HTTP_CODE_NOT_MODIFIED = 304,
-	WTA_HTTP_CODE_USE_PROXY = 305,
-	WTA_HTTP_CODE_TEMPORARY_REDIRECT = 307,
-	WTA_HTTP_CODE_PERMANENT_REDIRECT = 308,
-	WTA_HTTP_CODE_BAD_REQUEST = 400,
-	WTA_HTTP_CODE_UNAUTHORIZED = 401,
-	WTA_HTTP_CODE_PAYMENT_REQUIRED = 402,
-	WTA_HTTP_CODE_FORBIDDEN = 403,
-	WTA_HTTP_CODE_NOT_FOUND = 404,
-	WTA_HTTP_CODE_METHOD_NOT_ALLOWED = 405,
-	WTA_HTTP_CODE_NOT_ACCEPTABLE = 406,
-	WTA_HTTP_CODE_PROXY_AUTHENTICATION_REQUIRED = 407,
-	WTA_HTTP_CODE_REQUEST_TIMEOUT = 408,
-	WTA_HTTP_CODE_CONFLICT = 409,
-	WTA_HTTP_CODE_GONE = 410,
-	WTA_HTTP_CODE_LENGTH_REQUIRED = 411,
-	WTA_HTTP_CODE_PRECONDITION_FAILED = 412,
-	WTA_HTTP_CODE_PAYLOAD_TOO_LARGE = 413,
-	WTA_HTTP_CODE_URI_TOO_LONG = 414,
-	WTA_HTTP_CODE_UNSUPPORTED_MEDIA_TYPE = 415,
-	WTA_HTTP_CODE_RANGE_NOT_SATISFIABLE = 416,
-	WTA_HTTP_CODE_EXPECTATION_FAILED = 417,
-	WTA_HTTP_CODE_MISDIRECTED_REQUEST = 421,
-	WTA_HTTP_CODE_UNPROCESSABLE_ENTITY = 422,
-	WTA_HTTP_CODE_LOCKED = 423,
-	WTA_HTTP_CODE_FAILED_DEPENDENCY = 424,
-	WTA_HTTP_CODE_UPGRADE_REQUIRED = 426,
-	WTA_HTTP_CODE_PRECONDITION_REQUIRED = 428,
-	WTA_HTTP_CODE_TOO_MANY_REQUESTS = 429,
-	WTA_HTTP_CODE_REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
-	WTA_HTTP_CODE_INTERNAL_SERVER_ERROR = 500,
-	WTA_HTTP_CODE_NOT_IMPLEMENTED = 501,
-	WTA_HTTP_CODE_BAD_GATEWAY = 502,
-	WTA_HTTP_CODE_SERVICE_UNAVAILABLE = 503,
-	WTA_HTTP_CODE_GATEWAY_TIMEOUT = 504,
-	WTA_HTTP_CODE_HTTP_VERSION_NOT_SUPPORTED = 505,
-	WTA_HTTP_CODE_VARIANT_ALSO_NEGOTIATES = 506,
-	WTA_HTTP_CODE_INSUFFICIENT_STORAGE = 507,
-	WTA_HTTP_CODE_LOOP_DETECTED = 508,
-	WTA_HTTP_CODE_NOT_EXTENDED = 510,
-	WTA_HTTP_CODE_NETWORK_AUTHENTICATION_REQUIRED = 511
-}WorldTimeAPI_HttpCode;
-
-
-/**
-* @struct WorldTimeAPIResult
-* @brief WorldTimeAPI result, which contains time zone and date time informations.
-*/
-struct WorldTimeAPIResult {
-	WorldTimeAPIResult() {
-		clear();
-	}
-
-	/**
-	* @brief Olson time zone name. IANA database identifier.
-	*/
-	char timezone[WTAPI_TZ_NAME_SIZE];
-
-	/**
-	* @brief Abbreviation name of time zone.
-	*/
-	char abbreviation[WTAPI_TZ_ABR_NAME_SIZE];
-
-	/**
-	* @brief True if DST was applied when result was read.
-	*/
-	bool wasDST;
-
-#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
-	/**
-	* @brief Client public IPv4 IP address. On ESP32 and ESP8266 with arduino core
-	* IP address is represented by IPAddress class.
-	*/
-	IPAddress client_ip;
-#else
-	/**
-	* @brief Client public IPv4 IP address represented by string.
-	*/
-	char client_ip[WTAPI_TZ_CLIENT_IP_SIZE];
-#endif // defined(ESP8266) || defined(ESP32)
-	
-	/**
-	* @brief Current date time, time zone offset and DST adjustment.
-	*/
-	DateTimeTZSysSync datetime;
-
-	/**
-	* @brief HTTP code of operation.
-	*/
-	WorldTimeAPI_HttpCode httpCode;
-
-#ifdef ARDUINO
-	/**
-	* @brief Error returned by WorldTimeAPI.
-	*/
-	String error;
-#else
-	/**
-	* @brief Error returned by WorldTimeAPI.
-	*/
-	std::string error;
-#endif // ARDUINO
-
-	/**
-	* @brief True if current response is not valid.
-	*/
-	inline bool hasError() const {
-		return httpCode != WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK;
-	}
-
-	/**
-	* @brief Clears result.
-	*/
-	void clear();
-
-	/**
-	* @brief Converts this result to tome zone informations.
-	*/
-	TimeZoneInfo toTimeZoneInfo() const;
-};
-
-
-/**
-* @class WorldTimeAPI
-* @brief This class represent client side of <a href="http://worldtimeapi.org/">WorldTimeAPI</a>.
-* 
-* > WorldTimeAPI is a simple web service which returns the current local time for a given timezone as either plain-text or JSON.
-*/
-class WorldTimeAPI
-{
-public:
-
-#ifdef ARDUINO/**
-	* @brief Gets list of accepted olson time zones.
-	* @warning This method can return string with size up to 7kB, which may use all RAM memory on microcontrollers.
-	* @param[out] list Out parameter, which will contain list of all accepted time zones separated by "\r\n".
-	* @param[in] tz Part olson time zone, for example to list all time zones in Europe,
-	* set it to: "Europe" and it will returns: "Europe/Amsterdam","Europe/Andorra","Europe/Astrakhan", ...
-	* If set to NULL, all supported time zones are retrieved.
-	* @return Returns HTTP code of result.
-	*/
-	WorldTimeAPI_HttpCode getListOfTimeZones(String& list, const char* tz = NULL);
-#else
-	/**
-	* @brief Gets list of accepted olson time zones.
-	* @param[out] list Out parameter, which will contain list of all accepted time zones separated by "\r\n".
-	* @param[in] tz Part olson time zone, for example to list all time zones in Europe,
-	* set it to: "Europe" and it will returns: "Europe/Amsterdam","Europe/Andorra","Europe/Astrakhan", ...
-	* If set to NULL, all supported time zones are retrieved.
-	* @return Returns HTTP code of result.
-	*/
-	WorldTimeAPI_HttpCode getListOfTimeZones(std::string& list, const char* tz = NULL);
-#endif // ARDUINO
-
-	/**
-	* @brief Gets time zone informations by time zone name.
-	* @param[in] tz Olson time zone name, for example: "Europe/Amsterdam".
-	* If only partial time zone is specified (for example: "Europe"), http code will be set to
-	* WTA_ERROR_PARTIAL_TIMEZONE, because API returned list of accepted time zones instead of time
-	* zone info. To get that list, call getListOfTimeZones();
-	* @return Returns constant reference to result.
-	*/
-	const WorldTimeAPIResult& getByTimeZone(const char* tz);
-
-	/**
-	* @brief Gets time zone informations by public IP address.
-	* @param[in] IP Text with valid IPv4 address. If set to null, current public IP address is used.
-	* @note Only IPv4 addresses are supported.
-	* @return Returns constant reference to result.
-	*/
-	const WorldTimeAPIResult& getByIP(const char* IP = NULL);
-
-#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
-	/**
-	* @brief Gets time zone informations by public IP address.
-	* @param[in] IP Valid IPv4 address.
-	* @note Only IPv4 addresses are supported.
-	* @return Returns constant reference to result.
-	*/
-	const WorldTimeAPIResult& getByIP(const IPAddress& IP);
-#endif // !SJSONP_UNDER_OS
-
-	/**
-	* @brief Gets last result from getByIP() or getByTimeZone() method.
-	*/
-	inline const WorldTimeAPIResult& getLastResult() const{
-		return lastRes;
-	}
-
-protected:
-
-	/**
-	* @brief Last result from getByIP() or getByTimeZone() method.
-	*/
-	WorldTimeAPIResult lastRes;
-
-	const WorldTimeAPIResult& getAndParseTZ(const char* url);
-
-	static bool jsonItemTZ(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr);
-
-	static bool jsonTextTZ(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr);
-
-	static bool jsonControlTZ(JSONItemType type, const char* key, int keyLength, int depth, int index, void* owner_ptr);
-
-	static bool jsonItemERR(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr);
-
-	static bool jsonTextERR(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr);
-
-
-	static const char* URL_TimeZone;
-	static const char* URL_IP;
-
-#if defined(SJSONP_UNDER_OS)
-	static WorldTimeAPI_HttpCode requestGET(const char* url, std::string& resp);
-#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
-	static WorldTimeAPI_HttpCode requestGET(const char* url, String& resp);
-#endif // !SJSONP_UNDER_OS
-
-
-#if defined(SJSONP_UNDER_OS)
-	/**
-	* @brief Calls command (CMD) and retrieves it's result.
-	* @param command Command to call.
-	* @return Returns response to command.
-	*/
-	static std::string ssystem(const char* command);
-#endif // !SJSONP_UNDER_OS
-
-
-
-	class WorldTimeAPIResHelper {
-	public:
-		WorldTimeAPIResHelper(WorldTimeAPIResult* result_ptr_) : result_ptr(result_ptr_)
-		{}
-
-		/**
-		* @struct FFlags
-		* @brief Structure, which represents found flags.
-		*/
-		struct FFlags {
-
-			FFlags() :
-				abbreviation_found(false),
-				client_ip_found(false),
-				dst_found(false),
-				dst_from_found(false),
-				dst_offset_found(false),
-				dst_until_found(false),
-				raw_offset_found(false),
-				timezone_found(false),
-				unixtime_found(false),
-				error_found(false)
-			{}
-
-			FFlags(uint16_t raw) {
-				const FFlags* tmp = reinterpret_cast<const FFlags*>(&raw);
-				*this = *tmp;
-			}
-
-			operator uint16_t& () {
-				return *(reinterpret_cast<uint16_t*>(this));
-			}
-
-			operator uint16_t() const {
-				return *(reinterpret_cast<const uint16_t*>(this));
-			}
-
-			bool abbreviation_found : 1;
-			bool client_ip_found : 1;
-			bool dst_found : 1;
-			bool dst_from_found : 1;
-			bool dst_offset_found : 1;
-			bool dst_until_found : 1;
-			bool raw_offset_found : 1;
-			bool timezone_found : 1;
-
-			bool unixtime_found : 1;
-			bool error_found : 1;
-
-			inline bool allValidFound() const {
-				return *(reinterpret_cast<const uint16_t*>(this)) >= 0x1FF && !error_found;
-			}
-		};
-
-		/**
-		* @brief Found keys flags.
-		*/
-		FFlags foundFlags;
-
-		/**
-		* @brief Pointer to WorldTimeAPIResult.
-		*/
-		WorldTimeAPIResult* result_ptr;
-
-		bool dst = false;
-		bool dst_null = false;
-
-		TimeZone tz;
-		DateTime dst_from;
-		DateTime dst_until;
-		int16_t dst_offset = 0;
-
-		DateTimeSysSync unixtime;
-	};
-};
-
-
-#endif // !WORLD_TIME_API_H_
-
+/**
+ * @file WorldTimeAPI.h
+ * @brief This file contains base class cliend side of WorldTimeAPI.
+ *
+ * @see WorldTimeAPI
+ *
+ * # Credits
+ * @author Matej Fito
+ * @date Jun 15, 2022
+ */
+
+#ifndef WORLD_TIME_API_H_
+#define WORLD_TIME_API_H_
+
+#include "DateTime.h"
+#include "SimpleJSONParser.h"
+#include "WorldTimeAPIRateLimiter.h"
+#include "WorldTimeAPICircuitBreaker.h"
+#include "WorldTimeAPIDNSCache.h"
+#include "WorldTimeAPIEndpoints.h"
+#include "WorldTimeAPIIPCache.h"
+#include "WorldTimeAPICalendar.h"
+#include "WorldTimeAPITZif.h"
+#include "WorldTimeAPIIntern.h"
+#include "WorldTimeAPIZones.h"
+#include "WorldTimeAPIAsync.h"
+#include "WorldTimeAPIArena.h"
+
+#if defined(SJSONP_UNDER_OS)
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <stdio.h>
+
+#elif defined(ARDUINO)
+
+#if defined(ESP8266) || defined(ESP32)
+#include <IPAddress.h>
+#endif
+
+
+
+#endif // !SJSONP_UNDER_OS
+
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+//Multiple threads can use one WorldTimeAPI client
+#define WTAPI_THREAD_SAFE (1)
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#endif // SJSONP_UNDER_OS || ESP32
+
+#if defined(SJSONP_UNDER_OS)
+//Duplicate (hedged) requests are sent from another thread
+#define WTAPI_HEDGING (1)
+//Stale cached results are refreshed in another thread
+#define WTAPI_BACKGROUND_REFRESH (1)
+#include <algorithm>
+#include <thread>
+#endif // SJSONP_UNDER_OS
+
+#define WTAPI_TZ_NAME_SIZE        (45)
+#define WTAPI_TZ_ABR_NAME_SIZE    (8)
+#define WTAPI_TZ_CLIENT_IP_SIZE   (3 * 4 + 3 + 1)
+#define WTAPI_CACHE_MAX_ENTRIES   (64)
+#define WTAPI_MAX_IDLE_RESPONSES  (4)
+#if defined(SJSONP_UNDER_OS)
+#define WTAPI_URL_SIZE            (192)
+#define WTAPI_MAX_FLIGHTS         (8)
+#else
+#define WTAPI_URL_SIZE            (128)
+#define WTAPI_MAX_FLIGHTS         (2)
+#endif // SJSONP_UNDER_OS
+
+//WorldTimeAPI http codes
+typedef enum {
+	/**
+	* Request was not sent, because circuit breaker is open after repeated failures of WorldTimeAPI.
+	* See setCircuitBreaker().
+	*/
+	WTA_ERROR_CIRCUIT_OPEN = -109,
+	/**
+	* Time zone name could not be stored, because table of time zone names (WorldTimeAPIIntern) is full.
+	*/
+	WTA_ERROR_INTERN_FULL = -110,
+	/**
+	* Full time zone was not specified and list of time zones was returned.
+	* To get that list, call getListOfTimeZones(). This can be set only when calling getByTimeZone().
+	*/
+	WTA_ERROR_PARTIAL_TIMEZONE = -108,
+	/**
+	* Wrong argument set.
+	*/
+	WTA_ERROR_ARGUMENT_ERROR = -107,
+	/**
+	* Same JSON field found multiple times
+	*/
+	WTA_ERROR_FIELD_DOUBLE = -106,
+	/**
+	* Some fields from JSON response are missing
+	*/
+	WTA_ERROR_FIELD_MISSING = -105,
+	/**
+	* Some value in JSON response has incorrect format
+	*/
+	WTA_ERROR_WRONG_VALUE_FORMAT = -104,
+	/**
+	* Some value in JSON was out of range
+	*/
+	WTA_ERROR_VALUE_OUT_OF_RANGE = -103,
+	/**
+	* Some value type in JSON response has differrent type as expected
+	*/
+	WTA_ERROR_WRONG_VALUE_TYPE = -102,
+	/**
+	* JSON response parsing failed or wrong response returned
+	*/
+	WTA_ERROR_WRONG_RESPONSE = -101,
+	/**
+	* JSON response contains "error" field with error message
+	*/
+	WTA_ERROR_ERROR_RESPONSE = -100,
+
+
+
+	//ESP8266 and ESP32 codes
+	WTA_HTTP_ERROR_CONNECTION_FAILED = -1,
+	WTA_HTTP_ERROR_SEND_HEADER_FAILED = -2,
+	WTA_HTTP_ERROR_SEND_PAYLOAD_FAILED = -3,
+	WTA_HTTP_ERROR_NOT_CONNECTED = -4,
+	WTA_HTTP_ERROR_CONNECTION_LOST = -5,
+	WTA_HTTP_ERROR_NO_STREAM = -6,
+	WTA_HTTP_ERROR_NO_HTTP_SERVER = -7,
+	WTA_HTTP_ERROR_TOO_LESS_RAM = -8,
+	WTA_HTTP_ERROR_ENCODING = -9,
+	WTA_HTTP_ERROR_STREAM_WRITE = -10,
+	WTA_HTTP_ERROR_READ_TIMEOUT = -11,
+
+	WTA_HTTP_NO_CODE = 0,
+	WTA_HTTP_CODE_CONTINUE = 100,
+	WTA_HTTP_CODE_SWITCHING_PROTOCOLS = 101,
+	WTA_HTTP_CODE_PROCESSING = 102,
+	WTA_HTTP_CODE_OK = 200,
+	WTA_HTTP_CODE_CREATED = 201,
+	WTA_HTTP_CODE_ACCEPTED = 202,
+	WTA_HTTP_CODE_NON_AUTHORITATIVE_INFORMATION = 203,
+	WTA_HTTP_CODE_NO_CONTENT = 204,
+	WTA_HTTP_CODE_RESET_CONTENT = 205,
+	WTA_HTTP_CODE_PARTIAL_CONTENT = 206,
+	WTA_HTTP_CODE_MULTI_STATUS = 207,
+	WTA_HTTP_CODE_ALREADY_REPORTED = 208,
+	WTA_HTTP_CODE_IM_USED = 226,
+	WTA_HTTP_CODE_MULTIPLE_CHOICES = 300,
+	WTA_HTTP_CODE_MOVED_PERMANENTLY = 301,
+	WTA_HTTP_CODE_FOUND = 302,
+	WTA_HTTP_CODE_SEE_OTHER = 303,
+	WTA_HTTP_CODE_NOT_MODIFIED = 304,
+	WTA_HTTP_CODE_USE_PROXY = 305,
+	WTA_HTTP_CODE_TEMPORARY_REDIRECT = 307,
+	WTA_HTTP_CODE_PERMANENT_REDIRECT = 308,
+	WTA_HTTP_CODE_BAD_REQUEST = 400,
+	WTA_HTTP_CODE_UNAUTHORIZED = 401,
+	WTA_HTTP_CODE_PAYMENT_REQUIRED = 402,
+	WTA_HTTP_CODE_FORBIDDEN = 403,
+	WTA_HTTP_CODE_NOT_FOUND = 404,
+	WTA_HTTP_CODE_METHOD_NOT_ALLOWED = 405,
+	WTA_HTTP_CODE_NOT_ACCEPTABLE = 406,
+	WTA_HTTP_CODE_PROXY_AUTHENTICATION_REQUIRED = 407,
+	WTA_HTTP_CODE_REQUEST_TIMEOUT = 408,
+	WTA_HTTP_CODE_CONFLICT = 409,
+	WTA_HTTP_CODE_GONE = 410,
+	WTA_HTTP_CODE_LENGTH_REQUIRED = 411,
+	WTA_HTTP_CODE_PRECONDITION_FAILED = 412,
+	WTA_HTTP_CODE_PAYLOAD_TOO_LARGE = 413,
+	WTA_HTTP_CODE_URI_TOO_LONG = 414,
+	WTA_HTTP_CODE_UNSUPPORTED_MEDIA_TYPE = 415,
+	WTA_HTTP_CODE_RANGE_NOT_SATISFIABLE = 416,
+	WTA_HTTP_CODE_EXPECTATION_FAILED = 417,
+	WTA_HTTP_CODE_MISDIRECTED_REQUEST = 421,
+	WTA_HTTP_CODE_UNPROCESSABLE_ENTITY = 422,
+	WTA_HTTP_CODE_LOCKED = 423,
+	WTA_HTTP_CODE_FAILED_DEPENDENCY = 424,
+	WTA_HTTP_CODE_UPGRADE_REQUIRED = 426,
+	WTA_HTTP_CODE_PRECONDITION_REQUIRED = 428,
+	WTA_HTTP_CODE_TOO_MANY_REQUESTS = 429,
+	WTA_HTTP_CODE_REQUEST_HEADER_FIELDS_TOO_LARGE = 431,
+	WTA_HTTP_CODE_INTERNAL_SERVER_ERROR = 500,
+	WTA_HTTP_CODE_NOT_IMPLEMENTED = 501,
+	WTA_HTTP_CODE_BAD_GATEWAY = 502,
+	WTA_HTTP_CODE_SERVICE_UNAVAILABLE = 503,
+	WTA_HTTP_CODE_GATEWAY_TIMEOUT = 504,
+	WTA_HTTP_CODE_HTTP_VERSION_NOT_SUPPORTED = 505,
+	WTA_HTTP_CODE_VARIANT_ALSO_NEGOTIATES = 506,
+	WTA_HTTP_CODE_INSUFFICIENT_STORAGE = 507,
+	WTA_HTTP_CODE_LOOP_DETECTED = 508,
+	WTA_HTTP_CODE_NOT_EXTENDED = 510,
+	WTA_HTTP_CODE_NETWORK_AUTHENTICATION_REQUIRED = 511
+}WorldTimeAPI_HttpCode;
+
+//WorldTimeAPI response formats
+typedef enum {
+	/**
+	* JSON response (default).
+	*/
+	WTA_FORMAT_JSON = 0,
+	/**
+	* Plain text response with one "key: value" pair per line. It is parsed faster than JSON,
+	* because it contains no quotes and escaped characters.
+	*/
+	WTA_FORMAT_TEXT = 1
+}WorldTimeAPI_Format;
+
+//Sources of time zone informations for getByTimeZone()
+typedef enum {
+	/**
+	* Time zone informations are always requested from WorldTimeAPI (default).
+	*/
+	WTA_TZ_SOURCE_NETWORK = 0,
+	/**
+	* Time zone informations are resolved from local tzdata. WorldTimeAPI is requested only for
+	* time zones, which are not found in local tzdata.
+	*/
+	WTA_TZ_SOURCE_LOCAL = 1,
+	/**
+	* Time zone informations are resolved from local tzdata and checked against WorldTimeAPI.
+	* When they differ, result from WorldTimeAPI is used.
+	*/
+	WTA_TZ_SOURCE_CROSS_CHECK = 2
+}WorldTimeAPI_TZSource;
+
+#define WTAPI_LIST_LINE_SIZE      (64)
+
+/**
+* @brief Callback, which receives one time zone name from list of time zones.
+* @param name Time zone name, it is null terminated.
+* @param length Length of name.
+* @param owner Pointer passed to getListOfTimeZones().
+* @return Returns false to stop receiving of list.
+*/
+typedef bool (*WorldTimeAPI_TimeZoneCallback)(const char* name, size_t length, void* owner);
+
+/**
+* @brief Callback, which receives part of body of response.
+* @param data Part of body.
+* @param length Length of data.
+* @param owner Pointer passed to transport.
+* @return Returns false to stop receiving of response.
+*/
+typedef bool (*WorldTimeAPI_ChunkCallback)(const char* data, size_t length, void* owner);
+
+
+/**
+* @struct WorldTimeAPIResult
+* @brief WorldTimeAPI result, which contains time zone and date time informations.
+*/
+struct WorldTimeAPIResult {
+	WorldTimeAPIResult() {
+		clear();
+	}
+
+	/**
+	* @brief Current date time, time zone offset and DST adjustment.
+	*/
+	DateTimeTZSysSync datetime;
+
+	/**
+	* @brief Unix time of beginning of DST period returned by API or 0 if time zone has no DST.
+	*/
+	int64_t dstFrom;
+
+	/**
+	* @brief Unix time of end of DST period returned by API or 0 if time zone has no DST.
+	*/
+	int64_t dstUntil;
+
+	/**
+	* @brief Standard offset from UTC in seconds.
+	*/
+	int32_t rawOffset;
+
+	/**
+	* @brief Client public IPv4 address, first octet in most significant byte. 0 if unknown.
+	* See client_ip().
+	*/
+	uint32_t clientIP;
+
+	/**
+	* @brief HTTP code of operation.
+	*/
+	WorldTimeAPI_HttpCode httpCode;
+
+	/**
+	* @brief DST offset in seconds or 0 if time zone has no DST.
+	*/
+	int16_t dstOffset;
+
+	/**
+	* @brief ID of Olson time zone name in WorldTimeAPIIntern::global(). See timezone().
+	*/
+	uint16_t timezoneId;
+
+	/**
+	* @brief ID of error returned by WorldTimeAPI in WorldTimeAPIErrors::global(). See error().
+	*/
+	uint16_t errorId;
+
+	/**
+	* @brief Abbreviation name of time zone.
+	*/
+	char abbreviation[WTAPI_TZ_ABR_NAME_SIZE];
+
+	/**
+	* @brief True if DST was applied when result was read.
+	*/
+	bool wasDST;
+
+	/**
+	* @brief True if result was served from cache after its freshness window, because it is being
+	* refreshed or WorldTimeAPI is failing. See setCache().
+	*/
+	bool stale;
+
+	/**
+	* @brief Olson time zone name. IANA database identifier.
+	*/
+	inline const char* timezone() const {
+		return WorldTimeAPIIntern::global().get(timezoneId);
+	}
+
+	/**
+	* @brief Error returned by WorldTimeAPI or empty string.
+	*/
+	inline const char* error() const {
+		return WorldTimeAPIErrors::global().get((uint8_t)errorId);
+	}
+
+#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+	/**
+	* @brief Client public IPv4 IP address. On ESP32 and ESP8266 with arduino core
+	* IP address is represented by IPAddress class.
+	*/
+	inline IPAddress client_ip() const {
+		return IPAddress((uint8_t)(clientIP >> 24), (uint8_t)(clientIP >> 16), (uint8_t)(clientIP >> 8), (uint8_t)clientIP);
+	}
+#elif defined(ARDUINO)
+	/**
+	* @brief Client public IPv4 IP address represented by string.
+	*/
+	inline String client_ip() const {
+		char buffer[WTAPI_TZ_CLIENT_IP_SIZE];
+		clientIPToString(buffer, WTAPI_TZ_CLIENT_IP_SIZE);
+		return String(buffer);
+	}
+#else
+	/**
+	* @brief Client public IPv4 IP address represented by string.
+	*/
+	inline std::string client_ip() const {
+		char buffer[WTAPI_TZ_CLIENT_IP_SIZE];
+		clientIPToString(buffer, WTAPI_TZ_CLIENT_IP_SIZE);
+		return std::string(buffer);
+	}
+#endif // defined(ESP8266) || defined(ESP32)
+
+	/**
+	* @brief Writes client IP address in dotted form, empty string if address is unknown.
+	* @param buffer Buffer with size at least WTAPI_TZ_CLIENT_IP_SIZE.
+	* @param bufferSize Size of buffer.
+	* @return Returns count of written characters.
+	*/
+	int clientIPToString(char* buffer, int bufferSize) const;
+
+	/**
+	* @brief True if current response is not valid.
+	*/
+	inline bool hasError() const {
+		return httpCode != WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK;
+	}
+
+	/**
+	* @brief Clears result.
+	*/
+	void clear();
+
+	/**
+	* @brief Converts this result to tome zone informations.
+	*/
+	TimeZoneInfo toTimeZoneInfo() const;
+};
+
+
+/**
+* @class WorldTimeAPI
+* @brief This class represent client side of <a href="http://worldtimeapi.org/">WorldTimeAPI</a>.
+* 
+* > WorldTimeAPI is a simple web service which returns the current local time for a given timezone as either plain-text or JSON.
+*/
+class WorldTimeAPITransport;
+class WorldTimeAPIResponse;
+
+class WorldTimeAPI
+{
+public:
+	/**
+	* @brief Creates client.
+	* @param transport Transport, which sends requests, see WorldTimeAPITransport.h. If NULL, default transport
+	* is used (curl on OS, HTTPClient on ESP8266 and ESP32). Transport has to exist while client is used.
+	*/
+	WorldTimeAPI(WorldTimeAPITransport* transport = NULL);
+
+	/**
+	* @brief Waits until background refreshes of cached results finish and frees receive buffers.
+	*/
+	~WorldTimeAPI();
+
+#ifdef ARDUINO/**
+	* @brief Gets list of accepted olson time zones.
+	* @warning This method can return string with size up to 7kB, which may use all RAM memory on microcontrollers.
+	* Overload with WorldTimeAPI_TimeZoneCallback processes list while it is received, without storing it.
+	* @param[out] list Out parameter, which will contain list of all accepted time zones separated by "\r\n".
+	* @param[in] tz Part olson time zone, for example to list all time zones in Europe,
+	* set it to: "Europe" and it will returns: "Europe/Amsterdam","Europe/Andorra","Europe/Astrakhan", ...
+	* If set to NULL, all supported time zones are retrieved.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode getListOfTimeZones(String& list, const char* tz = NULL);
+#else
+	/**
+	* @brief Gets list of accepted olson time zones.
+	* @param[out] list Out parameter, which will contain list of all accepted time zones separated by "\r\n".
+	* @param[in] tz Part olson time zone, for example to list all time zones in Europe,
+	* set it to: "Europe" and it will returns: "Europe/Amsterdam","Europe/Andorra","Europe/Astrakhan", ...
+	* If set to NULL, all supported time zones are retrieved.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode getListOfTimeZones(std::string& list, const char* tz = NULL);
+#endif // ARDUINO
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+	/**
+	* @brief Gets list of accepted olson time zones without storing whole list. Response is processed
+	* while it is received and callback is called for every time zone name, so memory usage does not depend
+	* on size of list.
+	* @param[in] onTimeZoneName Callback called for every matching time zone name. When it returns false,
+	* receiving is stopped and connection is closed.
+	* @param[in] owner Pointer passed to callback.
+	* @param[in] prefix Only names starting with prefix are passed to callback, for example: "Europe/B".
+	* If prefix contains area (part before '/'), only that area is requested. If NULL, all names are passed.
+	* @return Returns HTTP code of result. WTA_HTTP_CODE_OK is returned also when callback stopped receiving.
+	*/
+	WorldTimeAPI_HttpCode getListOfTimeZones(WorldTimeAPI_TimeZoneCallback onTimeZoneName, void* owner = NULL, const char* prefix = NULL);
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+	/**
+	* @brief Gets time zone informations by time zone name.
+	* @param[in] tz Olson time zone name, for example: "Europe/Amsterdam".
+	* If only partial time zone is specified (for example: "Europe"), http code will be set to
+	* WTA_ERROR_PARTIAL_TIMEZONE, because API returned list of accepted time zones instead of time
+	* zone info. To get that list, call getListOfTimeZones();
+	* @return Returns constant reference to result.
+	* @note When library is thread safe (OS and ESP32), reference points to published result, see getLastResult().
+	* It is not changed by the next lookup, but it is rewritten by the one after it. When more threads use this client,
+	* use overload with caller's result instead.
+	*/
+	const WorldTimeAPIResult& getByTimeZone(const char* tz);
+
+	/**
+	* @brief Gets time zone informations by time zone name and copies them to caller's result.
+	* When request for the same time zone is already in progress (from another thread), no new request
+	* is sent and result of that request is copied instead.
+	* @param[in] tz Olson time zone name, for example: "Europe/Amsterdam".
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] timeout Time in milliseconds for whole request (including connecting, sending and receiving).
+	* If set to 0, default timeout of client is used, see setTimeout().
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode getByTimeZone(const char* tz, WorldTimeAPIResult& result, uint32_t timeout = 0);
+
+	/**
+	* @brief Gets time zone informations from full URL of API, for example: "http://worldtimeapi.org/api/ip/185.142.49.50.txt".
+	* Format of response is given by extension. Cache of client is used the same way as by getByTimeZone() and getByIP().
+	* @param[in] url URL of request.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] timeout Time in milliseconds for whole request. If set to 0, default timeout of client is used.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode getByURL(const char* url, WorldTimeAPIResult& result, uint32_t timeout = 0);
+
+#ifdef WTAPI_TZ_TABLE
+	/**
+	* @brief Gets time zone informations by time zone ID. See getByTimeZone(const char*).
+	* @param[in] tz ID of time zone, for example: WorldTimeAPI_TzId::Europe_Amsterdam.
+	* @return Returns constant reference to result. Http code is WTA_ERROR_ARGUMENT_ERROR if ID is invalid.
+	* @note See note of getByTimeZone(const char*) about thread safety of returned reference.
+	*/
+	const WorldTimeAPIResult& getByTimeZone(WorldTimeAPI_TzId tz);
+
+	/**
+	* @brief Gets time zone informations by time zone ID and copies them to caller's result.
+	* See getByTimeZone(const char*, WorldTimeAPIResult&, uint32_t).
+	* @param[in] tz ID of time zone, for example: WorldTimeAPI_TzId::Europe_Amsterdam.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] timeout Time in milliseconds for whole request. If set to 0, default timeout of client is used.
+	* @return Returns HTTP code of result. WTA_ERROR_ARGUMENT_ERROR is returned without sending request if ID is invalid.
+	*/
+	WorldTimeAPI_HttpCode getByTimeZone(WorldTimeAPI_TzId tz, WorldTimeAPIResult& result, uint32_t timeout = 0);
+#endif // WTAPI_TZ_TABLE
+
+	/**
+	* @brief Gets time zone informations by public IP address.
+	* @param[in] IP Text with valid IPv4 address. If set to null, current public IP address is used.
+	* @note Only IPv4 addresses are supported.
+	* @return Returns constant reference to result.
+	* @note When library is thread safe (OS and ESP32), reference points to published result, see getLastResult().
+	* It is not changed by the next lookup, but it is rewritten by the one after it. When more threads use this client,
+	* use overload with caller's result instead.
+	*/
+	const WorldTimeAPIResult& getByIP(const char* IP = NULL);
+
+	/**
+	* @brief Gets time zone informations by public IP address and copies them to caller's result.
+	* When request for the same IP address is already in progress (from another thread), no new request
+	* is sent and result of that request is copied instead.
+	* @param[in] IP Text with valid IPv4 address. If set to null, current public IP address is used.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] timeout Time in milliseconds for whole request (including connecting, sending and receiving).
+	* If set to 0, default timeout of client is used, see setTimeout().
+	* @note Only IPv4 addresses are supported.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode getByIP(const char* IP, WorldTimeAPIResult& result, uint32_t timeout = 0);
+
+#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+	/**
+	* @brief Gets time zone informations by public IP address.
+	* @param[in] IP Valid IPv4 address.
+	* @note Only IPv4 addresses are supported.
+	* @return Returns constant reference to result.
+	* @note When library is thread safe (OS and ESP32), reference points to published result, see getLastResult().
+	* It is not changed by the next lookup, but it is rewritten by the one after it. When more threads use this client,
+	* use overload with caller's result instead.
+	*/
+	const WorldTimeAPIResult& getByIP(const IPAddress& IP);
+
+	/**
+	* @brief Gets time zone informations by public IP address and copies them to caller's result.
+	* @param[in] IP Valid IPv4 address.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] timeout Time in milliseconds for whole request. If set to 0, default timeout of client is used.
+	* @note Only IPv4 addresses are supported.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode getByIP(const IPAddress& IP, WorldTimeAPIResult& result, uint32_t timeout = 0);
+#endif // !SJSONP_UNDER_OS
+
+#ifdef WTAPI_THREAD_SAFE
+	/**
+	* @brief Gets copy of last result from getByIP() or getByTimeZone() method. It can be called from
+	* any thread, while another thread calls getByIP() or getByTimeZone(). Result is always consistent,
+	* because it is published only after it was completely written. No mutex is locked by reader.
+	*/
+	WorldTimeAPIResult getLastResult() const;
+
+	/**
+	* @brief Copies last result from getByIP() or getByTimeZone() method to caller's result.
+	* @see getLastResult()
+	*/
+	void getLastResult(WorldTimeAPIResult& result) const;
+#else
+	/**
+	* @brief Gets last result from getByIP() or getByTimeZone() method.
+	*/
+	inline const WorldTimeAPIResult& getLastResult() const{
+		return lastRes;
+	}
+#endif // WTAPI_THREAD_SAFE
+
+	/**
+	* @brief Limits rate of requests sent by this client. Limit is shared by all threads using this client.
+	* @param requestsPerSecond Maximal count of requests per second. If set to 0, rate is not limited (default).
+	* @param burst Maximal count of requests, that can be sent at once.
+	*/
+	void setRateLimit(float requestsPerSecond, uint16_t burst = 1);
+
+	/**
+	* @brief Sets retry policy for throttled responses (429 - Too many requests and 503 - Service unavailable).
+	* After throttled response, all requests of this client are delayed by time from Retry-After header or by
+	* exponential backoff with jitter (whichever is longer).
+	* @param maxRetries Maximal count of retries of one request. Default is 0, so request is not retried.
+	* @param baseDelay Backoff after first throttled response in milliseconds. Default is 500 ms.
+	* @param maxDelay Maximal backoff in milliseconds. Default is 60 s.
+	*/
+	void setRetryPolicy(uint8_t maxRetries, uint32_t baseDelay = 500, uint32_t maxDelay = 60000);
+
+	/**
+	* @brief Sets maximal time, which request can wait for rate limiter or backoff. When request would
+	* have to wait longer, it is not sent and WTA_HTTP_CODE_TOO_MANY_REQUESTS is returned immediately.
+	* @param maxWait Maximal waiting time in milliseconds. Default is 2000 ms.
+	*/
+	inline void setMaxThrottleWait(uint32_t maxWait) {
+		maxThrottleWait = maxWait;
+	}
+
+	/**
+	* @brief Sets default timeout of requests. Timeout covers whole request including connecting, sending,
+	* receiving and waiting for rate limiter.
+	* @param timeout_ Timeout in milliseconds. Default is 1000 ms on microcontrollers and 10000 ms on OS.
+	*/
+	inline void setTimeout(uint32_t timeout_) {
+		if (timeout_ > 0) timeout = timeout_;
+	}
+
+	/**
+	* @brief Sets format of responses requested by getByTimeZone() and getByIP().
+	* @param format_ Format of response. Default is WTA_FORMAT_JSON.
+	*/
+	inline void setFormat(WorldTimeAPI_Format format_) {
+		format = format_;
+	}
+
+	/**
+	* @brief Parses response of WorldTimeAPI, which was already received.
+	* @param[in] body Body of response.
+	* @param[in] bodyLength Length of body.
+	* @param[in] format Format of response.
+	* @param[out] result Parsed result.
+	* @param[in] httpCode HTTP code of response.
+	* @param[in] trusted True if body comes from trusted source, JSON is then parsed with SimpleJSONTrusted policy.
+	* @return Returns HTTP code of result.
+	*/
+	static WorldTimeAPI_HttpCode parseResponse(const char* body, int bodyLength, WorldTimeAPI_Format format, WorldTimeAPIResult& result,
+		WorldTimeAPI_HttpCode httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK, bool trusted = false);
+
+	/**
+	* @brief Base URL of API: "http://worldtimeapi.org/api". It is replaced by URL of endpoint, see setEndpoints().
+	*/
+	static const char* URL_Base;
+
+	/**
+	* @brief Base URL of time zone requests: "http://worldtimeapi.org/api/timezone".
+	*/
+	static const char* URL_TimeZone;
+
+	/**
+	* @brief Base URL of IP requests: "http://worldtimeapi.org/api/ip".
+	*/
+	static const char* URL_IP;
+
+	/**
+	* @brief Sets cache of resolved addresses of API host. By default, cache shared by all clients is used.
+	* @param cache Cache of resolved addresses or NULL to disable caching. Cache has to exist until
+	* this client is destroyed.
+	*/
+	inline void setDNSCache(WorldTimeAPIDNSCache* cache) {
+		dnsCache = cache;
+	}
+
+	/**
+	* @brief Sets transport, which sends requests. Waits until hedged requests sent by previous transport
+	* finish, so previous transport can be destroyed after return.
+	* @param transport_ Transport or NULL to use default transport. Transport has to exist until it is replaced
+	* or this client is destroyed.
+	*/
+	void setTransport(WorldTimeAPITransport* transport_);
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+	/**
+	* @brief Sets initial size of arena, from which each request takes memory for received response.
+	* Arena is reset after each lookup and grows to the largest response seen (up to WTAPI_ARENA_MAX_SIZE),
+	* so steady-state lookups use one block without allocations. Default is WTAPI_ARENA_SIZE.
+	* @param size Size of arena in bytes. Arenas of idle requests are resized by their next reset.
+	*/
+	void setArenaSize(size_t size);
+
+	/**
+	* @brief Gets the highest count of bytes used by one request from arena since last setArenaSize().
+	* It can be used to choose size of arena.
+	*/
+	inline size_t getArenaHighWater() const {
+		return arenaHighWater;
+	}
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#ifdef WTAPI_ENDPOINTS
+	/**
+	* @brief Sets endpoints (mirrors or proxies of API), to which requests are sent. Requests for URLs starting
+	* with URL_Base are sent to fastest healthy endpoint and when it fails, next endpoint is tried until
+	* timeout of request expires. Cached results are still keyed by original URL. Disabled by default.
+	* @param endpoints_ Endpoints or NULL to send requests only to URL_Base. Endpoints can be shared by multiple
+	* clients and they have to exist until they are used by this client.
+	*/
+	inline void setEndpoints(WorldTimeAPIEndpoints* endpoints_) {
+		endpoints = endpoints_;
+	}
+#endif // WTAPI_ENDPOINTS
+
+#ifdef WTAPI_IP_CACHE
+	/**
+	* @brief Sets cache of time zones of IPv4 networks used by getByIP(). When address is from network,
+	* which was already learned, result is created from cache without request. Disabled by default.
+	* Cache can be shared by multiple clients.
+	* @param cache Cache or NULL to disable it. Cache has to exist until it is used by this client.
+	* @note Client's own address (getByIP() without argument) is never cached.
+	*/
+	inline void setIPCache(WorldTimeAPIIPCache* cache) {
+		ipCache = cache;
+	}
+#endif // WTAPI_IP_CACHE
+
+	/**
+	* @brief Sets source of time zone informations for getByTimeZone(). Local tzdata is available only
+	* on unix-like systems, on other platforms WorldTimeAPI is always requested.
+	* @param source Source of time zone informations. Default is WTA_TZ_SOURCE_NETWORK.
+	* @note Results from local tzdata have empty client_ip. Directory of tzdata can be changed by
+	* WorldTimeAPITZif::global().setDirectory().
+	*/
+	inline void setTimeZoneSource(WorldTimeAPI_TZSource source) {
+		tzSource = source;
+	}
+
+	/**
+	* @brief Sets circuit breaker. After given count of failures in a row (connection errors, timeouts
+	* and 5xx responses), no requests are sent for cool-down period and WTA_ERROR_CIRCUIT_OPEN is returned
+	* immediately (or stale result, if cache is enabled). After cool-down, one probe request is sent.
+	* @param threshold Count of failures in a row, which opens breaker. If set to 0, breaker is disabled (default).
+	* @param coolDown Time in milliseconds, for which breaker stays open. Default is 30 s.
+	*/
+	inline void setCircuitBreaker(uint8_t threshold, uint32_t coolDown = 30000) {
+		breaker.setThreshold(threshold, coolDown);
+	}
+
+#ifdef WTAPI_THREAD_SAFE
+	/**
+	* @brief Enables caching of results of getByTimeZone() and getByIP() (stale-while-revalidate).
+	* Result is served from cache while it is fresh. After that, it is still served (with stale flag set)
+	* for maxStale time, while one refresh is running. On OS, refresh runs in background thread, on ESP32
+	* refresh is done by first caller, which finds result stale, and other callers get stale result meanwhile.
+	* When refresh fails, stale result is served until maxStale elapses.
+	* @param maxAge Time in milliseconds, for which result is fresh. If set to 0, cache is disabled (default).
+	* @param maxStale Time in milliseconds after freshness window, for which stale result can be served.
+	* @note Time in cached results is still synchronized with system time, only time zone informations may be outdated.
+	*/
+	void setCache(uint32_t maxAge, uint32_t maxStale = 3600000);
+
+	/**
+	* @brief Removes all cached results.
+	*/
+	void clearCache();
+#endif // WTAPI_THREAD_SAFE
+
+#ifdef WTAPI_HEDGING
+	/**
+	* @brief Enables sending of hedged requests. When response is not received until given percentile of
+	* recent response times, the same request is sent again over second connection and whichever response
+	* comes first is used. Hedged request is sent only if rate limiter allows it without waiting.
+	* @param percentile Percentile of response times (for example 0.95), after which hedged request is sent.
+	* If set to 0, hedging is disabled (default).
+	* @param minDelay Minimal time in milliseconds before hedged request is sent.
+	* @note Hedging starts after 16 response times are measured.
+	*/
+	void setHedging(float percentile, uint32_t minDelay = 50);
+#endif // WTAPI_HEDGING
+
+	/**
+	* @brief Parses IPv4 address in dotted form.
+	* @param[in] text Null terminated address, for example: "185.142.49.50".
+	* @param[out] address Address, first octet in most significant byte.
+	* @return Returns true if address was parsed.
+	*/
+	static bool parseIPv4(const char* text, uint32_t& address);
+
+	/**
+	* @brief Parses value of Retry-After header.
+	* @param value Value of header.
+	* @param valueLength Length of value.
+	* @return Returns count of seconds or 0 if value is not valid count of seconds (HTTP dates are not supported).
+	*/
+	static uint32_t parseRetryAfter(const char* value, int valueLength);
+
+#ifdef WTAPI_COUNT_ALLOCATIONS
+	/**
+	* @brief Gets count of allocations done by operator new since start of program. It is available only when
+	* library is compiled with -DWTAPI_COUNT_ALLOCATIONS, which replaces global operator new, so allocations done
+	* by one lookup can be counted as difference of two values.
+	* @note Memory allocated by malloc() (for example by String on Arduino) is not counted.
+	*/
+	static uint32_t getAllocationCount();
+#endif // WTAPI_COUNT_ALLOCATIONS
+
+#ifdef WTAPI_COROUTINES
+	/**
+	* @struct ListResult
+	* @brief Result of getListOfTimeZonesAsync().
+	*/
+	struct ListResult {
+		WorldTimeAPI_HttpCode httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+		std::string list;
+	};
+
+	/**
+	* @brief Gets time zone informations by time zone name without blocking calling thread (C++20).
+	* Request is run by getByTimeZone() in thread of io service, see WorldTimeAPIIOService.
+	* Usage: WorldTimeAPIResult res = co_await api.getByTimeZoneAsync("Europe/Bratislava");
+	* @param tz Olson time zone name. See getByTimeZone().
+	* @param executor Executor, which resumes coroutine. If empty, coroutine is resumed by thread of io service.
+	* @param io Service running requests.
+	* @return Returns awaitable result.
+	* @note Client has to exist until awaitable is finished.
+	*/
+	inline WorldTimeAPIAwaitable<WorldTimeAPIResult> getByTimeZoneAsync(const char* tz, WorldTimeAPIExecutor executor = WorldTimeAPIExecutor(),
+		WorldTimeAPIIOService& io = WorldTimeAPIIOService::global()) {
+		std::string name = tz != NULL ? tz : "";
+		bool valid = tz != NULL;
+		return WorldTimeAPIAwaitable<WorldTimeAPIResult>([this, name, valid]() {
+			WorldTimeAPIResult result;
+			getByTimeZone(valid ? name.c_str() : NULL, result);
+			return result;
+		}, std::move(executor), io);
+	}
+
+	/**
+	* @brief Gets time zone informations by public IP address without blocking calling thread (C++20).
+	* Request is run by getByIP() in thread of io service, see WorldTimeAPIIOService.
+	* @param IP IP address or NULL to get informations of client's public IP. See getByIP().
+	* @param executor Executor, which resumes coroutine. If empty, coroutine is resumed by thread of io service.
+	* @param io Service running requests.
+	* @return Returns awaitable result.
+	*/
+	inline WorldTimeAPIAwaitable<WorldTimeAPIResult> getByIPAsync(const char* IP = NULL, WorldTimeAPIExecutor executor = WorldTimeAPIExecutor(),
+		WorldTimeAPIIOService& io = WorldTimeAPIIOService::global()) {
+		std::string address = IP != NULL ? IP : "";
+		bool hasIP = IP != NULL;
+		return WorldTimeAPIAwaitable<WorldTimeAPIResult>([this, address, hasIP]() {
+			WorldTimeAPIResult result;
+			getByIP(hasIP ? address.c_str() : NULL, result);
+			return result;
+		}, std::move(executor), io);
+	}
+
+	/**
+	* @brief Gets list of accepted olson time zones without blocking calling thread (C++20).
+	* Request is run by getListOfTimeZones() in thread of io service, see WorldTimeAPIIOService.
+	* @param tz Part of olson time zone or NULL. See getListOfTimeZones().
+	* @param executor Executor, which resumes coroutine. If empty, coroutine is resumed by thread of io service.
+	* @param io Service running requests.
+	* @return Returns awaitable list.
+	*/
+	inline WorldTimeAPIAwaitable<ListResult> getListOfTimeZonesAsync(const char* tz = NULL, WorldTimeAPIExecutor executor = WorldTimeAPIExecutor(),
+		WorldTimeAPIIOService& io = WorldTimeAPIIOService::global()) {
+		std::string part = tz != NULL ? tz : "";
+		bool hasTZ = tz != NULL;
+		return WorldTimeAPIAwaitable<ListResult>([this, part, hasTZ]() {
+			ListResult result;
+			result.httpCode = getListOfTimeZones(result.list, hasTZ ? part.c_str() : NULL);
+			return result;
+		}, std::move(executor), io);
+	}
+#endif // WTAPI_COROUTINES
+
+protected:
+
+#ifdef WTAPI_THREAD_SAFE
+	/**
+	* @brief Publishes last result for readers of getLastResult().
+	* Result is written to buffer, which is not visible to readers, and then buffers are swapped.
+	* @return Returns published buffer.
+	*/
+	const WorldTimeAPIResult& publishLastResult(const WorldTimeAPIResult& result);
+
+	/**
+	* @brief Published last results. Readers read buffer given by lastResIndex.
+	*/
+	WorldTimeAPIResult lastResBuffers[2];
+
+	/**
+	* @brief Index of buffer with published result.
+	*/
+	std::atomic<uint8_t> lastResIndex{ 0 };
+
+	/**
+	* @brief Count of readers of each buffer. Buffer is rewritten only when it has no readers.
+	*/
+	mutable std::atomic<uint16_t> lastResReaders[2] = { {0}, {0} };
+
+	/**
+	* @brief Mutex guarding writers of last result.
+	*/
+	std::mutex lastResMutex;
+#else
+	/**
+	* @brief Last result from getByIP() or getByTimeZone() method.
+	*/
+	WorldTimeAPIResult lastRes;
+#endif // WTAPI_THREAD_SAFE
+
+	/**
+	* @brief Rate limiter and backoff shared by all requests of this client.
+	*/
+	WorldTimeAPIRateLimiter limiter;
+
+	/**
+	* @brief Maximal count of retries of throttled request.
+	*/
+	uint8_t maxRetries = 0;
+
+	/**
+	* @brief Maximal time in milliseconds, which request can wait for rate limiter.
+	*/
+	uint32_t maxThrottleWait = 2000;
+
+	/**
+	* @brief Format of requested responses.
+	*/
+	WorldTimeAPI_Format format = WorldTimeAPI_Format::WTA_FORMAT_JSON;
+
+	/**
+	* @brief Cache of resolved addresses of API host.
+	*/
+	WorldTimeAPIDNSCache* dnsCache = &WorldTimeAPIDNSCache::global();
+
+	/**
+	* @brief Transport, which sends requests. NULL if platform has no transport.
+	*/
+	WorldTimeAPITransport* transport;
+
+#ifdef WTAPI_ENDPOINTS
+	/**
+	* @brief Endpoints of API or NULL if only URL_Base is used.
+	*/
+	WorldTimeAPIEndpoints* endpoints = NULL;
+
+	/**
+	* @brief Sends GET request to endpoints. If endpoint fails, another one is tried until deadline.
+	* @param[in] url URL of request.
+	* @param[out] resp Response.
+	* @param[in] deadline Time (from WorldTimeAPIClock), until which response has to be received.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode failoverGET(const char* url, WorldTimeAPIResponse& resp, uint32_t deadline);
+#endif // WTAPI_ENDPOINTS
+
+#ifdef WTAPI_IP_CACHE
+	/**
+	* @brief Cache of time zones of IPv4 networks or NULL if disabled.
+	*/
+	WorldTimeAPIIPCache* ipCache = NULL;
+#endif // WTAPI_IP_CACHE
+
+	/**
+	* @brief Source of time zone informations.
+	*/
+	WorldTimeAPI_TZSource tzSource = WorldTimeAPI_TZSource::WTA_TZ_SOURCE_NETWORK;
+
+	/**
+	* @brief Circuit breaker shared by all requests of this client.
+	*/
+	WorldTimeAPICircuitBreaker breaker;
+
+	/**
+	* @brief Default timeout of requests in milliseconds.
+	*/
+#if defined(SJSONP_UNDER_OS)
+	uint32_t timeout = 10000;
+#else
+	uint32_t timeout = 1000;
+#endif // SJSONP_UNDER_OS
+
+	/**
+	* @brief Gets time zone informations from given URL. If cache is enabled, cached result may be used.
+	* @param[in] url URL of request.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] timeout Timeout of request in milliseconds, 0 for default timeout.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode fetchTZ(const char* url, WorldTimeAPIResult& result, uint32_t timeout);
+
+	/**
+	* @brief Gets time zone informations from given URL. Concurrent requests to the same URL are
+	* coalesced, so only one request is sent and all callers receive copy of its result.
+	* @param[in] url URL of request.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] timeout Timeout of request in milliseconds, 0 for default timeout.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode fetchShared(const char* url, WorldTimeAPIResult& result, uint32_t timeout);
+
+	/**
+	* @brief Sends request to given URL and parses response.
+	* @param[in] url URL of request.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @param[in] deadline Time (from WorldTimeAPIClock), until which response has to be received.
+	*/
+	void getAndParseTZ(const char* url, WorldTimeAPIResult& result, uint32_t deadline);
+
+	/**
+	* @brief Gets time remaining until deadline in milliseconds or 0 if deadline passed.
+	*/
+	static inline uint32_t remaining(uint32_t deadline) {
+		uint32_t now = WorldTimeAPIClock::now();
+		return WorldTimeAPIClock::isBefore(now, deadline) ? deadline - now : 0;
+	}
+
+	static bool jsonItemTZ(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr);
+
+	static bool jsonTextTZ(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr);
+
+	static bool jsonControlTZ(JSONItemType type, const char* key, int keyLength, int depth, int index, void* owner_ptr);
+
+	static bool jsonItemERR(JSONItemType type, const char* key, int keyLength, const SimpleJSONTextParser::Number& parsedVal, int depth, int index, void* owner_ptr);
+
+	static bool jsonTextERR(const char* key, int keyLength, const char* value, int valueLength, int depth, int index, void* owner_ptr);
+
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+	/**
+	* @brief Sends GET request through rate limiter. Throttled requests are retried by retry policy.
+	* @param[in] url URL of request.
+	* @param[out] resp Response, its receive buffer is reused.
+	* @param[in] deadline Time (from WorldTimeAPIClock), until which response has to be received.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode throttledGET(const char* url, WorldTimeAPIResponse& resp, uint32_t deadline);
+
+	/**
+	* @brief Sends GET request. If hedging is enabled, duplicate request may be sent.
+	* @param[in] url URL of request.
+	* @param[out] resp Response, its receive buffer is reused.
+	* @param[in] timeout Timeout of request in milliseconds.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode sendGET(const char* url, WorldTimeAPIResponse& resp, uint32_t timeout);
+
+	/**
+	* @brief Takes idle receive buffer of this client or creates new one. Buffers are reused by next
+	* requests, so they do not have to grow again.
+	*/
+	WorldTimeAPIResponse* acquireResponse();
+
+	/**
+	* @brief Returns receive buffer taken by acquireResponse().
+	*/
+	void releaseResponse(WorldTimeAPIResponse* response);
+
+#ifdef WTAPI_THREAD_SAFE
+	/**
+	* @brief Mutex guarding idle receive buffers.
+	*/
+	std::mutex responsesMutex;
+
+	/**
+	* @brief Idle receive buffers. Each request in progress uses its own buffer.
+	*/
+	std::vector<WorldTimeAPIResponse*> idleResponses;
+#else
+	/**
+	* @brief Receive buffer, created by first request.
+	*/
+	WorldTimeAPIResponse* response = NULL;
+#endif // WTAPI_THREAD_SAFE
+
+	size_t arenaSize = WTAPI_ARENA_SIZE;
+	size_t arenaHighWater = 0;
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+	/**
+	* @brief Sends GET request through rate limiter like throttledGET(), but body of successful response
+	* is passed to callback while it is received. Hedging is not used.
+	* @param[in] url URL of request.
+	* @param[in] onChunk Callback, which receives parts of body.
+	* @param[in] owner Pointer passed to callback.
+	* @param[in] deadline Time (from WorldTimeAPIClock), until which response has to be received.
+	* @return Returns HTTP code of result.
+	*/
+	WorldTimeAPI_HttpCode throttledStream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t deadline);
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+
+#ifdef WTAPI_THREAD_SAFE
+	/**
+	* @struct Flight
+	* @brief Request, which is currently in progress. Other callers requesting the same URL waits for it.
+	*/
+	struct Flight {
+		char url[WTAPI_URL_SIZE];
+		uint16_t users = 0; //Sender and waiting callers, slot is free when it is 0
+		bool done = false;
+		WorldTimeAPIResult result;
+		std::condition_variable cv;
+	};
+
+	/**
+	* @brief Mutex guarding flights.
+	*/
+	std::mutex flightsMutex;
+
+	/**
+	* @brief Slots of requests in progress. When all slots are used, request is sent without sharing.
+	*/
+	Flight flights[WTAPI_MAX_FLIGHTS];
+
+	/**
+	* @struct URLLess
+	* @brief Compares URLs, so cache can be searched by const char* without creating std::string.
+	*/
+	struct URLLess {
+		typedef void is_transparent;
+
+		inline bool operator()(const std::string& a, const std::string& b) const {
+			return a < b;
+		}
+
+		inline bool operator()(const std::string& a, const char* b) const {
+			return a.compare(b) < 0;
+		}
+
+		inline bool operator()(const char* a, const std::string& b) const {
+			return b.compare(a) > 0;
+		}
+	};
+
+	/**
+	* @struct CacheEntry
+	* @brief Cached result of one URL.
+	*/
+	struct CacheEntry {
+		WorldTimeAPIResult result;
+		uint32_t fetchedAt = 0;
+		bool refreshing = false;
+	};
+
+	/**
+	* @brief Stores successful result to cache.
+	*/
+	void storeTZ(const char* url, const WorldTimeAPIResult& result);
+
+	/**
+	* @brief Requests URL again and updates cache.
+	* @param[in] url URL of request.
+	* @param[out] fresh New result.
+	*/
+	void refreshTZ(const char* url, WorldTimeAPIResult& fresh);
+
+	/**
+	* @brief Time in milliseconds, for which cached result is fresh. 0 if cache is disabled.
+	*/
+	uint32_t cacheMaxAge = 0;
+
+	/**
+	* @brief Time in milliseconds after freshness window, for which stale result can be served.
+	*/
+	uint32_t cacheMaxStale = 0;
+
+	/**
+	* @brief Mutex guarding cache.
+	*/
+	std::mutex cacheMutex;
+
+	/**
+	* @brief Cached results by URL.
+	*/
+	std::map<std::string, CacheEntry, URLLess> cache;
+#endif // WTAPI_THREAD_SAFE
+
+#ifdef WTAPI_BACKGROUND_REFRESH
+	/**
+	* @brief Starts refresh of cached result in background thread.
+	*/
+	void startRefresh(const char* url);
+
+	/**
+	* @brief Count of running background refreshes.
+	*/
+	uint16_t refreshCount = 0;
+
+	/**
+	* @brief Signaled, when background refresh finishes.
+	*/
+	std::condition_variable refreshDone;
+#endif // WTAPI_BACKGROUND_REFRESH
+
+#ifdef WTAPI_HEDGING
+	/**
+	* @struct Hedge
+	* @brief Shared state of primary and hedged request. Request, which was not used, finishes in background.
+	*/
+	struct Hedge {
+		std::mutex mutex;
+		std::condition_variable cv;
+		uint8_t sent = 0;
+		uint8_t finished = 0;
+		bool done = false;
+		WorldTimeAPI_HttpCode httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+		std::string resp;
+		uint32_t retryAfter = 0;
+		uint32_t startTime = 0;
+	};
+
+	/**
+	* @brief Starts request of hedge in new thread. Thread is counted by hedgeCount until it finishes.
+	*/
+	void startHedged(const std::shared_ptr<Hedge>& hedge, const std::string& url, uint32_t timeout, WorldTimeAPIDNSCache* dns,
+		WorldTimeAPITransport* transport);
+
+	/**
+	* @brief Waits until all hedged requests finish, including requests, which lost.
+	*/
+	void waitForHedges();
+
+	/**
+	* @brief Adds response time to latency samples.
+	*/
+	void addLatencySample(uint32_t latency);
+
+	/**
+	* @brief Gets time in milliseconds after which hedged request is sent or 0 if hedging is disabled.
+	*/
+	uint32_t getHedgeDelay();
+
+	static const uint8_t LATENCY_SAMPLES = 64;
+
+	std::mutex latencyMutex;
+	uint32_t latencySamples[LATENCY_SAMPLES];
+	uint8_t latencyCount = 0;
+	uint8_t latencyPos = 0;
+	float hedgePercentile = 0;
+	uint32_t hedgeMinDelay = 50;
+
+	/**
+	* @brief Mutex guarding hedgeCount.
+	*/
+	std::mutex hedgeMutex;
+
+	/**
+	* @brief Count of running threads of hedged requests.
+	*/
+	uint16_t hedgeCount = 0;
+
+	/**
+	* @brief Signaled, when thread of hedged request finishes.
+	*/
+	std::condition_variable hedgeDone;
+#endif // WTAPI_HEDGING
+
+
+
+	class WorldTimeAPIResHelper {
+	public:
+		WorldTimeAPIResHelper(WorldTimeAPIResult* result_ptr_) : result_ptr(result_ptr_)
+		{}
+
+		/**
+		* @struct FFlags
+		* @brief Structure, which represents found flags.
+		*/
+		struct FFlags {
+
+			FFlags() :
+				abbreviation_found(false),
+				client_ip_found(false),
+				dst_found(false),
+				dst_from_found(false),
+				dst_offset_found(false),
+				dst_until_found(false),
+				raw_offset_found(false),
+				timezone_found(false),
+				unixtime_found(false),
+				error_found(false)
+			{}
+
+			FFlags(uint16_t raw) {
+				const FFlags* tmp = reinterpret_cast<const FFlags*>(&raw);
+				*this = *tmp;
+			}
+
+			operator uint16_t& () {
+				return *(reinterpret_cast<uint16_t*>(this));
+			}
+
+			operator uint16_t() const {
+				return *(reinterpret_cast<const uint16_t*>(this));
+			}
+
+			bool abbreviation_found : 1;
+			bool client_ip_found : 1;
+			bool dst_found : 1;
+			bool dst_from_found : 1;
+			bool dst_offset_found : 1;
+			bool dst_until_found : 1;
+			bool raw_offset_found : 1;
+			bool timezone_found : 1;
+
+			bool unixtime_found : 1;
+			bool error_found : 1;
+
+			inline bool allValidFound() const {
+				return *(reinterpret_cast<const uint16_t*>(this)) >= 0x1FF && !error_found;
+			}
+		};
+
+		/**
+		* @brief Found keys flags.
+		*/
+		FFlags foundFlags;
+
+		/**
+		* @brief Pointer to WorldTimeAPIResult.
+		*/
+		WorldTimeAPIResult* result_ptr;
+
+		bool dst = false;
+		bool dst_null = false;
+
+		TimeZone tz;
+		int32_t raw_offset = 0;
+		int64_t dst_from = 0;  //Unix time
+		int64_t dst_until = 0; //Unix time
+		int16_t dst_offset = 0;
+
+		DateTimeSysSync unixtime;
+	};
+
+	/**
+	* @brief Creates date time with time zone and DST adjustment from parsed fields.
+	*/
+	static void finishTZ(WorldTimeAPIResHelper& resHelper, WorldTimeAPIResult& result);
+
+	/**
+	* @brief Creates recurring DST transition rule from one transition. Transition is matched to
+	* "n-th weekday of month" or "last weekday of month" rule, see WorldTimeAPICalendar::inferRule().
+	* @param localTime Local time of transition in seconds since 1970-01-01.
+	* @return Returns DST transition rule.
+	*/
+	static DSTTransitionRule inferDSTRule(int64_t localTime);
+
+	/**
+	* @brief Parses plain text response in single pass. Each line contains "key: value" pair.
+	* @param text Text to parse.
+	* @param textSize Length of text.
+	* @param res Helper, where parsed fields are stored.
+	* @param errorOnly If true, only error message is parsed.
+	* @return Returns positive value if parsing was successful or negative or zero position of line, where parsing failed.
+	*/
+	static int parseText(const char* text, int textSize, WorldTimeAPIResHelper& res, bool errorOnly);
+
+	/**
+	* @brief Handles one line of plain text response.
+	*/
+	static bool textItemTZ(const char* key, int keyLength, const char* value, int valueLength, int index, WorldTimeAPIResHelper& res);
+
+#if defined(SJSONP_UNDER_OS)
+	/**
+	* @brief Finishes result from time zone informations in helper at current system time.
+	* @return Returns true if result was created.
+	*/
+	static bool finishNow(WorldTimeAPIResHelper& resHelper, WorldTimeAPIResult& result);
+#endif // SJSONP_UNDER_OS
+
+#ifdef WTAPI_IP_CACHE
+	/**
+	* @brief Creates result from entry of IP cache at current system time.
+	* @return Returns false if entry cannot be used, because DST state has changed since it was learned
+	* (abbreviation would be wrong).
+	*/
+	static bool resolveIPCache(const WorldTimeAPIIPCache::Entry& entry, uint32_t ip, WorldTimeAPIResult& result);
+
+	/**
+	* @brief Creates entry of IP cache from result.
+	*/
+	static void toIPCacheEntry(const WorldTimeAPIResult& result, WorldTimeAPIIPCache::Entry& entry);
+#endif // WTAPI_IP_CACHE
+
+#ifdef WTAPI_TZIF
+	/**
+	* @brief Resolves time zone informations at current system time from local tzdata.
+	* @param[in] tz Olson time zone name.
+	* @param[out] result Result, where time zone informations will be stored.
+	* @return Returns true if time zone was found in local tzdata.
+	*/
+	static bool resolveLocalTZ(const char* tz, WorldTimeAPIResult& result);
+
+	/**
+	* @brief Returns true if both results describe the same time zone state.
+	*/
+	static bool sameTZ(const WorldTimeAPIResult& a, const WorldTimeAPIResult& b);
+#endif // WTAPI_TZIF
+};
+
+
+#endif // !WORLD_TIME_API_H_
+
@@ -0,0 +1,88 @@
+#include "WorldTimeAPIArena.h"
+
+#include <stdlib.h>
+
+//Sizes are rounded, so every allocation stays aligned
+#define WTAPI_ARENA_ALIGN(size)   (((size) + 7) & ~(size_t)7)
+
+WorldTimeAPIArena::WorldTimeAPIArena(size_t capacity_) :
+	block(NULL),
+	capacity(WTAPI_ARENA_ALIGN(capacity_)),
+	minCapacity(WTAPI_ARENA_ALIGN(capacity_)),
+	used(0),
+	requested(0),
+	highWater(0),
+	overflow(NULL)
+{
+}
+
+WorldTimeAPIArena::~WorldTimeAPIArena() {
+	reset();
+	free(block);
+}
+
+void* WorldTimeAPIArena::alloc(size_t size) {
+	size = WTAPI_ARENA_ALIGN(size);
+	if (block == NULL && capacity > 0) {
+		block = (char*)malloc(capacity);
+		if (block == NULL) capacity = 0;
+	}
+
+	void* ptr;
+	if (size <= capacity - used) {
+		ptr = block + used;
+		used += size;
+	}
+	else {
+		//Block is full, memory is freed by reset
+		Overflow* chunk = (Overflow*)malloc(sizeof(Overflow) + size);
+		if (chunk == NULL) return NULL;
+		chunk->next = overflow;
+		overflow = chunk;
+		ptr = chunk + 1;
+	}
+	requested += size;
+	if (requested > highWater) highWater = requested;
+	return ptr;
+}
+
+bool WorldTimeAPIArena::extend(void* ptr, size_t size, size_t newSize) {
+	size = WTAPI_ARENA_ALIGN(size);
+	newSize = WTAPI_ARENA_ALIGN(newSize);
+	if (ptr == NULL || (char*)ptr + size != block + used) {
+		return false; //Not the last allocation in block
+	}
+	size_t start = used - size;
+	if (newSize > capacity - start) {
+		return false; //Does not fit to block
+	}
+	used = start + newSize;
+	requested = requested - size + newSize;
+	if (requested > highWater) highWater = requested;
+	return true;
+}
+
+void WorldTimeAPIArena::reset() {
+	while (overflow != NULL) {
+		Overflow* next = overflow->next;
+		free(overflow);
+		overflow = next;
+	}
+	used = 0;
+	requested = 0;
+
+	//Block is resized only when it is too small or its size was changed
+	size_t wanted = highWater > minCapacity ? highWater : minCapacity;
+	if (wanted > WTAPI_ARENA_MAX_SIZE) wanted = (minCapacity > WTAPI_ARENA_MAX_SIZE) ? minCapacity : WTAPI_ARENA_MAX_SIZE;
+	wanted = WTAPI_ARENA_ALIGN(wanted);
+	if (wanted > capacity || (wanted < capacity && highWater == 0)) {
+		free(block);
+		block = NULL; //Allocated by next alloc()
+		capacity = wanted;
+	}
+}
+
+void WorldTimeAPIArena::setCapacity(size_t capacity_) {
+	minCapacity = WTAPI_ARENA_ALIGN(capacity_);
+	highWater = 0;
+}
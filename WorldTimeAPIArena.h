@@ -0,0 +1,111 @@
+/**
+ * @file WorldTimeAPIArena.h
+ * @brief This file contains bump allocator for memory used by one request.
+ *
+ * @see WorldTimeAPIArena
+ */
+
+#ifndef WORLD_TIME_API_ARENA_H_
+#define WORLD_TIME_API_ARENA_H_
+
+#include "SimpleJSONParser.h"
+#include <stddef.h>
+
+#if defined(SJSONP_UNDER_OS)
+#define WTAPI_ARENA_SIZE          (4096)
+#define WTAPI_ARENA_MAX_SIZE      (65536)
+#else
+#define WTAPI_ARENA_SIZE          (1024)
+#define WTAPI_ARENA_MAX_SIZE      (8192)
+#endif // SJSONP_UNDER_OS
+
+/**
+* @class WorldTimeAPIArena
+* @brief Bump allocator for memory, which is needed only during one request (received response and
+* scratch memory of parsing). Memory is taken from one block, so nothing is freed separately and whole
+* arena is released by reset() in O(1). Block is allocated by first alloc() and kept for next requests,
+* so long-running programs do not fragment heap by responses of different sizes.
+* When block is full, memory is allocated on heap and freed by reset(). Arena remembers the highest
+* usage (high-water mark) and reset() enlarges block to it (up to WTAPI_ARENA_MAX_SIZE), so next requests
+* fit to block.
+* @note Arena is not thread safe, it is used by one request at a time.
+*/
+class WorldTimeAPIArena {
+public:
+	/**
+	* @brief Creates arena. Block is not allocated until it is needed.
+	* @param capacity Initial size of block in bytes.
+	*/
+	WorldTimeAPIArena(size_t capacity = WTAPI_ARENA_SIZE);
+	~WorldTimeAPIArena();
+
+	WorldTimeAPIArena(const WorldTimeAPIArena&) = delete;
+	WorldTimeAPIArena& operator=(const WorldTimeAPIArena&) = delete;
+
+	/**
+	* @brief Allocates memory aligned to 8 bytes. Memory is valid until reset().
+	* @return Returns NULL if memory cannot be allocated.
+	*/
+	void* alloc(size_t size);
+
+	/**
+	* @brief Changes size of last allocation in place.
+	* @param ptr Memory returned by last alloc().
+	* @param size Current size of memory.
+	* @param newSize New size of memory.
+	* @return Returns false if memory was not the last allocation or block is full. Memory is not changed then.
+	*/
+	bool extend(void* ptr, size_t size, size_t newSize);
+
+	/**
+	* @brief Releases all allocated memory. Block is kept, so reset is O(1) unless memory had to be
+	* allocated outside of block. Block is enlarged to high-water mark here.
+	*/
+	void reset();
+
+	/**
+	* @brief Sets size of block. It is applied by next reset() and high-water mark is forgotten.
+	*/
+	void setCapacity(size_t capacity);
+
+	/**
+	* @brief Gets size of block in bytes.
+	*/
+	inline size_t getCapacity() const {
+		return capacity;
+	}
+
+	/**
+	* @brief Gets count of bytes allocated since last reset().
+	*/
+	inline size_t getUsed() const {
+		return requested;
+	}
+
+	/**
+	* @brief Gets the highest count of bytes allocated between two resets.
+	*/
+	inline size_t getHighWater() const {
+		return highWater;
+	}
+
+protected:
+	/**
+	* @struct Overflow
+	* @brief Header of memory allocated on heap, when block is full.
+	*/
+	struct Overflow {
+		Overflow* next;
+		uint64_t align;
+	};
+
+	char* block;
+	size_t capacity;
+	size_t minCapacity;
+	size_t used;      //Used bytes of block
+	size_t requested; //Allocated bytes including memory outside of block
+	size_t highWater;
+	Overflow* overflow;
+};
+
+#endif // !WORLD_TIME_API_ARENA_H_
@@ -0,0 +1,52 @@
+#include "WorldTimeAPIAsync.h"
+
+#if defined(SJSONP_UNDER_OS)
+
+WorldTimeAPIIOService::WorldTimeAPIIOService(uint16_t count) {
+	if (count == 0) count = 1;
+	for (uint16_t i = 0; i < count; i++) {
+		threads.emplace_back(&WorldTimeAPIIOService::work, this);
+	}
+}
+
+WorldTimeAPIIOService::~WorldTimeAPIIOService() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	cond.notify_all();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+WorldTimeAPIIOService& WorldTimeAPIIOService::global() {
+	static WorldTimeAPIIOService service;
+	return service;
+}
+
+void WorldTimeAPIIOService::post(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+	}
+	cond.notify_one();
+}
+
+void WorldTimeAPIIOService::work() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		while (jobs.empty() && !stopping) {
+			cond.wait(lock);
+		}
+		if (jobs.empty()) {
+			return; //Stopping and all jobs are done
+		}
+		std::function<void()> job = std::move(jobs.front());
+		jobs.pop_front();
+		lock.unlock();
+		job();
+		lock.lock();
+	}
+}
+#endif // SJSONP_UNDER_OS
@@ -0,0 +1,126 @@
+/**
+ * @file WorldTimeAPIAsync.h
+ * @brief This file contains awaitable lookups for C++20 coroutines.
+ *
+ * @see WorldTimeAPIAwaitable
+ * @see WorldTimeAPIIOService
+ */
+
+#ifndef WORLD_TIME_API_ASYNC_H_
+#define WORLD_TIME_API_ASYNC_H_
+
+#include "SimpleJSONParser.h"
+
+#if defined(SJSONP_UNDER_OS)
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+* @class WorldTimeAPIIOService
+* @brief Fixed pool of threads, which run awaitable lookups. Each lookup calls blocking method of client
+* (getByTimeZone(), getByIP() or getListOfTimeZones()) and occupies one thread until request is finished,
+* it does not wait for socket readiness. So at most as many requests as threads are in progress at once
+* and other lookups wait in queue. Coroutines waiting for lookup are suspended and do not occupy any thread.
+* When request is finished, coroutine is resumed by executor given to lookup.
+* @note For lookups driven by socket readiness without threads, see WorldTimeAPILookup.
+*/
+class WorldTimeAPIIOService {
+public:
+	/**
+	* @brief Gets service shared by all WorldTimeAPI clients (4 threads).
+	*/
+	static WorldTimeAPIIOService& global();
+
+	/**
+	* @brief Creates service.
+	* @param threads Count of threads, so maximal count of requests in progress at once.
+	*/
+	explicit WorldTimeAPIIOService(uint16_t threads = 4);
+	~WorldTimeAPIIOService();
+
+	WorldTimeAPIIOService(const WorldTimeAPIIOService&) = delete;
+	WorldTimeAPIIOService& operator=(const WorldTimeAPIIOService&) = delete;
+
+	/**
+	* @brief Queues job, which will be run by one of threads.
+	*/
+	void post(std::function<void()> job);
+
+protected:
+	void work();
+
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> jobs;
+	std::mutex mutex;
+	std::condition_variable cond;
+	bool stopping = false;
+};
+#endif // SJSONP_UNDER_OS
+
+#if defined(SJSONP_UNDER_OS) && defined(__cpp_impl_coroutine)
+#if __has_include(<coroutine>)
+#define WTAPI_COROUTINES (1)
+#endif
+#endif // __cpp_impl_coroutine
+
+#ifdef WTAPI_COROUTINES
+#include <coroutine>
+
+/**
+* @brief Executor, which resumes coroutine after lookup is finished, for example by posting it to event loop
+* of caller. If empty, coroutine is resumed by thread of WorldTimeAPIIOService.
+*/
+typedef std::function<void(std::coroutine_handle<>)> WorldTimeAPIExecutor;
+
+/**
+* @class WorldTimeAPIAwaitable
+* @brief Lookup, which can be awaited by co_await. When coroutine is suspended, blocking operation is queued
+* to WorldTimeAPIIOService and coroutine is resumed after operation returns.
+* @tparam T Type of result.
+*/
+template<typename T>
+class WorldTimeAPIAwaitable {
+public:
+	typedef std::function<T()> Operation;
+
+	WorldTimeAPIAwaitable(Operation operation_, WorldTimeAPIExecutor executor_, WorldTimeAPIIOService& io_) :
+		operation(std::move(operation_)),
+		executor(std::move(executor_)),
+		io(&io_)
+	{
+	}
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<> handle) {
+		//Awaitable is stored in frame of suspended coroutine, so it exists until coroutine is resumed
+		io->post([this, handle]() {
+			value = operation();
+			if (executor) {
+				executor(handle);
+			}
+			else {
+				handle.resume();
+			}
+		});
+	}
+
+	T await_resume() {
+		return std::move(value);
+	}
+
+protected:
+	Operation operation;
+	WorldTimeAPIExecutor executor;
+	WorldTimeAPIIOService* io;
+	T value;
+};
+#endif // WTAPI_COROUTINES
+
+#endif // !WORLD_TIME_API_ASYNC_H_
@@ -0,0 +1,329 @@
+#include "WorldTimeAPIBulk.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+//Kernels are compiled for AVX2 and SSE4.2 and selected at runtime
+#include <immintrin.h>
+#define WTAPI_BULK_AVX2 (1)
+#define WTAPI_BULK_SSE42 (1)
+#define WTAPI_BULK_TARGET(x) __attribute__((target(x)))
+#define WTAPI_BULK_HAS_AVX2() __builtin_cpu_supports("avx2")
+#define WTAPI_BULK_HAS_SSE42() __builtin_cpu_supports("sse4.2")
+#elif defined(_MSC_VER) && defined(__AVX2__)
+//Compiled with /arch:AVX2
+#include <immintrin.h>
+#define WTAPI_BULK_AVX2 (1)
+#define WTAPI_BULK_HAS_AVX2() true
+#define WTAPI_BULK_SSE42 (1)
+#define WTAPI_BULK_TARGET(x)
+#define WTAPI_BULK_HAS_SSE42() true
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define WTAPI_BULK_NEON (1)
+#endif
+
+//Count of timestamps, for which DST periods are selected at once
+#define WTAPI_BULK_BLOCK          (512)
+//When block overlaps more DST periods, period is searched for each timestamp instead of comparing all
+#define WTAPI_BULK_SEARCH_MIN     (8)
+
+/**
+* @brief Arguments of conversion kernel. Times and offsets ending with S are in units of timestamps.
+*/
+struct WorldTimeAPIBulkArgs {
+	const int64_t* from;
+	const int64_t* until;
+	int count;
+	int64_t stdS;
+	int64_t dstS;
+	int32_t std;
+	int32_t dst;
+};
+
+typedef void(*WorldTimeAPIBulkKernel)(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, const WorldTimeAPIBulkArgs& a);
+
+static void convertScalar(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, const WorldTimeAPIBulkArgs& a) {
+	for (size_t i = 0; i < length; i++) {
+		int64_t t = utc[i];
+		int64_t m = 0;
+		for (int w = 0; w < a.count; w++) {
+			m |= -(int64_t)((t >= a.from[w]) & (t < a.until[w]));
+		}
+		local[i] = t + a.stdS + (m & a.dstS);
+		if (offsets != NULL) {
+			offsets[i] = a.std + (int32_t)(m & a.dst);
+		}
+	}
+}
+
+static void convertSearch(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, const WorldTimeAPIBulkArgs& a) {
+	for (size_t i = 0; i < length; i++) {
+		int64_t t = utc[i];
+		//Branchless search of last DST period starting before t
+		const int64_t* base = a.from;
+		int n = a.count;
+		while (n > 1) {
+			int half = n / 2;
+			base = (base[half] <= t) ? base + half : base;
+			n -= half;
+		}
+		int w = (int)(base - a.from);
+		int64_t m = -(int64_t)((t >= a.from[w]) & (t < a.until[w]));
+		local[i] = t + a.stdS + (m & a.dstS);
+		if (offsets != NULL) {
+			offsets[i] = a.std + (int32_t)(m & a.dst);
+		}
+	}
+}
+
+#ifdef WTAPI_BULK_AVX2
+WTAPI_BULK_TARGET("avx2") static void convertAVX2(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, const WorldTimeAPIBulkArgs& a) {
+	const __m256i vStdS = _mm256_set1_epi64x(a.stdS);
+	const __m256i vDstS = _mm256_set1_epi64x(a.dstS);
+	const __m256i vStd = _mm256_set1_epi64x(a.std);
+	const __m256i vDst = _mm256_set1_epi64x(a.dst);
+	const __m256i lowHalves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+	size_t i = 0;
+	for (; i + 4 <= length; i += 4) {
+		__m256i t = _mm256_loadu_si256((const __m256i*)(utc + i));
+		__m256i m = _mm256_setzero_si256();
+		for (int w = 0; w < a.count; w++) {
+			//from <= t < until
+			__m256i before = _mm256_cmpgt_epi64(_mm256_set1_epi64x(a.from[w]), t);
+			__m256i inside = _mm256_cmpgt_epi64(_mm256_set1_epi64x(a.until[w]), t);
+			m = _mm256_or_si256(m, _mm256_andnot_si256(before, inside));
+		}
+		_mm256_storeu_si256((__m256i*)(local + i), _mm256_add_epi64(t, _mm256_add_epi64(vStdS, _mm256_and_si256(m, vDstS))));
+		if (offsets != NULL) {
+			__m256i off = _mm256_add_epi64(vStd, _mm256_and_si256(m, vDst));
+			_mm_storeu_si128((__m128i*)(offsets + i), _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(off, lowHalves)));
+		}
+	}
+	convertScalar(utc + i, local + i, (offsets != NULL) ? offsets + i : NULL, length - i, a);
+}
+#endif // WTAPI_BULK_AVX2
+
+#ifdef WTAPI_BULK_SSE42
+WTAPI_BULK_TARGET("sse4.2") static void convertSSE42(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, const WorldTimeAPIBulkArgs& a) {
+	const __m128i vStdS = _mm_set1_epi64x(a.stdS);
+	const __m128i vDstS = _mm_set1_epi64x(a.dstS);
+	const __m128i vStd = _mm_set1_epi64x(a.std);
+	const __m128i vDst = _mm_set1_epi64x(a.dst);
+	size_t i = 0;
+	for (; i + 2 <= length; i += 2) {
+		__m128i t = _mm_loadu_si128((const __m128i*)(utc + i));
+		__m128i m = _mm_setzero_si128();
+		for (int w = 0; w < a.count; w++) {
+			__m128i before = _mm_cmpgt_epi64(_mm_set1_epi64x(a.from[w]), t);
+			__m128i inside = _mm_cmpgt_epi64(_mm_set1_epi64x(a.until[w]), t);
+			m = _mm_or_si128(m, _mm_andnot_si128(before, inside));
+		}
+		_mm_storeu_si128((__m128i*)(local + i), _mm_add_epi64(t, _mm_add_epi64(vStdS, _mm_and_si128(m, vDstS))));
+		if (offsets != NULL) {
+			__m128i off = _mm_add_epi64(vStd, _mm_and_si128(m, vDst));
+			_mm_storel_epi64((__m128i*)(offsets + i), _mm_shuffle_epi32(off, _MM_SHUFFLE(3, 1, 2, 0)));
+		}
+	}
+	convertScalar(utc + i, local + i, (offsets != NULL) ? offsets + i : NULL, length - i, a);
+}
+#endif // WTAPI_BULK_SSE42
+
+#ifdef WTAPI_BULK_NEON
+static void convertNEON(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, const WorldTimeAPIBulkArgs& a) {
+	const int64x2_t vStdS = vdupq_n_s64(a.stdS);
+	const int64x2_t vDstS = vdupq_n_s64(a.dstS);
+	const int64x2_t vStd = vdupq_n_s64(a.std);
+	const int64x2_t vDst = vdupq_n_s64(a.dst);
+	size_t i = 0;
+	for (; i + 2 <= length; i += 2) {
+		int64x2_t t = vld1q_s64(utc + i);
+		uint64x2_t m = vdupq_n_u64(0);
+		for (int w = 0; w < a.count; w++) {
+			uint64x2_t inside = vandq_u64(vcgeq_s64(t, vdupq_n_s64(a.from[w])), vcltq_s64(t, vdupq_n_s64(a.until[w])));
+			m = vorrq_u64(m, inside);
+		}
+		int64x2_t mask = vreinterpretq_s64_u64(m);
+		vst1q_s64(local + i, vaddq_s64(t, vaddq_s64(vStdS, vandq_s64(mask, vDstS))));
+		if (offsets != NULL) {
+			vst1_s32(offsets + i, vmovn_s64(vaddq_s64(vStd, vandq_s64(mask, vDst))));
+		}
+	}
+	convertScalar(utc + i, local + i, (offsets != NULL) ? offsets + i : NULL, length - i, a);
+}
+#endif // WTAPI_BULK_NEON
+
+static WorldTimeAPIBulkKernel selectKernel() {
+#ifdef WTAPI_BULK_AVX2
+	if (WTAPI_BULK_HAS_AVX2()) return convertAVX2;
+#endif // WTAPI_BULK_AVX2
+#ifdef WTAPI_BULK_SSE42
+	if (WTAPI_BULK_HAS_SSE42()) return convertSSE42;
+#endif // WTAPI_BULK_SSE42
+#ifdef WTAPI_BULK_NEON
+	return convertNEON;
+#else
+	return convertScalar;
+#endif // WTAPI_BULK_NEON
+}
+
+static void addConstant(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, int64_t addS, int32_t offset) {
+	for (size_t i = 0; i < length; i++) {
+		local[i] = utc[i] + addS;
+	}
+	if (offsets != NULL) {
+		for (size_t i = 0; i < length; i++) {
+			offsets[i] = offset;
+		}
+	}
+}
+
+
+void WorldTimeAPITransitions::clear() {
+	stdOffset = 0;
+	dstOffset = 0;
+	count = 0;
+}
+
+bool WorldTimeAPITransitions::add(int64_t from, int64_t until) {
+	if (count >= WTAPI_BULK_MAX_WINDOWS || until <= from || (count > 0 && from < dstUntil[count - 1])) {
+		return false;
+	}
+	dstFrom[count] = from;
+	dstUntil[count] = until;
+	count++;
+	return true;
+}
+
+bool WorldTimeAPITransitions::fromResult(const WorldTimeAPIResult& res, int32_t fromYear, int32_t toYear) {
+	clear();
+	if (res.hasError() || toYear < fromYear || toYear - fromYear + 1 >= WTAPI_BULK_MAX_WINDOWS) {
+		return false;
+	}
+	stdOffset = res.rawOffset;
+	if (res.dstOffset == 0 || res.dstUntil <= res.dstFrom) {
+		return true; //No DST
+	}
+	dstOffset = res.dstOffset;
+
+	//DST starts at local standard time and ends at local DST time
+	WorldTimeAPICalendar::Rule start = WorldTimeAPICalendar::inferRule(res.dstFrom + stdOffset);
+	WorldTimeAPICalendar::Rule end = WorldTimeAPICalendar::inferRule(res.dstUntil + stdOffset + dstOffset);
+	for (int32_t y = fromYear - 1; y <= toYear; y++) {
+		int64_t from = WorldTimeAPICalendar::ruleTime(start, y) - stdOffset;
+		int64_t until = WorldTimeAPICalendar::ruleTime(end, y) - stdOffset - dstOffset;
+		if (until <= from) {
+			//South hemisphere, DST period ends next year
+			until = WorldTimeAPICalendar::ruleTime(end, y + 1) - stdOffset - dstOffset;
+		} else if (y < fromYear) {
+			continue; //Period of previous year does not reach first year
+		}
+		if (!add(from, until)) {
+			clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+#ifdef WTAPI_TZIF
+bool WorldTimeAPITransitions::fromTZif(const char* tz, int64_t from, int64_t until) {
+	clear();
+	WorldTimeAPITZif::ZoneState state;
+	if (!WorldTimeAPITZif::global().lookup(tz, from, state)) {
+		return false;
+	}
+	stdOffset = state.stdOffset;
+
+	int64_t t = from;
+	while (t < until) {
+		if (state.stdOffset != stdOffset) {
+			clear();
+			return false; //Standard offset changed
+		}
+		if (!state.hasDST || state.dstFrom >= until) {
+			break;
+		}
+		if (dstOffset == 0) {
+			dstOffset = state.dstOffset;
+		}
+		else if (state.dstOffset != dstOffset) {
+			clear();
+			return false; //DST offset changed
+		}
+		if (count == 0 || state.dstFrom >= dstUntil[count - 1]) {
+			if (!add(state.dstFrom, state.dstUntil)) {
+				clear();
+				return false;
+			}
+		}
+		if (state.dstUntil <= t) {
+			break;
+		}
+		t = state.dstUntil;
+		WorldTimeAPITZif::global().lookup(tz, t, state);
+	}
+	return true;
+}
+#endif // WTAPI_TZIF
+
+void WorldTimeAPITransitions::convert(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, int64_t unitsPerSecond) const {
+	static const WorldTimeAPIBulkKernel kernel = selectKernel();
+
+	//DST periods in units of timestamps
+	int64_t from[WTAPI_BULK_MAX_WINDOWS];
+	int64_t until[WTAPI_BULK_MAX_WINDOWS];
+	for (uint16_t w = 0; w < count; w++) {
+		from[w] = dstFrom[w] * unitsPerSecond;
+		until[w] = dstUntil[w] * unitsPerSecond;
+	}
+
+	WorldTimeAPIBulkArgs args;
+	args.stdS = (int64_t)stdOffset * unitsPerSecond;
+	args.dstS = (int64_t)dstOffset * unitsPerSecond;
+	args.std = stdOffset;
+	args.dst = dstOffset;
+
+	for (size_t start = 0; start < length; start += WTAPI_BULK_BLOCK) {
+		size_t n = (length - start < WTAPI_BULK_BLOCK) ? length - start : WTAPI_BULK_BLOCK;
+		const int64_t* u = utc + start;
+		int64_t* l = local + start;
+		int32_t* o = (offsets != NULL) ? offsets + start : NULL;
+
+		int64_t minT = u[0], maxT = u[0];
+		for (size_t i = 1; i < n; i++) {
+			minT = (u[i] < minT) ? u[i] : minT;
+			maxT = (u[i] > maxT) ? u[i] : maxT;
+		}
+
+		//DST periods overlapping block: first ending after minT, last starting before maxT
+		int lo = 0, hi = count;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (until[mid] > minT) hi = mid; else lo = mid + 1;
+		}
+		int first = lo;
+		hi = count;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (from[mid] > maxT) hi = mid; else lo = mid + 1;
+		}
+		int last = lo;
+
+		if (first >= last) {
+			addConstant(u, l, o, n, args.stdS, args.std); //Standard time only
+		}
+		else if (last - first == 1 && from[first] <= minT && until[first] > maxT) {
+			addConstant(u, l, o, n, args.stdS + args.dstS, args.std + args.dst); //Whole block in one DST period
+		}
+		else {
+			args.from = from + first;
+			args.until = until + first;
+			args.count = last - first;
+			if (args.count >= WTAPI_BULK_SEARCH_MIN) {
+				convertSearch(u, l, o, n, args);
+			}
+			else {
+				kernel(u, l, o, n, args);
+			}
+		}
+	}
+}
@@ -0,0 +1,101 @@
+/**
+ * @file WorldTimeAPIBulk.h
+ * @brief This file contains bulk conversion of UTC timestamps to local time.
+ *
+ * @see WorldTimeAPITransitions
+ */
+
+#ifndef WORLD_TIME_API_BULK_H_
+#define WORLD_TIME_API_BULK_H_
+
+#include "WorldTimeAPI.h"
+
+#include <stddef.h>
+
+#define WTAPI_BULK_MAX_WINDOWS    (64)
+
+/**
+* @struct WorldTimeAPITransitions
+* @brief Compact descriptor of time zone: standard offset, DST offset and sorted DST periods.
+* It can be derived from WorldTimeAPIResult (DST rule is repeated for range of years) or
+* from local tzdata. Then arrays of timestamps are converted to local time by convert().
+*/
+struct WorldTimeAPITransitions {
+	WorldTimeAPITransitions() {
+		clear();
+	}
+
+	/**
+	* @brief Standard offset from UTC in seconds.
+	*/
+	int32_t stdOffset;
+
+	/**
+	* @brief DST offset in seconds, which is added to standard offset during DST period.
+	*/
+	int32_t dstOffset;
+
+	/**
+	* @brief Count of DST periods.
+	*/
+	uint16_t count;
+
+	/**
+	* @brief Unix times of beginnings of DST periods (sorted).
+	*/
+	int64_t dstFrom[WTAPI_BULK_MAX_WINDOWS];
+
+	/**
+	* @brief Unix times of ends of DST periods (sorted).
+	*/
+	int64_t dstUntil[WTAPI_BULK_MAX_WINDOWS];
+
+	/**
+	* @brief Clears descriptor, so it describes UTC.
+	*/
+	void clear();
+
+	/**
+	* @brief Derives descriptor from result. DST period from result is converted to recurring rule
+	* (see WorldTimeAPICalendar::inferRule()) and repeated for every year in range. In southern hemisphere,
+	* period starting in year before first year is included too, as it lasts into first year.
+	* @param res Valid result.
+	* @param fromYear First year.
+	* @param toYear Last year. At most WTAPI_BULK_MAX_WINDOWS - 1 years can be covered.
+	* @return Returns true if descriptor was created.
+	*/
+	bool fromResult(const WorldTimeAPIResult& res, int32_t fromYear, int32_t toYear);
+
+#ifdef WTAPI_TZIF
+	/**
+	* @brief Derives descriptor from local tzdata. DST periods are exact, but standard offset has to be
+	* the same in whole range.
+	* @param tz Olson time zone name.
+	* @param from Unix time of beginning of range.
+	* @param until Unix time of end of range.
+	* @return Returns true if descriptor was created.
+	*/
+	bool fromTZif(const char* tz, int64_t from, int64_t until);
+#endif // WTAPI_TZIF
+
+	/**
+	* @brief Converts array of UTC timestamps to local timestamps.
+	* Timestamps are processed in blocks. When whole block is in standard time or in one DST period,
+	* constant offset is added. Otherwise timestamps are compared with DST periods overlapping the block
+	* by SIMD instructions (AVX2, SSE4.2 or NEON, when available).
+	* @param[in] utc Array of UTC timestamps.
+	* @param[out] local Array of local timestamps. Can be the same as utc.
+	* @param[out] offsets Array of offsets from UTC in seconds or NULL if not needed.
+	* @param[in] length Count of timestamps.
+	* @param[in] unitsPerSecond Units of timestamps, for example: 1 for seconds, 1000 for milliseconds.
+	*/
+	void convert(const int64_t* utc, int64_t* local, int32_t* offsets, size_t length, int64_t unitsPerSecond = 1) const;
+
+protected:
+	/**
+	* @brief Adds DST period, periods have to be added in order.
+	*/
+	bool add(int64_t from, int64_t until);
+};
+
+#endif // !WORLD_TIME_API_BULK_H_
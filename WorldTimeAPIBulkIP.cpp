@@ -0,0 +1,109 @@
+#include "WorldTimeAPIBulkIP.h"
+
+#ifdef WTAPI_BULK_IP
+
+WorldTimeAPIBulkIP::WorldTimeAPIBulkIP(WorldTimeAPI& api_, uint16_t maxInFlight_, uint32_t queueSize_, uint32_t dedupWindow) :
+	api(api_),
+	maxInFlight(maxInFlight_ == 0 ? 1 : maxInFlight_),
+	queueSize(queueSize_ == 0 ? 1 : queueSize_),
+	seen(dedupWindow == 0 ? 1 : dedupWindow, 0)
+{
+}
+
+void WorldTimeAPIBulkIP::start(const Sink& sink_) {
+	sink = &sink_;
+	delivered = 0;
+	outstanding = 0;
+	inputDone = false;
+	std::fill(seen.begin(), seen.end(), 0);
+	for (uint16_t i = 0; i < maxInFlight; i++) {
+		workers.emplace_back(&WorldTimeAPIBulkIP::work, this);
+	}
+}
+
+void WorldTimeAPIBulkIP::push(uint32_t ip) {
+	if (ip == 0) {
+		//Invalid address
+		WorldTimeAPIResult result;
+		result.httpCode = WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR;
+		(*sink)(0, result);
+		delivered++;
+		return;
+	}
+
+	uint32_t& slot = seen[(ip * 2654435761u) % seen.size()];
+	if (slot == ip) {
+		return; //Duplicate
+	}
+	slot = ip;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (outstanding >= queueSize + maxInFlight) {
+		if (completed.empty()) {
+			doneCond.wait(lock);
+		}
+		deliver(lock);
+	}
+	pending.push_back(ip);
+	outstanding++;
+	workCond.notify_one();
+	deliver(lock); //Results are streamed while input is read
+}
+
+size_t WorldTimeAPIBulkIP::finish() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		inputDone = true;
+		workCond.notify_all();
+		while (outstanding > 0) {
+			if (completed.empty()) {
+				doneCond.wait(lock);
+			}
+			deliver(lock);
+		}
+	}
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	sink = NULL;
+	return delivered;
+}
+
+void WorldTimeAPIBulkIP::deliver(std::unique_lock<std::mutex>& lock) {
+	while (!completed.empty()) {
+		Completion done = completed.front();
+		completed.pop_front();
+		lock.unlock();
+		(*sink)(done.ip, done.result);
+		lock.lock();
+		outstanding--;
+		delivered++;
+	}
+}
+
+void WorldTimeAPIBulkIP::work() {
+	char ip[WTAPI_TZ_CLIENT_IP_SIZE];
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		while (pending.empty() && !inputDone) {
+			workCond.wait(lock);
+		}
+		if (pending.empty()) {
+			return; //End of input
+		}
+		Completion done;
+		done.ip = pending.front();
+		pending.pop_front();
+		lock.unlock();
+
+		snprintf(ip, sizeof(ip), "%u.%u.%u.%u", (unsigned)(done.ip >> 24), (unsigned)((done.ip >> 16) & 0xFF),
+			(unsigned)((done.ip >> 8) & 0xFF), (unsigned)(done.ip & 0xFF));
+		api.getByIP(ip, done.result, timeout);
+
+		lock.lock();
+		completed.push_back(done);
+		doneCond.notify_one();
+	}
+}
+#endif // WTAPI_BULK_IP
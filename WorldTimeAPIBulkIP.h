@@ -0,0 +1,151 @@
+/**
+ * @file WorldTimeAPIBulkIP.h
+ * @brief This file contains bulk lookup of time zones of many IPv4 addresses.
+ *
+ * @see WorldTimeAPIBulkIP
+ */
+
+#ifndef WORLD_TIME_API_BULK_IP_H_
+#define WORLD_TIME_API_BULK_IP_H_
+
+#include "WorldTimeAPI.h"
+
+#if defined(SJSONP_UNDER_OS)
+//Lookups are sent from worker threads
+#define WTAPI_BULK_IP (1)
+#endif // SJSONP_UNDER_OS
+
+#ifdef WTAPI_BULK_IP
+#include <deque>
+#include <vector>
+#include <functional>
+
+/**
+* @class WorldTimeAPIBulkIP
+* @brief Looks up time zones of many IPv4 addresses using getByIP() of client. Addresses are read from
+* iterator, duplicates are skipped, at most maxInFlight lookups run at once and results are passed
+* to sink in order of completion. Reading of input waits (backpressure), when queueSize addresses are
+* waiting or not delivered yet, so memory does not depend on size of input.
+* Sink is called from thread, which called run().
+*
+* @code
+* WorldTimeAPIBulkIP bulk(api, 16);
+* bulk.run(ips.begin(), ips.end(), [](uint32_t ip, const WorldTimeAPIResult& res) {
+*     //...
+* });
+* @endcode
+* @note Duplicates are detected within window of recently seen addresses (dedupWindow), duplicate
+* farther in input is looked up again (usually from cache of client, see setCache() and setIPCache()).
+*/
+class WorldTimeAPIBulkIP {
+public:
+	/**
+	* @brief Callback, which receives result of one address. Invalid addresses are passed as 0 with
+	* WTA_ERROR_ARGUMENT_ERROR.
+	*/
+	typedef std::function<void(uint32_t ip, const WorldTimeAPIResult& result)> Sink;
+
+	/**
+	* @brief Creates bulk lookup.
+	* @param api Client used for lookups. Rate limit, retries, caches and circuit breaker of client are applied.
+	* @param maxInFlight Maximal count of lookups running at once (worker threads).
+	* @param queueSize Maximal count of addresses waiting for lookup or delivery.
+	* @param dedupWindow Count of recently seen addresses remembered for skipping duplicates (4 bytes each).
+	*/
+	WorldTimeAPIBulkIP(WorldTimeAPI& api, uint16_t maxInFlight = 8, uint32_t queueSize = 1024, uint32_t dedupWindow = 65536);
+
+	WorldTimeAPIBulkIP(const WorldTimeAPIBulkIP&) = delete;
+	WorldTimeAPIBulkIP& operator=(const WorldTimeAPIBulkIP&) = delete;
+
+	/**
+	* @brief Sets timeout of one lookup.
+	* @param ms Time in milliseconds. If set to 0, timeout of client is used (default).
+	*/
+	inline void setTimeout(uint32_t ms) {
+		timeout = ms;
+	}
+
+	/**
+	* @brief Looks up all addresses from range and passes results to sink. Returns after last result was delivered.
+	* @param first Iterator to first address. Addresses can be uint32_t (first octet in most significant byte),
+	* const char* or std::string in dotted form.
+	* @param last Iterator after last address.
+	* @param sink Callback, which receives results.
+	* @return Returns count of delivered results.
+	*/
+	template<typename Iterator>
+	size_t run(Iterator first, Iterator last, const Sink& sink) {
+		start(sink);
+		for (; first != last; ++first) {
+			push(toAddress(*first));
+		}
+		return finish();
+	}
+
+protected:
+	struct Completion {
+		uint32_t ip;
+		WorldTimeAPIResult result;
+	};
+
+	static inline uint32_t toAddress(uint32_t ip) {
+		return ip;
+	}
+
+	static inline uint32_t toAddress(const char* ip) {
+		uint32_t address = 0;
+		return (ip != NULL && WorldTimeAPI::parseIPv4(ip, address)) ? address : 0;
+	}
+
+	static inline uint32_t toAddress(const std::string& ip) {
+		return toAddress(ip.c_str());
+	}
+
+	/**
+	* @brief Starts worker threads.
+	*/
+	void start(const Sink& sink);
+
+	/**
+	* @brief Queues address. Waits while queue is full and delivers finished results meanwhile.
+	*/
+	void push(uint32_t ip);
+
+	/**
+	* @brief Waits for all lookups, delivers results and stops worker threads.
+	* @return Returns count of delivered results.
+	*/
+	size_t finish();
+
+	/**
+	* @brief Delivers finished results. Lock has to be held, it is released while sink is called.
+	*/
+	void deliver(std::unique_lock<std::mutex>& lock);
+
+	/**
+	* @brief Loop of worker thread.
+	*/
+	void work();
+
+	WorldTimeAPI& api;
+	uint16_t maxInFlight;
+	uint32_t queueSize;
+	uint32_t timeout = 0;
+
+	std::vector<uint32_t> seen; //Recently seen addresses, 0 - empty
+	std::vector<std::thread> workers;
+	const Sink* sink = NULL;
+	size_t delivered = 0;
+
+	std::mutex mutex;
+	std::condition_variable workCond; //Signals new address or end of input to workers
+	std::condition_variable doneCond; //Signals finished lookup to caller
+	std::deque<uint32_t> pending;
+	std::deque<Completion> completed;
+	uint32_t outstanding = 0; //Addresses queued and not delivered yet
+	bool inputDone = false;
+};
+
+#endif // WTAPI_BULK_IP
+
+#endif // !WORLD_TIME_API_BULK_IP_H_
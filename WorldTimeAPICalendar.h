@@ -0,0 +1,209 @@
+/**
+ * @file WorldTimeAPICalendar.h
+ * @brief This file contains conversions between unix time and civil (proleptic Gregorian) dates.
+ *
+ * @see WorldTimeAPICalendar
+ */
+
+#ifndef WORLD_TIME_API_CALENDAR_H_
+#define WORLD_TIME_API_CALENDAR_H_
+
+#include "SimpleJSONParser.h"
+
+#include <stdio.h>
+
+/**
+* @class WorldTimeAPICalendar
+* @brief Conversions between unix time and dates, which do not depend on system time zone.
+* Algorithms are valid for all dates of proleptic Gregorian calendar.
+*/
+class WorldTimeAPICalendar {
+public:
+	/**
+	* @brief Gets count of days since 1970-01-01.
+	* @param y Year.
+	* @param m Month (1 - 12).
+	* @param d Day of month (1 - 31).
+	*/
+	static inline int32_t daysFromCivil(int32_t y, uint8_t m, uint8_t d) {
+		y -= m <= 2;
+		int32_t era = (y >= 0 ? y : y - 399) / 400;
+		uint32_t yoe = (uint32_t)(y - era * 400);
+		uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+		uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		return era * 146097 + (int32_t)doe - 719468;
+	}
+
+	/**
+	* @brief Gets date from count of days since 1970-01-01.
+	*/
+	static inline void civilFromDays(int32_t days, int32_t& y, uint8_t& m, uint8_t& d) {
+		days += 719468;
+		int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+		uint32_t doe = (uint32_t)(days - era * 146097);
+		uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		uint32_t mp = (5 * doy + 2) / 153;
+		d = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+		m = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+		y = (int32_t)yoe + era * 400 + (m <= 2);
+	}
+
+	/**
+	* @brief Gets day of week from count of days since 1970-01-01.
+	* @return Returns day of week (0 - Sunday, 6 - Saturday).
+	*/
+	static inline uint8_t weekday(int32_t days) {
+		return (uint8_t)(((days % 7) + 11) % 7);
+	}
+
+	/**
+	* @brief Returns true if year is leap.
+	*/
+	static inline bool isLeap(int32_t y) {
+		return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+	}
+
+	/**
+	* @brief Gets count of days in month.
+	*/
+	static inline uint8_t daysInMonth(int32_t y, uint8_t m) {
+		static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		return (m == 2 && isLeap(y)) ? 29 : days[m - 1];
+	}
+
+	/**
+	* @brief Gets day of n-th weekday in month.
+	* @param y Year.
+	* @param m Month (1 - 12).
+	* @param week Week of month (1 - 4) or 5 for last weekday in month.
+	* @param wd Day of week (0 - Sunday, 6 - Saturday).
+	* @return Returns count of days since 1970-01-01.
+	*/
+	static inline int32_t weekdayOfMonth(int32_t y, uint8_t m, uint8_t week, uint8_t wd) {
+		int32_t first = daysFromCivil(y, m, 1);
+		int32_t days = first + (wd - weekday(first) + 7) % 7 + (week - 1) * 7;
+		if (days >= first + daysInMonth(y, m)) {
+			days -= 7; //Week 5 means last week
+		}
+		return days;
+	}
+
+	/**
+	* @struct Rule
+	* @brief Yearly recurring date and time, for example: "last Sunday of March 02:00".
+	*/
+	struct Rule {
+		uint8_t month;
+		uint8_t week;  //Week of month (1 - 4), 5 - last week or 0 for fixed day of month
+		uint8_t day;   //Day of week (0 - Sunday) or day of month if week is 0
+		int32_t time;  //Seconds since midnight
+	};
+
+	/**
+	* @brief Creates recurring rule from one date. Date is matched to "n-th weekday of month" or
+	* "last weekday of month" (last weekday is preferred over fourth weekday), for example
+	* "last Sunday of March" or "last Friday of April".
+	* @param localTime Local time in seconds since 1970-01-01.
+	*/
+	static inline Rule inferRule(int64_t localTime) {
+		int32_t days = daysFromUnix(localTime);
+		int32_t y;
+		Rule rule;
+		civilFromDays(days, y, rule.month, rule.day);
+		rule.time = (int32_t)(localTime - (int64_t)days * 86400);
+		rule.week = (rule.day + 7 > daysInMonth(y, rule.month)) ? 5 : (uint8_t)((rule.day - 1) / 7 + 1);
+		rule.day = weekday(days);
+		return rule;
+	}
+
+	/**
+	* @brief Gets local time of rule in given year in seconds since 1970-01-01.
+	*/
+	static inline int64_t ruleTime(const Rule& rule, int32_t y) {
+		int32_t days = (rule.week == 0) ? daysFromCivil(y, rule.month, rule.day) : weekdayOfMonth(y, rule.month, rule.week, rule.day);
+		return (int64_t)days * 86400 + rule.time;
+	}
+
+	/**
+	* @brief Floor division of unix time to days.
+	*/
+	static inline int32_t daysFromUnix(int64_t unixTime) {
+		return (int32_t)(unixTime >= 0 ? unixTime / 86400 : (unixTime - 86399) / 86400);
+	}
+
+	/**
+	* @brief Formats unix time as ISO 8601 UTC date time, for example: "2022-06-16T11:57:27.659132+00:00".
+	* Format is the same as used by WorldTimeAPI, so it can be parsed by DateTime parser.
+	* @param[out] buffer Buffer with size at least 40 characters.
+	* @param[in] bufferSize Size of buffer.
+	* @param[in] unixTime Unix time in seconds.
+	* @param[in] micros Fraction of second in microseconds (0 - 999999, larger values are clamped). If negative, fraction is not printed.
+	* @return Returns count of written characters.
+	*/
+	static inline int formatISO(char* buffer, int bufferSize, int64_t unixTime, int32_t micros = -1) {
+		int32_t days = daysFromUnix(unixTime);
+		int32_t secs = (int32_t)(unixTime - (int64_t)days * 86400);
+		int32_t y;
+		uint8_t m, d;
+		civilFromDays(days, y, m, d);
+		if (micros >= 0) {
+			//Fraction is limited to 6 digits, so output always fits to 40 characters
+			unsigned fraction = (micros < 1000000) ? (unsigned)micros : 999999u;
+			return snprintf(buffer, bufferSize, "%04d-%02u-%02uT%02u:%02u:%02u.%06u+00:00", (int)y, m, d,
+				(unsigned)secs / 3600u % 24u, (unsigned)secs / 60u % 60u, (unsigned)secs % 60u, fraction % 1000000u);
+		}
+		return snprintf(buffer, bufferSize, "%04d-%02u-%02uT%02d:%02d:%02d+00:00", (int)y, m, d,
+			(int)(secs / 3600), (int)(secs / 60 % 60), (int)(secs % 60));
+	}
+
+	/**
+	* @brief Parses ISO 8601 date time with offset, for example: "2022-03-27T01:00:00+00:00", to unix time.
+	* Fraction of second is ignored.
+	* @param[in] text Text to parse.
+	* @param[in] textLength Length of text.
+	* @param[out] unixTime Parsed unix time in seconds.
+	* @return Returns true if text was parsed.
+	*/
+	static inline bool parseISO(const char* text, int textLength, int64_t& unixTime) {
+		int pos = 0;
+		int32_t v[6];
+		static const char seps[6] = { '-', '-', 'T', ':', ':', 0 };
+		for (int f = 0; f < 6; f++) {
+			int32_t val = 0;
+			int digits = 0;
+			for (; pos < textLength && text[pos] >= '0' && text[pos] <= '9'; pos++, digits++) {
+				val = val * 10 + (text[pos] - '0');
+			}
+			if (digits == 0 || digits > 4) return false;
+			v[f] = val;
+			if (seps[f] != 0) {
+				if (pos >= textLength || text[pos] != seps[f]) return false;
+				pos++;
+			}
+		}
+		if (v[1] < 1 || v[1] > 12 || v[2] < 1 || v[2] > 31 || v[3] > 23 || v[4] > 59 || v[5] > 60) {
+			return false;
+		}
+		if (pos < textLength && text[pos] == '.') {
+			//Skipping fraction
+			for (pos++; pos < textLength && text[pos] >= '0' && text[pos] <= '9'; pos++);
+		}
+		int32_t offset = 0;
+		if (pos < textLength && (text[pos] == '+' || text[pos] == '-')) {
+			bool neg = text[pos] == '-';
+			if (pos + 6 > textLength || text[pos + 3] != ':') return false;
+			int32_t oh = (text[pos + 1] - '0') * 10 + (text[pos + 2] - '0');
+			int32_t om = (text[pos + 4] - '0') * 10 + (text[pos + 5] - '0');
+			offset = (oh * 60 + om) * 60;
+			if (neg) offset = -offset;
+		}
+		else if (pos < textLength && text[pos] == 'Z') {
+			offset = 0;
+		}
+		unixTime = (int64_t)daysFromCivil(v[0], (uint8_t)v[1], (uint8_t)v[2]) * 86400 + v[3] * 3600 + v[4] * 60 + v[5] - offset;
+		return true;
+	}
+};
+
+#endif // !WORLD_TIME_API_CALENDAR_H_
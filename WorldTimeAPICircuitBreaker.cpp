@@ -0,0 +1,62 @@
+#include "WorldTimeAPICircuitBreaker.h"
+
+WorldTimeAPICircuitBreaker::WorldTimeAPICircuitBreaker() :
+	threshold(0),
+	coolDown(30000),
+	failures(0),
+	openedAt(0),
+	open(false),
+	probing(false)
+{}
+
+void WorldTimeAPICircuitBreaker::setThreshold(uint8_t threshold_, uint32_t coolDown_) {
+	WTAPI_RATE_LIMITER_LOCK();
+	threshold = threshold_;
+	coolDown = coolDown_;
+	failures = 0;
+	open = false;
+	probing = false;
+}
+
+bool WorldTimeAPICircuitBreaker::allow() {
+	WTAPI_RATE_LIMITER_LOCK();
+	if (!open) {
+		return true;
+	}
+	if (probing || WorldTimeAPIClock::elapsed(openedAt) < coolDown) {
+		return false; //Still open or probe is in progress
+	}
+	probing = true; //Half open, this caller sends probe request
+	return true;
+}
+
+void WorldTimeAPICircuitBreaker::onResponse(int httpCode) {
+	WTAPI_RATE_LIMITER_LOCK();
+	if (threshold == 0) return;
+
+	//Connection errors (-1 to -11) and server errors mean, that API is failing
+	bool failed = (httpCode < 0 && httpCode >= -11) || httpCode >= 500;
+	if (!failed) {
+		failures = 0;
+		open = false;
+		probing = false;
+		return;
+	}
+	if (failures < 0xFF) failures++;
+	if (probing || failures >= threshold) {
+		//Probe failed or too many failures
+		open = true;
+		probing = false;
+		openedAt = WorldTimeAPIClock::now();
+	}
+}
+
+void WorldTimeAPICircuitBreaker::cancel() {
+	WTAPI_RATE_LIMITER_LOCK();
+	probing = false; //Another caller can send probe
+}
+
+bool WorldTimeAPICircuitBreaker::isOpen() {
+	WTAPI_RATE_LIMITER_LOCK();
+	return open;
+}
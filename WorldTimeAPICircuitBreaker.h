@@ -0,0 +1,66 @@
+/**
+ * @file WorldTimeAPICircuitBreaker.h
+ * @brief This file contains circuit breaker, which stops requests when WorldTimeAPI is failing.
+ *
+ * @see WorldTimeAPICircuitBreaker
+ */
+
+#ifndef WORLD_TIME_API_CIRCUIT_BREAKER_H_
+#define WORLD_TIME_API_CIRCUIT_BREAKER_H_
+
+#include "WorldTimeAPIRateLimiter.h"
+
+/**
+* @class WorldTimeAPICircuitBreaker
+* @brief Circuit breaker of WorldTimeAPI requests. After given count of failures in a row (connection
+* errors, timeouts and 5xx responses), breaker opens and no request is sent for cool-down period.
+* After cool-down, one probe request is allowed. When it succeeds, breaker closes, otherwise it opens again.
+*/
+class WorldTimeAPICircuitBreaker {
+public:
+	WorldTimeAPICircuitBreaker();
+
+	/**
+	* @brief Sets breaker parameters.
+	* @param threshold Count of failures in a row, after which breaker opens. If set to 0, breaker is disabled (default).
+	* @param coolDown Time in milliseconds, for which breaker stays open.
+	*/
+	void setThreshold(uint8_t threshold, uint32_t coolDown);
+
+	/**
+	* @brief Checks, whether request can be sent. When cool-down elapsed, only one caller is allowed
+	* to send probe request and others are rejected until probe finishes.
+	* @return Returns true if request can be sent.
+	*/
+	bool allow();
+
+	/**
+	* @brief Updates breaker state from response. Has to be called after each allowed request.
+	* @param httpCode HTTP code of response.
+	*/
+	void onResponse(int httpCode);
+
+	/**
+	* @brief Has to be called instead of onResponse(), when allowed request was not sent at all.
+	*/
+	void cancel();
+
+	/**
+	* @brief Returns true if breaker is open (requests are rejected).
+	*/
+	bool isOpen();
+
+protected:
+	uint8_t threshold;
+	uint32_t coolDown;
+	uint8_t failures;
+	uint32_t openedAt;
+	bool open;
+	bool probing;
+
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+	std::mutex mutex;
+#endif // SJSONP_UNDER_OS || ESP32
+};
+
+#endif // !WORLD_TIME_API_CIRCUIT_BREAKER_H_
@@ -0,0 +1,76 @@
+/**
+ * @file WorldTimeAPIClock.h
+ * @brief This file contains monotonic clock used by WorldTimeAPI client.
+ *
+ * @see WorldTimeAPIClock
+ */
+
+#ifndef WORLD_TIME_API_CLOCK_H_
+#define WORLD_TIME_API_CLOCK_H_
+
+#include "SimpleJSONParser.h"
+
+#if defined(SJSONP_UNDER_OS)
+#include <chrono>
+#include <thread>
+#endif // SJSONP_UNDER_OS
+
+/**
+* @class WorldTimeAPIClock
+* @brief Monotonic millisecond clock. On arduino millis() is used, on OS steady clock is used.
+* Values overflows after ~49 days, so times has to be compared using elapsed() or isBefore().
+*/
+class WorldTimeAPIClock {
+public:
+	/**
+	* @brief Gets current time in milliseconds.
+	*/
+	static inline uint32_t now() {
+#if defined(SJSONP_UNDER_OS)
+		return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+		return millis();
+#endif // SJSONP_UNDER_OS
+	}
+
+	/**
+	* @brief Blocks current thread for given time.
+	* @param ms Time in milliseconds.
+	*/
+	static inline void sleep(uint32_t ms) {
+		if (ms == 0) return;
+#if defined(SJSONP_UNDER_OS)
+		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+#else
+		delay(ms);
+#endif // SJSONP_UNDER_OS
+	}
+
+	/**
+	* @brief Lets other threads run while busy waiting.
+	*/
+	static inline void relax() {
+#if defined(SJSONP_UNDER_OS)
+		std::this_thread::yield();
+#else
+		yield();
+#endif // SJSONP_UNDER_OS
+	}
+
+	/**
+	* @brief Gets time elapsed since given time.
+	* @param since Time obtained from now().
+	*/
+	static inline uint32_t elapsed(uint32_t since) {
+		return now() - since;
+	}
+
+	/**
+	* @brief Returns true if time a is before time b. Overflow is handled.
+	*/
+	static inline bool isBefore(uint32_t a, uint32_t b) {
+		return (int32_t)(a - b) < 0;
+	}
+};
+
+#endif // !WORLD_TIME_API_CLOCK_H_
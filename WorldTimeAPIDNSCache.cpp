@@ -0,0 +1,302 @@
+#include "WorldTimeAPIDNSCache.h"
+
+#if defined(SJSONP_UNDER_OS)
+#include <cstring>
+#if defined(_WIN64) || defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#endif // _WIN32
+#elif defined(ARDUINO)
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#endif
+#endif // SJSONP_UNDER_OS
+
+//Addresses are refreshed in background, when this part of TTL elapsed (in percent)
+#define WTAPI_DNS_REFRESH_AHEAD   (75)
+
+WorldTimeAPIDNSCache::WorldTimeAPIDNSCache() : ttl(300)
+{
+#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO) && !defined(SJSONP_UNDER_OS)
+	host[0] = 0;
+	resolvedAt = 0;
+	valid = false;
+#endif
+}
+
+WorldTimeAPIDNSCache::~WorldTimeAPIDNSCache() {
+#if defined(SJSONP_UNDER_OS)
+	std::unique_lock<std::mutex> lock(mutex);
+	refreshDone.wait(lock, [this] { return refreshCount == 0; });
+#endif // SJSONP_UNDER_OS
+}
+
+WorldTimeAPIDNSCache& WorldTimeAPIDNSCache::global() {
+	static WorldTimeAPIDNSCache cache;
+	return cache;
+}
+
+void WorldTimeAPIDNSCache::setTTL(uint32_t seconds) {
+	ttl = (seconds < WTAPI_DNS_MAX_TTL) ? seconds : WTAPI_DNS_MAX_TTL;
+}
+
+bool WorldTimeAPIDNSCache::parseURL(const char* url, char* host, int hostSize, uint16_t& port) {
+	if (url == NULL || hostSize <= 0) return false;
+	host[0] = 0;
+	port = 80;
+	const char* p = strstr(url, "://");
+	if (p != NULL) {
+		if (p - url == 5 && strncmp(url, "https", 5) == 0) {
+			port = 443;
+		}
+		p += 3;
+	}
+	else {
+		p = url;
+	}
+
+	int len = 0;
+	for (; p[len] != 0 && p[len] != '/' && p[len] != ':' && p[len] != '?'; len++);
+	if (len == 0 || len >= hostSize) {
+		return false; //Empty or too long host
+	}
+	memcpy(host, p, len);
+	host[len] = 0;
+
+	if (p[len] == ':') {
+		//Port
+		uint32_t val = 0;
+		int i = len + 1;
+		for (; p[i] >= '0' && p[i] <= '9' && val <= 0xFFFF; i++) {
+			val = val * 10 + (p[i] - '0');
+		}
+		if (i == len + 1 || val == 0 || val > 0xFFFF) {
+			return false; //Invalid port
+		}
+		port = (uint16_t)val;
+	}
+	return true;
+}
+
+#if defined(SJSONP_UNDER_OS)
+
+void WorldTimeAPIDNSCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+}
+
+bool WorldTimeAPIDNSCache::resolve(const char* host, std::vector<std::string>& addresses) {
+	if (host == NULL) return false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = entries.find(host);
+		if (it != entries.end() && !it->second.addresses.empty()) {
+			Entry& entry = it->second;
+			uint32_t age = WorldTimeAPIClock::elapsed(entry.resolvedAt);
+			if (age < ttl * 1000) {
+				if (age >= ttl * 10 * WTAPI_DNS_REFRESH_AHEAD && !entry.refreshing) {
+					//Will expire soon, refreshing in background
+					entry.refreshing = true;
+					refresh(it->first);
+				}
+				addresses = entry.addresses;
+				return true;
+			}
+		}
+	}
+
+	//Not cached or expired, resolving now
+	std::vector<std::string> resolved;
+	if (!lookup(host, resolved)) {
+		return false;
+	}
+	addresses = resolved;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	Entry& entry = entries[host];
+	entry.addresses = std::move(resolved);
+	entry.resolvedAt = WorldTimeAPIClock::now();
+	return true;
+}
+
+/**
+* @brief Copies address with given index to buffer.
+* @return Returns count of addresses or 0 if address does not exist or it does not fit to buffer.
+*/
+static uint8_t copyAddress(const std::vector<std::string>& addresses, uint8_t index, char* address, int addressSize) {
+	if (index >= addresses.size() || addresses[index].length() >= (size_t)addressSize) return 0;
+	strcpy(address, addresses[index].c_str());
+	return (uint8_t)(addresses.size() < 0xFF ? addresses.size() : 0xFF);
+}
+
+uint8_t WorldTimeAPIDNSCache::resolve(const char* host, uint8_t index, char* address, int addressSize) {
+	if (host == NULL || addressSize <= 0) return 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = entries.find(host);
+		if (it != entries.end() && WorldTimeAPIClock::elapsed(it->second.resolvedAt) < ttl * 10 * WTAPI_DNS_REFRESH_AHEAD) {
+			//Fresh entry, which does not need refresh yet
+			return copyAddress(it->second.addresses, index, address, addressSize);
+		}
+	}
+
+	//Not cached, expired or it should be refreshed
+	std::vector<std::string> addresses;
+	if (!resolve(host, addresses)) return 0;
+	return copyAddress(addresses, index, address, addressSize);
+}
+
+uint8_t WorldTimeAPIDNSCache::find(const char* host, uint8_t index, char* address, int addressSize) {
+	if (host == NULL || addressSize <= 0) return 0;
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = entries.find(host);
+	if (it == entries.end()) return 0;
+	Entry& entry = it->second;
+	uint32_t age = WorldTimeAPIClock::elapsed(entry.resolvedAt);
+	if (entry.addresses.empty() || age >= ttl * 1000) {
+		return 0; //Expired, caller has to resolve host
+	}
+	if (age >= ttl * 10 * WTAPI_DNS_REFRESH_AHEAD && !entry.refreshing) {
+		entry.refreshing = true;
+		refresh(it->first);
+	}
+	return copyAddress(entry.addresses, index, address, addressSize);
+}
+
+void WorldTimeAPIDNSCache::store(const char* host, const std::vector<std::string>& addresses) {
+	if (host == NULL || addresses.empty()) return;
+	std::lock_guard<std::mutex> lock(mutex);
+	Entry& entry = entries[host];
+	entry.addresses = addresses;
+	entry.resolvedAt = WorldTimeAPIClock::now();
+}
+
+void WorldTimeAPIDNSCache::markFailed(const char* host, const std::string& address) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = entries.find(host);
+	if (it == entries.end()) return;
+	std::vector<std::string>& addresses = it->second.addresses;
+	for (size_t i = 0; i < addresses.size(); i++) {
+		if (addresses[i] == address) {
+			//Moving failed address to the end
+			std::string failed = addresses[i];
+			addresses.erase(addresses.begin() + i);
+			addresses.push_back(failed);
+			break;
+		}
+	}
+}
+
+void WorldTimeAPIDNSCache::refresh(const std::string& host) {
+	//Must be called with locked mutex
+	refreshCount++;
+	std::thread([this, host]() {
+		std::vector<std::string> resolved;
+		bool ok = lookup(host.c_str(), resolved);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		Entry& entry = entries[host];
+		entry.refreshing = false;
+		if (ok) {
+			entry.addresses = std::move(resolved);
+			entry.resolvedAt = WorldTimeAPIClock::now();
+		}
+		refreshCount--;
+		refreshDone.notify_all();
+	}).detach();
+}
+
+bool WorldTimeAPIDNSCache::lookup(const char* host, std::vector<std::string>& addresses) {
+#if defined(_WIN64) || defined(_WIN32)
+	static bool wsaInit = false;
+	if (!wsaInit) {
+		WSADATA wsaData;
+		wsaInit = WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+	}
+#endif // _WIN32
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	addrinfo* res = NULL;
+	if (getaddrinfo(host, NULL, &hints, &res) != 0) {
+		return false;
+	}
+
+	addresses.clear();
+	char buf[64];
+	for (addrinfo* ai = res; ai != NULL; ai = ai->ai_next) {
+		if (ai->ai_family == AF_INET) {
+			if (inet_ntop(AF_INET, &((sockaddr_in*)ai->ai_addr)->sin_addr, buf, sizeof(buf)) != NULL) {
+				addresses.push_back(buf);
+			}
+		}
+		else if (ai->ai_family == AF_INET6) {
+			if (inet_ntop(AF_INET6, &((sockaddr_in6*)ai->ai_addr)->sin6_addr, buf + 1, sizeof(buf) - 2) != NULL) {
+				buf[0] = '[';
+				strcat(buf, "]");
+				addresses.push_back(buf);
+			}
+		}
+	}
+	freeaddrinfo(res);
+	return !addresses.empty();
+}
+
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+
+void WorldTimeAPIDNSCache::clear() {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> lock(mutex);
+#endif // ESP32
+	valid = false;
+}
+
+bool WorldTimeAPIDNSCache::resolve(const char* host_, IPAddress& address_) {
+	if (host_ == NULL) return false;
+	{
+#if defined(ESP32)
+		std::lock_guard<std::mutex> lock(mutex);
+#endif // ESP32
+		if (valid && strncmp(host, host_, WTAPI_DNS_HOST_SIZE) == 0 && WorldTimeAPIClock::elapsed(resolvedAt) < ttl * 1000) {
+			address_ = address;
+			return true;
+		}
+	}
+
+	//Resolving without lock, so other clients are not blocked by resolver
+	IPAddress resolved;
+	if (!WiFi.hostByName(host_, resolved)) {
+		return false;
+	}
+#if defined(ESP32)
+	std::lock_guard<std::mutex> lock(mutex);
+#endif // ESP32
+	strncpy(host, host_, WTAPI_DNS_HOST_SIZE - 1);
+	host[WTAPI_DNS_HOST_SIZE - 1] = 0;
+	address = resolved;
+	resolvedAt = WorldTimeAPIClock::now();
+	valid = true;
+	address_ = resolved;
+	return true;
+}
+
+void WorldTimeAPIDNSCache::markFailed(const char* host_) {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> lock(mutex);
+#endif // ESP32
+	if (strncmp(host, host_, WTAPI_DNS_HOST_SIZE) == 0) {
+		valid = false; //Will be resolved again
+	}
+}
+
+#endif // SJSONP_UNDER_OS
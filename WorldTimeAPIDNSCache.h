@@ -0,0 +1,198 @@
+/**
+ * @file WorldTimeAPIDNSCache.h
+ * @brief This file contains cache of resolved addresses of API host.
+ *
+ * @see WorldTimeAPIDNSCache
+ */
+
+#ifndef WORLD_TIME_API_DNS_CACHE_H_
+#define WORLD_TIME_API_DNS_CACHE_H_
+
+#include "WorldTimeAPIClock.h"
+
+#if defined(SJSONP_UNDER_OS)
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#elif defined(ARDUINO)
+#if defined(ESP8266) || defined(ESP32)
+#include <IPAddress.h>
+#endif
+#if defined(ESP32)
+#include <mutex>
+#endif
+#endif // SJSONP_UNDER_OS
+
+#define WTAPI_DNS_HOST_SIZE       (64)
+
+//The longest TTL in seconds, which can be measured by WorldTimeAPIClock in milliseconds
+#define WTAPI_DNS_MAX_TTL         (0xFFFFFFFFUL / 1000)
+
+/**
+* @class WorldTimeAPIDNSCache
+* @brief Cache of resolved host addresses. Resolved addresses are kept for TTL. On OS, addresses are
+* refreshed in background before they expire, so resolving is not done while request is sent.
+* When connection to one address fails, it is moved to the end of list, so next request uses another address.
+* @note Resolver of OS does not provide TTL of DNS records, so TTL has to be set by setTTL().
+*/
+class WorldTimeAPIDNSCache {
+public:
+	WorldTimeAPIDNSCache();
+
+	/**
+	* @brief Waits until background refreshes of addresses finish.
+	*/
+	~WorldTimeAPIDNSCache();
+
+	/**
+	* @brief Gets cache shared by all WorldTimeAPI clients.
+	*/
+	static WorldTimeAPIDNSCache& global();
+
+	/**
+	* @brief Sets time, for which resolved addresses are valid.
+	* @param seconds TTL in seconds. Default is 300 seconds. Longer TTL than WTAPI_DNS_MAX_TTL is shortened.
+	*/
+	void setTTL(uint32_t seconds);
+
+#if defined(SJSONP_UNDER_OS)
+	/**
+	* @brief Gets addresses of host. Preferred address is first.
+	* @param[in] host Host name.
+	* @param[out] addresses Resolved addresses. IPv6 addresses are enclosed in brackets.
+	* @return Returns true if at least one address was resolved.
+	*/
+	bool resolve(const char* host, std::vector<std::string>& addresses);
+
+	/**
+	* @brief Copies one address of host to buffer. When host is cached, no memory is allocated.
+	* @param[in] host Host name.
+	* @param[in] index Index of address, 0 is preferred address.
+	* @param[out] address Buffer for address. IPv6 address is enclosed in brackets.
+	* @param[in] addressSize Size of buffer including null terminator.
+	* @return Returns count of addresses of host or 0 if address with this index was not resolved.
+	*/
+	uint8_t resolve(const char* host, uint8_t index, char* address, int addressSize);
+
+	/**
+	* @brief Copies one cached address of host to buffer like resolve(), but host is never resolved here,
+	* so it does not block. Address, which will expire soon, is refreshed in background.
+	* @return Returns count of addresses of host or 0 if host is not cached, it expired or index is not valid.
+	*/
+	uint8_t find(const char* host, uint8_t index, char* address, int addressSize);
+
+	/**
+	* @brief Stores addresses of host, which were resolved outside of cache, for example by lookup().
+	* @param host Host name.
+	* @param addresses Resolved addresses. Preferred address is first.
+	*/
+	void store(const char* host, const std::vector<std::string>& addresses);
+
+	/**
+	* @brief Resolves host using resolver of OS. Cache is not used, it can be called from any thread.
+	* @param[in] host Host name.
+	* @param[out] addresses Resolved addresses. IPv6 addresses are enclosed in brackets.
+	* @return Returns true if at least one address was resolved.
+	*/
+	static bool lookup(const char* host, std::vector<std::string>& addresses);
+
+	/**
+	* @brief Marks address of host as failed, so another address will be preferred.
+	* @param host Host name.
+	* @param address Address, which failed.
+	*/
+	void markFailed(const char* host, const std::string& address);
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+	/**
+	* @brief Gets address of host.
+	* @param[in] host Host name.
+	* @param[out] address Resolved address.
+	* @return Returns true if address was resolved.
+	*/
+	bool resolve(const char* host, IPAddress& address);
+
+	/**
+	* @brief Marks address of host as failed, so host will be resolved again.
+	* @param host Host name.
+	*/
+	void markFailed(const char* host);
+#endif // SJSONP_UNDER_OS
+
+	/**
+	* @brief Removes all cached addresses.
+	*/
+	void clear();
+
+	/**
+	* @brief Gets host name and port from URL.
+	* @param[in] url URL, for example: "http://worldtimeapi.org/api/ip".
+	* @param[out] host Buffer for host name.
+	* @param[in] hostSize Size of host buffer including null terminator.
+	* @param[out] port Port from URL or default port of scheme.
+	* @return Returns true if URL was valid.
+	*/
+	static bool parseURL(const char* url, char* host, int hostSize, uint16_t& port);
+
+protected:
+
+	uint32_t ttl;
+
+#if defined(SJSONP_UNDER_OS)
+	struct Entry {
+		std::vector<std::string> addresses;
+		uint32_t resolvedAt = 0;
+		bool refreshing = false;
+	};
+
+	/**
+	* @brief Resolves host in background thread and updates entry.
+	*/
+	void refresh(const std::string& host);
+
+	/**
+	* @struct HostLess
+	* @brief Allows to find entry by const char* without creating std::string.
+	*/
+	struct HostLess {
+		typedef void is_transparent;
+
+		inline bool operator()(const std::string& a, const std::string& b) const {
+			return a < b;
+		}
+
+		inline bool operator()(const std::string& a, const char* b) const {
+			return a.compare(b) < 0;
+		}
+
+		inline bool operator()(const char* a, const std::string& b) const {
+			return b.compare(a) > 0;
+		}
+	};
+
+	std::mutex mutex;
+	std::map<std::string, Entry, HostLess> entries;
+
+	/**
+	* @brief Count of running background refreshes.
+	*/
+	uint16_t refreshCount = 0;
+
+	/**
+	* @brief Signaled, when background refresh finishes.
+	*/
+	std::condition_variable refreshDone;
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+	char host[WTAPI_DNS_HOST_SIZE];
+	IPAddress address;
+	uint32_t resolvedAt;
+	bool valid;
+#if defined(ESP32)
+	std::mutex mutex; //Cache is shared by clients in different tasks
+#endif // ESP32
+#endif // SJSONP_UNDER_OS
+};
+
+#endif // !WORLD_TIME_API_DNS_CACHE_H_
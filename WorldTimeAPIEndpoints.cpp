@@ -0,0 +1,119 @@
+#include "WorldTimeAPIEndpoints.h"
+
+#ifdef WTAPI_ENDPOINTS
+
+/**
+* @brief Moves average towards sample by 1/2^shift of difference.
+* @param seed If true, first sample (average is 0) is taken as it is.
+*/
+static void updateAverage(std::atomic<uint32_t>& average, uint32_t sample, uint8_t shift, bool seed) {
+	uint32_t old = average.load(std::memory_order_relaxed);
+	uint32_t next;
+	do {
+		next = (seed && old == 0) ? sample : (uint32_t)((int32_t)old + (((int32_t)sample - (int32_t)old) >> shift));
+	} while (!average.compare_exchange_weak(old, next, std::memory_order_relaxed));
+}
+
+WorldTimeAPIEndpoints::WorldTimeAPIEndpoints() :
+	count(0),
+	selections(0),
+	coolDown(5000)
+{
+	clear();
+}
+
+bool WorldTimeAPIEndpoints::add(const char* baseURL) {
+	uint8_t n = count.load(std::memory_order_relaxed);
+	if (baseURL == NULL || n >= WTAPI_MAX_ENDPOINTS) {
+		return false;
+	}
+	Endpoint& ep = endpoints[n];
+	ep.url = baseURL;
+	ep.latency.store(0, std::memory_order_relaxed);
+	ep.errors.store(0, std::memory_order_relaxed);
+	ep.retryAt.store(WorldTimeAPIClock::now(), std::memory_order_relaxed);
+	ep.failures.store(0, std::memory_order_relaxed);
+	count.store(n + 1, std::memory_order_release);
+	return true;
+}
+
+void WorldTimeAPIEndpoints::clear() {
+	count.store(0, std::memory_order_release);
+	for (uint8_t i = 0; i < WTAPI_MAX_ENDPOINTS; i++) {
+		endpoints[i].url = NULL;
+	}
+}
+
+bool WorldTimeAPIEndpoints::isHealthy(uint8_t index) const {
+	return !WorldTimeAPIClock::isBefore(WorldTimeAPIClock::now(), endpoints[index].retryAt.load(std::memory_order_relaxed));
+}
+
+uint8_t WorldTimeAPIEndpoints::available(uint32_t excluded) const {
+	uint8_t n = size();
+	uint8_t res = 0;
+	for (uint8_t i = 0; i < n; i++) {
+		if ((excluded & (1UL << i)) == 0) res++;
+	}
+	return res;
+}
+
+int8_t WorldTimeAPIEndpoints::select(uint32_t excluded) {
+	uint8_t n = size();
+	if (n == 0) return -1;
+	uint32_t now = WorldTimeAPIClock::now();
+	uint32_t turn = selections.fetch_add(1, std::memory_order_relaxed);
+
+	if ((turn & 31) == 31) {
+		//Exploring, so estimates of slower endpoints are updated too
+		uint8_t i = (uint8_t)((turn >> 5) % n);
+		if ((excluded & (1UL << i)) == 0 && !WorldTimeAPIClock::isBefore(now, endpoints[i].retryAt.load(std::memory_order_relaxed))) {
+			return (int8_t)i;
+		}
+	}
+
+	int8_t best = -1;
+	uint64_t bestScore = 0;
+	int8_t coolest = -1;
+	uint32_t coolestRetry = 0;
+	for (uint8_t i = 0; i < n; i++) {
+		if ((excluded & (1UL << i)) != 0) continue;
+		const Endpoint& ep = endpoints[i];
+		uint32_t retryAt = ep.retryAt.load(std::memory_order_relaxed);
+		if (WorldTimeAPIClock::isBefore(now, retryAt)) {
+			//In cool down
+			if (coolest < 0 || WorldTimeAPIClock::isBefore(retryAt, coolestRetry)) {
+				coolest = (int8_t)i;
+				coolestRetry = retryAt;
+			}
+			continue;
+		}
+		//Latency is weighted by error rate, endpoint failing all requests counts as 4 times slower
+		uint64_t score = (uint64_t)ep.latency.load(std::memory_order_relaxed) * (65536 + 3 * ep.errors.load(std::memory_order_relaxed));
+		if (best < 0 || score < bestScore) {
+			best = (int8_t)i;
+			bestScore = score;
+		}
+	}
+	return best >= 0 ? best : coolest;
+}
+
+void WorldTimeAPIEndpoints::onResponse(uint8_t index, int httpCode, uint32_t latency) {
+	if (index >= size()) return;
+	Endpoint& ep = endpoints[index];
+	if (isFailure(httpCode)) {
+		updateAverage(ep.errors, 65535, 2, false);
+		uint8_t failures = ep.failures.load(std::memory_order_relaxed);
+		if (failures < 0xFF) ep.failures.store(failures + 1, std::memory_order_relaxed);
+		uint8_t shift = failures < 4 ? failures : 4;
+		ep.retryAt.store(WorldTimeAPIClock::now() + (coolDown << shift), std::memory_order_relaxed);
+		return;
+	}
+	updateAverage(ep.errors, 0, 2, false);
+	ep.failures.store(0, std::memory_order_relaxed);
+	if (httpCode > 0) {
+		uint32_t sample = latency < 0x100000 ? latency : 0xFFFFF;
+		updateAverage(ep.latency, (sample << 4) | 1, 3, true); //Lowest bit keeps measured latency non-zero
+	}
+}
+
+#endif // WTAPI_ENDPOINTS
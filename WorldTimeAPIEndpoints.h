@@ -0,0 +1,150 @@
+/**
+ * @file WorldTimeAPIEndpoints.h
+ * @brief This file contains list of API endpoints (mirrors or proxies) with latency and error estimates.
+ *
+ * @see WorldTimeAPIEndpoints
+ */
+
+#ifndef WORLD_TIME_API_ENDPOINTS_H_
+#define WORLD_TIME_API_ENDPOINTS_H_
+
+#include "WorldTimeAPIClock.h"
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+//Endpoints are used only by transports of OS, ESP8266 and ESP32
+#define WTAPI_ENDPOINTS (1)
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#ifdef WTAPI_ENDPOINTS
+#include <atomic>
+
+#if defined(SJSONP_UNDER_OS)
+#define WTAPI_MAX_ENDPOINTS       (8)
+#else
+#define WTAPI_MAX_ENDPOINTS       (4)
+#endif // SJSONP_UNDER_OS
+
+/**
+* @class WorldTimeAPIEndpoints
+* @brief List of base URLs of API, for example mirrors or caching proxy, with moving average of latency
+* and error rate of each one. Client sends request to fastest healthy endpoint and when it fails, another
+* endpoint is tried until deadline of request. Endpoint, which failed, is skipped for cool down time
+* (doubled with every consecutive failure, up to 16 times). Selection and updates use only atomics,
+* so list can be shared by multiple clients and threads.
+*
+* @code
+* WorldTimeAPIEndpoints endpoints;
+* endpoints.add("http://proxy.local:8080/api");
+* endpoints.add("http://worldtimeapi.org/api");
+* api.setEndpoints(&endpoints);
+* @endcode
+* @note URLs are not copied, they have to exist while list is used. Endpoints have to be added before
+* list is used by client.
+* @see WorldTimeAPI::setEndpoints()
+*/
+class WorldTimeAPIEndpoints {
+public:
+	WorldTimeAPIEndpoints();
+
+	/**
+	* @brief Adds endpoint.
+	* @param baseURL Base URL of API without trailing slash, for example: "http://worldtimeapi.org/api".
+	* Paths "/timezone" and "/ip" are appended to it.
+	* @return Returns false if there is no space for another endpoint.
+	*/
+	bool add(const char* baseURL);
+
+	/**
+	* @brief Removes all endpoints.
+	*/
+	void clear();
+
+	/**
+	* @brief Sets cool down time, for which failed endpoint is skipped.
+	* @param ms Time in milliseconds. Default is 5000 ms.
+	*/
+	inline void setCoolDown(uint32_t ms) {
+		coolDown = ms;
+	}
+
+	/**
+	* @brief Gets count of endpoints.
+	*/
+	inline uint8_t size() const {
+		return count.load(std::memory_order_acquire);
+	}
+
+	/**
+	* @brief Gets base URL of endpoint.
+	*/
+	inline const char* getURL(uint8_t index) const {
+		return endpoints[index].url;
+	}
+
+	/**
+	* @brief Gets moving average of latency of endpoint in milliseconds or 0 if it was not measured yet.
+	*/
+	inline uint32_t getLatency(uint8_t index) const {
+		return (endpoints[index].latency.load(std::memory_order_relaxed) + 8) >> 4;
+	}
+
+	/**
+	* @brief Gets moving average of error rate of endpoint (0 - no errors, 65535 - all requests failed).
+	*/
+	inline uint16_t getErrorRate(uint8_t index) const {
+		return (uint16_t)endpoints[index].errors.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Returns true if endpoint is not in cool down after failure.
+	*/
+	bool isHealthy(uint8_t index) const;
+
+	/**
+	* @brief Selects endpoint for next request. Healthy endpoint with lowest latency weighted by error rate
+	* is selected, endpoints without measured latency are preferred. Every 32nd selection tries healthy
+	* endpoints in turn, so their estimates are kept up to date. When all endpoints are in cool down,
+	* the one, whose cool down ends first, is selected.
+	* @param excluded Bit mask of endpoints, which cannot be selected (already tried).
+	* @return Returns index of endpoint or -1 if all endpoints are excluded.
+	*/
+	int8_t select(uint32_t excluded = 0);
+
+	/**
+	* @brief Gets count of endpoints, which are not excluded.
+	*/
+	uint8_t available(uint32_t excluded) const;
+
+	/**
+	* @brief Updates estimates of endpoint by result of request.
+	* @param index Index of endpoint.
+	* @param httpCode HTTP code or negative error code of request.
+	* @param latency Duration of request in milliseconds.
+	*/
+	void onResponse(uint8_t index, int httpCode, uint32_t latency);
+
+	/**
+	* @brief Returns true if HTTP code means, that endpoint is failing (connection error or server error).
+	*/
+	static inline bool isFailure(int httpCode) {
+		return (httpCode < 0 && httpCode >= -11) || httpCode >= 500;
+	}
+
+protected:
+	struct Endpoint {
+		const char* url;
+		std::atomic<uint32_t> latency;  //Moving average in 1/16 ms, 0 if not measured
+		std::atomic<uint32_t> errors;   //Moving average of failures, 0 - 65535
+		std::atomic<uint32_t> retryAt;  //Time, until which endpoint is skipped
+		std::atomic<uint8_t> failures;  //Consecutive failures
+	};
+
+	Endpoint endpoints[WTAPI_MAX_ENDPOINTS];
+	std::atomic<uint8_t> count;
+	std::atomic<uint32_t> selections;
+	uint32_t coolDown;
+};
+
+#endif // WTAPI_ENDPOINTS
+
+#endif // !WORLD_TIME_API_ENDPOINTS_H_
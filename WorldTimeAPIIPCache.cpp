@@ -0,0 +1,144 @@
+#include "WorldTimeAPIIPCache.h"
+
+#ifdef WTAPI_IP_CACHE
+#include <string.h>
+
+static_assert(sizeof(WorldTimeAPIIPCache::Entry) % sizeof(uint64_t) == 0, "Entry has to be copied by 64-bit words");
+
+//Reader gives up after this count of attempts and reports miss
+#define WTAPI_IP_CACHE_READ_ATTEMPTS (4)
+
+WorldTimeAPIIPCache::WorldTimeAPIIPCache(size_t budget, uint8_t prefixLength_, uint32_t ttl_) :
+	prefixLength(prefixLength_ < 8 ? 8 : (prefixLength_ > 32 ? 32 : prefixLength_)),
+	ttl(ttl_)
+{
+	//Count of sets is power of 2, which fits into budget
+	size_t sets = budget / (sizeof(Slot) * WTAPI_IP_CACHE_WAYS + sizeof(uint8_t));
+	setCount = 1;
+	while ((size_t)setCount * 2 <= sets && setCount < 0x10000000u) {
+		setCount *= 2;
+	}
+	slots = new Slot[(size_t)setCount * WTAPI_IP_CACHE_WAYS];
+	hands = new uint8_t[setCount];
+	for (size_t i = 0; i < (size_t)setCount * WTAPI_IP_CACHE_WAYS; i++) {
+		slots[i].seq.store(0, std::memory_order_relaxed);
+		slots[i].referenced.store(0, std::memory_order_relaxed);
+		for (int w = 0; w < WORDS; w++) {
+			slots[i].words[w].store(0, std::memory_order_relaxed);
+		}
+	}
+	memset(hands, 0, setCount);
+}
+
+WorldTimeAPIIPCache::~WorldTimeAPIIPCache() {
+	delete[] slots;
+	delete[] hands;
+}
+
+bool WorldTimeAPIIPCache::read(const Slot& slot, Entry& entry) {
+	uint64_t words[WORDS];
+	uint32_t seq = slot.seq.load(std::memory_order_acquire);
+	if (seq & 1) {
+		return false; //Writer is active
+	}
+	for (int w = 0; w < WORDS; w++) {
+		words[w] = slot.words[w].load(std::memory_order_relaxed);
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (slot.seq.load(std::memory_order_relaxed) != seq) {
+		return false; //Entry was changed while reading
+	}
+	memcpy(&entry, words, sizeof(Entry));
+	return true;
+}
+
+void WorldTimeAPIIPCache::write(Slot& slot, const Entry& entry) {
+	uint64_t words[WORDS];
+	memcpy(words, &entry, sizeof(Entry));
+	uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+	slot.seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (int w = 0; w < WORDS; w++) {
+		slot.words[w].store(words[w], std::memory_order_relaxed);
+	}
+	slot.seq.store(seq + 2, std::memory_order_release);
+}
+
+bool WorldTimeAPIIPCache::lookup(uint32_t ip, Entry& entry) const {
+	uint32_t prefix = mask(ip);
+	Slot* set = &slots[(size_t)setOf(prefix) * WTAPI_IP_CACHE_WAYS];
+	for (int way = 0; way < WTAPI_IP_CACHE_WAYS; way++) {
+		for (int attempt = 0; attempt < WTAPI_IP_CACHE_READ_ATTEMPTS; attempt++) {
+			if (read(set[way], entry)) {
+				if ((entry.flags & FLAG_VALID) && entry.prefix == prefix) {
+					if (WorldTimeAPIClock::elapsed(entry.fetchedAt) >= ttl) {
+						return false; //Expired
+					}
+					if (set[way].referenced.load(std::memory_order_relaxed) == 0) {
+						set[way].referenced.store(1, std::memory_order_relaxed);
+					}
+					return true;
+				}
+				break; //Another network
+			}
+			WorldTimeAPIClock::relax();
+		}
+	}
+	return false;
+}
+
+void WorldTimeAPIIPCache::learn(uint32_t ip, const Entry& entry) {
+	Entry e = entry;
+	e.prefix = mask(ip);
+	e.fetchedAt = WorldTimeAPIClock::now();
+	e.flags |= FLAG_VALID;
+	memset(e.reserved, 0, sizeof(e.reserved));
+
+	uint32_t set = setOf(e.prefix);
+	Slot* ways = &slots[(size_t)set * WTAPI_IP_CACHE_WAYS];
+	std::lock_guard<std::mutex> lock(mutex);
+	int victim = -1;
+	for (int way = 0; way < WTAPI_IP_CACHE_WAYS; way++) {
+		Entry old;
+		read(ways[way], old); //Writers are serialized, so read cannot fail
+		if (!(old.flags & FLAG_VALID) || old.prefix == e.prefix) {
+			victim = way;
+			if (old.prefix == e.prefix) break;
+		}
+	}
+	while (victim < 0) {
+		//CLOCK: skip entries used since last pass
+		uint8_t& hand = hands[set];
+		if (ways[hand].referenced.exchange(0, std::memory_order_relaxed) == 0) {
+			victim = hand;
+		}
+		hand = (hand + 1) % WTAPI_IP_CACHE_WAYS;
+	}
+	ways[victim].referenced.store(1, std::memory_order_relaxed);
+	write(ways[victim], e);
+}
+
+void WorldTimeAPIIPCache::forget(uint32_t ip) {
+	uint32_t prefix = mask(ip);
+	Slot* ways = &slots[(size_t)setOf(prefix) * WTAPI_IP_CACHE_WAYS];
+	std::lock_guard<std::mutex> lock(mutex);
+	for (int way = 0; way < WTAPI_IP_CACHE_WAYS; way++) {
+		Entry old;
+		read(ways[way], old);
+		if ((old.flags & FLAG_VALID) && old.prefix == prefix) {
+			memset(&old, 0, sizeof(old));
+			write(ways[way], old);
+		}
+	}
+}
+
+void WorldTimeAPIIPCache::clear() {
+	Entry empty;
+	memset(&empty, 0, sizeof(empty));
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < (size_t)setCount * WTAPI_IP_CACHE_WAYS; i++) {
+		write(slots[i], empty);
+		slots[i].referenced.store(0, std::memory_order_relaxed);
+	}
+}
+#endif // WTAPI_IP_CACHE
@@ -0,0 +1,148 @@
+/**
+ * @file WorldTimeAPIIPCache.h
+ * @brief This file contains cache of time zones learned for IPv4 networks.
+ *
+ * @see WorldTimeAPIIPCache
+ */
+
+#ifndef WORLD_TIME_API_IP_CACHE_H_
+#define WORLD_TIME_API_IP_CACHE_H_
+
+#include "WorldTimeAPIClock.h"
+
+#if defined(SJSONP_UNDER_OS)
+//Cache is intended for servers, which look up many client addresses
+#define WTAPI_IP_CACHE (1)
+#endif // SJSONP_UNDER_OS
+
+#ifdef WTAPI_IP_CACHE
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+
+#define WTAPI_IP_CACHE_WAYS       (4)
+
+/**
+* @class WorldTimeAPIIPCache
+* @brief Cache of time zones of IPv4 networks. Every result of getByIP() is learned for whole network
+* (address masked by prefix length, /24 by default), so later lookups of addresses from the same network
+* are answered from memory. Networks are stored in set-associative table, which fits into memory budget.
+* When set is full, entry, which was not used recently, is evicted (CLOCK approximation of LRU).
+* Lookups do not lock, every entry is guarded by sequence lock and readers retry when entry is
+* being written.
+*/
+class WorldTimeAPIIPCache {
+public:
+
+	/**
+	* @struct Entry
+	* @brief Time zone informations learned for network.
+	*/
+	struct Entry {
+		uint32_t prefix;      //Network address
+		uint32_t fetchedAt;   //Time of response, see WorldTimeAPIClock
+		int32_t rawOffset;
+		int16_t dstOffset;
+		uint16_t timezoneId;  //See WorldTimeAPIIntern
+		int64_t dstFrom;
+		int64_t dstUntil;
+		char abbreviation[8];
+		uint8_t flags;        //FLAG_ values
+		uint8_t reserved[7];
+	};
+
+	static const uint8_t FLAG_VALID = 1;   //Entry is used
+	static const uint8_t FLAG_DST = 2;     //DST was applied when response was received
+	static const uint8_t FLAG_NO_DST = 4;  //Time zone has no DST
+
+	/**
+	* @brief Creates cache.
+	* @param budget Memory in bytes used by table of entries. Default is 64 kB (about 1000 networks).
+	* @param prefixLength Prefix length of learned networks (8 - 32). Default is 24.
+	* @param ttl Time in milliseconds, for which entry is valid. Default is 1 day.
+	*/
+	WorldTimeAPIIPCache(size_t budget = 65536, uint8_t prefixLength = 24, uint32_t ttl = 86400000);
+	~WorldTimeAPIIPCache();
+
+	WorldTimeAPIIPCache(const WorldTimeAPIIPCache&) = delete;
+	WorldTimeAPIIPCache& operator=(const WorldTimeAPIIPCache&) = delete;
+
+	/**
+	* @brief Finds network of address. Does not lock.
+	* @param[in] ip IPv4 address, first octet in most significant byte.
+	* @param[out] entry Learned time zone informations.
+	* @return Returns true if network was found and entry is not older than TTL.
+	*/
+	bool lookup(uint32_t ip, Entry& entry) const;
+
+	/**
+	* @brief Stores time zone informations for network of address.
+	* @param ip IPv4 address, first octet in most significant byte.
+	* @param entry Time zone informations. Prefix and fetchedAt are set by cache.
+	*/
+	void learn(uint32_t ip, const Entry& entry);
+
+	/**
+	* @brief Removes address from cache, for example when result was found wrong.
+	*/
+	void forget(uint32_t ip);
+
+	/**
+	* @brief Removes all entries.
+	*/
+	void clear();
+
+	/**
+	* @brief Gets count of entries, which can be stored.
+	*/
+	inline size_t capacity() const {
+		return (size_t)setCount * WTAPI_IP_CACHE_WAYS;
+	}
+
+	/**
+	* @brief Gets prefix length of learned networks.
+	*/
+	inline uint8_t getPrefixLength() const {
+		return prefixLength;
+	}
+
+protected:
+	static const int WORDS = sizeof(Entry) / sizeof(uint64_t);
+
+	struct Slot {
+		std::atomic<uint32_t> seq;        //Odd while entry is written
+		std::atomic<uint8_t> referenced;  //Set by readers, cleared by CLOCK hand
+		std::atomic<uint64_t> words[WORDS];
+	};
+
+	inline uint32_t mask(uint32_t ip) const {
+		return prefixLength >= 32 ? ip : (ip & ~(0xFFFFFFFFu >> prefixLength));
+	}
+
+	inline uint32_t setOf(uint32_t prefix) const {
+		uint32_t h = prefix * 2654435761u;
+		return (h ^ (h >> 16)) & (setCount - 1);
+	}
+
+	/**
+	* @brief Reads consistent copy of slot.
+	* @return Returns false if slot was being written.
+	*/
+	static bool read(const Slot& slot, Entry& entry);
+
+	/**
+	* @brief Writes slot (only under mutex).
+	*/
+	static void write(Slot& slot, const Entry& entry);
+
+	Slot* slots;
+	uint8_t* hands; //CLOCK hand of every set
+	uint32_t setCount;
+	uint8_t prefixLength;
+	uint32_t ttl;
+	std::mutex mutex; //Guards writers
+};
+
+#endif // WTAPI_IP_CACHE
+
+#endif // !WORLD_TIME_API_IP_CACHE_H_
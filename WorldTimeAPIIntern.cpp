@@ -0,0 +1,109 @@
+#include "WorldTimeAPIIntern.h"
+
+#include <stdlib.h>
+
+WorldTimeAPIIntern::WorldTimeAPIIntern() : count(0)
+{
+	memset(strings, 0, sizeof(strings));
+	memset(buckets, 0, sizeof(buckets));
+}
+
+WorldTimeAPIIntern::~WorldTimeAPIIntern() {
+	for (uint16_t i = 0; i < WTAPI_INTERN_CAPACITY; i++) {
+		free((void*)strings[i]);
+	}
+}
+
+WorldTimeAPIIntern& WorldTimeAPIIntern::global() {
+	static WorldTimeAPIIntern table;
+	return table;
+}
+
+uint32_t WorldTimeAPIIntern::hash(const char* text, int length) {
+	//FNV-1a
+	uint32_t h = 2166136261u;
+	for (int i = 0; i < length; i++) {
+		h = (h ^ (uint8_t)text[i]) * 16777619u;
+	}
+	return h;
+}
+
+uint16_t WorldTimeAPIIntern::bucketOf(const char* text, int length, uint32_t h) const {
+	uint16_t b = (uint16_t)(h & (BUCKETS - 1));
+	while (buckets[b] != 0) {
+		const char* str = strings[buckets[b] - 1];
+		if (strncmp(str, text, length) == 0 && str[length] == 0) {
+			break; //Found
+		}
+		b = (b + 1) & (BUCKETS - 1); //Linear probing
+	}
+	return b;
+}
+
+uint16_t WorldTimeAPIIntern::find(const char* text, int length) {
+	if (text == NULL || length <= 0 || length > WTAPI_INTERN_MAX_LENGTH) {
+		return 0;
+	}
+	WTAPI_INTERN_LOCK();
+	return buckets[bucketOf(text, length, hash(text, length))];
+}
+
+uint16_t WorldTimeAPIIntern::intern(const char* text, int length) {
+	if (text == NULL || length <= 0 || length > WTAPI_INTERN_MAX_LENGTH) {
+		return 0;
+	}
+	uint32_t h = hash(text, length);
+	WTAPI_INTERN_LOCK();
+	uint16_t b = bucketOf(text, length, h);
+	if (buckets[b] != 0) {
+		return buckets[b];
+	}
+	uint16_t n = count;
+	if (n >= WTAPI_INTERN_CAPACITY) {
+		return 0; //Table is full
+	}
+	char* str = (char*)malloc(length + 1);
+	if (str == NULL) {
+		return 0;
+	}
+	memcpy(str, text, length);
+	str[length] = 0;
+	strings[n] = str;
+	buckets[b] = n + 1;
+	count = n + 1; //String is stored before it is visible to get()
+	return n + 1;
+}
+
+
+WorldTimeAPIErrors::WorldTimeAPIErrors() : count(0)
+{
+	memset(messages, 0, sizeof(messages));
+}
+
+WorldTimeAPIErrors& WorldTimeAPIErrors::global() {
+	static WorldTimeAPIErrors table;
+	return table;
+}
+
+uint8_t WorldTimeAPIErrors::store(const char* text, int length) {
+	if (text == NULL || length <= 0) {
+		return 0;
+	}
+	if (length >= WTAPI_ERROR_SIZE) {
+		length = WTAPI_ERROR_SIZE - 1; //Message is truncated
+	}
+	WTAPI_INTERN_LOCK();
+	uint8_t n = count;
+	for (uint8_t i = 0; i < n; i++) {
+		if (strncmp(messages[i], text, length) == 0 && messages[i][length] == 0) {
+			return i + 1;
+		}
+	}
+	if (n >= WTAPI_ERROR_COUNT) {
+		return 0; //Table is full
+	}
+	memcpy(messages[n], text, length);
+	messages[n][length] = 0;
+	count = n + 1; //Message is stored before it is visible to get()
+	return n + 1;
+}
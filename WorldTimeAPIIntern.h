@@ -0,0 +1,157 @@
+/**
+ * @file WorldTimeAPIIntern.h
+ * @brief This file contains tables of interned time zone names and error messages.
+ *
+ * @see WorldTimeAPIIntern
+ * @see WorldTimeAPIErrors
+ */
+
+#ifndef WORLD_TIME_API_INTERN_H_
+#define WORLD_TIME_API_INTERN_H_
+
+#include "SimpleJSONParser.h"
+
+#include <string.h>
+
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+#include <mutex>
+#include <atomic>
+#define WTAPI_INTERN_LOCK() std::lock_guard<std::mutex> lock(mutex)
+#else
+#define WTAPI_INTERN_LOCK()
+#endif // SJSONP_UNDER_OS || ESP32
+
+#if defined(SJSONP_UNDER_OS)
+#define WTAPI_INTERN_CAPACITY     (4096)
+#else
+#define WTAPI_INTERN_CAPACITY     (64)
+#endif // SJSONP_UNDER_OS
+
+#define WTAPI_INTERN_MAX_LENGTH   (255)
+
+#if defined(SJSONP_UNDER_OS)
+#define WTAPI_ERROR_COUNT         (16)
+#else
+#define WTAPI_ERROR_COUNT         (4)
+#endif // SJSONP_UNDER_OS
+#define WTAPI_ERROR_SIZE          (64)
+
+/**
+* @class WorldTimeAPIIntern
+* @brief Table of interned strings. Every distinct string is stored only once and is identified by 16-bit ID,
+* so results can keep ID instead of copy of string. Strings are never removed, so pointers returned
+* by get() are valid until end of program. Reading by ID does not lock.
+* @note When table is full, intern() returns 0 (empty string).
+*/
+class WorldTimeAPIIntern {
+public:
+	/**
+	* @brief Gets table shared by all WorldTimeAPI clients.
+	*/
+	static WorldTimeAPIIntern& global();
+
+	WorldTimeAPIIntern();
+	~WorldTimeAPIIntern();
+
+	/**
+	* @brief Gets ID of string. If string is not in table yet, it is added.
+	* @param text String (does not have to be null terminated).
+	* @param length Length of string.
+	* @return Returns ID of string or 0 for empty string, too long string (over WTAPI_INTERN_MAX_LENGTH)
+	* or when table is full.
+	*/
+	uint16_t intern(const char* text, int length);
+
+	/**
+	* @brief Gets ID of null terminated string. See intern(const char*, int).
+	*/
+	inline uint16_t intern(const char* text) {
+		return text == NULL ? 0 : intern(text, (int)strnlen(text, WTAPI_INTERN_MAX_LENGTH + 1));
+	}
+
+	/**
+	* @brief Gets ID of string without adding it.
+	* @return Returns ID of string or 0 if string is not in table.
+	*/
+	uint16_t find(const char* text, int length);
+
+	/**
+	* @brief Gets string by ID.
+	* @return Returns null terminated string or empty string if ID is 0 or unknown.
+	*/
+	inline const char* get(uint16_t id) const {
+		return (id == 0 || id > count) ? "" : strings[id - 1];
+	}
+
+	/**
+	* @brief Gets count of strings in table.
+	*/
+	inline uint16_t size() const {
+		return count;
+	}
+
+protected:
+	//Size of hash table, power of 2 and at least twice the capacity
+	static const uint16_t BUCKETS = WTAPI_INTERN_CAPACITY * 2;
+
+	static uint32_t hash(const char* text, int length);
+
+	/**
+	* @brief Finds bucket of string. Bucket is empty if string is not in table.
+	*/
+	uint16_t bucketOf(const char* text, int length, uint32_t h) const;
+
+	const char* strings[WTAPI_INTERN_CAPACITY];
+	uint16_t buckets[BUCKETS]; //IDs, 0 - empty
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+	std::atomic<uint16_t> count;
+	std::mutex mutex;
+#else
+	uint16_t count;
+#endif // SJSONP_UNDER_OS || ESP32
+};
+
+/**
+* @class WorldTimeAPIErrors
+* @brief Small table of error messages sent by WorldTimeAPI. Messages are copied to fixed buffers
+* (WTAPI_ERROR_COUNT messages of at most WTAPI_ERROR_SIZE - 1 characters) and every distinct message is
+* stored only once. Table does not allocate and it is separate from WorldTimeAPIIntern, so messages
+* cannot take place of time zone names. Reading by ID does not lock.
+* @note When table is full, store() returns 0 (empty string).
+*/
+class WorldTimeAPIErrors {
+public:
+	/**
+	* @brief Gets table shared by all WorldTimeAPI clients.
+	*/
+	static WorldTimeAPIErrors& global();
+
+	WorldTimeAPIErrors();
+
+	/**
+	* @brief Gets ID of message. If message is not in table yet, it is added.
+	* @param text Message (does not have to be null terminated). Longer message is truncated.
+	* @param length Length of message.
+	* @return Returns ID of message or 0 for empty message or when table is full.
+	*/
+	uint8_t store(const char* text, int length);
+
+	/**
+	* @brief Gets message by ID.
+	* @return Returns null terminated message or empty string if ID is 0 or unknown.
+	*/
+	inline const char* get(uint8_t id) const {
+		return (id == 0 || id > count) ? "" : messages[id - 1];
+	}
+
+protected:
+	char messages[WTAPI_ERROR_COUNT][WTAPI_ERROR_SIZE];
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+	std::atomic<uint8_t> count;
+	std::mutex mutex;
+#else
+	uint8_t count;
+#endif // SJSONP_UNDER_OS || ESP32
+};
+
+#endif // !WORLD_TIME_API_INTERN_H_
@@ -0,0 +1,525 @@
+#include "WorldTimeAPILookup.h"
+
+#include <cstring>
+#include <stdio.h>
+
+#if defined(WTAPI_POSIX_SOCKET)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL (0)
+#endif // !MSG_NOSIGNAL
+
+WorldTimeAPIPosixSocket::~WorldTimeAPIPosixSocket() {
+	close();
+}
+
+bool WorldTimeAPIPosixSocket::connect(const char* host_, uint16_t port_, WorldTimeAPIDNSCache* dns_) {
+	close();
+	dns = dns_;
+	strncpy(host, host_, sizeof(host) - 1);
+	host[sizeof(host) - 1] = 0;
+	port = port_;
+	address.clear();
+
+	char cached[64];
+	if (dns != NULL && dns->find(host, 0, cached, sizeof(cached)) > 0) {
+		address = cached;
+		return open(true);
+	}
+	if (open(true)) {
+		return true; //Host is numeric address
+	}
+
+	//Resolving in helper thread, connected() checks result
+	std::shared_ptr<ResolveJob> started = std::make_shared<ResolveJob>();
+	std::string name = host;
+	std::thread([started, name]() {
+		std::vector<std::string> addresses;
+		WorldTimeAPIDNSCache::lookup(name.c_str(), addresses);
+		std::lock_guard<std::mutex> lock(started->mutex);
+		started->addresses = std::move(addresses);
+		started->done = true;
+	}).detach();
+	job = started;
+	state = 0;
+	return true;
+}
+
+bool WorldTimeAPIPosixSocket::open(bool numericOnly) {
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if (numericOnly) {
+		hints.ai_flags = AI_NUMERICHOST;
+	}
+	std::string numeric = address;
+	if (numeric.size() > 2 && numeric[0] == '[') {
+		//IPv6 addresses are enclosed in brackets
+		numeric = numeric.substr(1, numeric.size() - 2);
+	}
+
+	char service[8];
+	snprintf(service, sizeof(service), "%u", (unsigned)port);
+	struct addrinfo* info = NULL;
+	if (getaddrinfo(numeric.empty() ? host : numeric.c_str(), service, &hints, &info) != 0 || info == NULL) {
+		if (!address.empty()) failed();
+		return false;
+	}
+
+	fd = ::socket(info->ai_family, SOCK_STREAM, 0);
+	if (fd < 0) {
+		freeaddrinfo(info);
+		return false;
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+	int one = 1;
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif // SO_NOSIGPIPE
+
+	int res = ::connect(fd, info->ai_addr, info->ai_addrlen);
+	freeaddrinfo(info);
+	if (res == 0) {
+		state = 1;
+	}
+	else if (errno == EINPROGRESS) {
+		state = 0;
+	}
+	else {
+		failed();
+		close();
+		return false;
+	}
+	return true;
+}
+
+int8_t WorldTimeAPIPosixSocket::connected() {
+	if (job) {
+		std::vector<std::string> addresses;
+		{
+			std::lock_guard<std::mutex> lock(job->mutex);
+			if (!job->done) {
+				return 0; //Still resolving
+			}
+			addresses.swap(job->addresses);
+		}
+		job.reset();
+		if (addresses.empty()) {
+			state = -1;
+			return state;
+		}
+		if (dns != NULL) {
+			dns->store(host, addresses);
+		}
+		address = addresses[0];
+		if (!open(true)) {
+			state = -1;
+			return state;
+		}
+	}
+	if (state != 0) return state;
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLOUT;
+	pfd.revents = 0;
+	if (::poll(&pfd, 1, 0) <= 0) {
+		return 0; //Still connecting
+	}
+	int err = 0;
+	socklen_t len = sizeof(err);
+	if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+		failed();
+		state = -1;
+	}
+	else {
+		state = 1;
+	}
+	return state;
+}
+
+int WorldTimeAPIPosixSocket::write(const char* data, int length) {
+	if (state != 1) return WTAPI_SOCKET_ERROR;
+	ssize_t res = ::send(fd, data, length, MSG_NOSIGNAL);
+	if (res >= 0) return (int)res;
+	return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? WTAPI_SOCKET_WOULD_BLOCK : WTAPI_SOCKET_ERROR;
+}
+
+int WorldTimeAPIPosixSocket::read(char* buffer, int size) {
+	if (state != 1) return WTAPI_SOCKET_ERROR;
+	ssize_t res = ::recv(fd, buffer, size, 0);
+	if (res > 0) return (int)res;
+	if (res == 0) return WTAPI_SOCKET_CLOSED;
+	return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? WTAPI_SOCKET_WOULD_BLOCK : WTAPI_SOCKET_ERROR;
+}
+
+void WorldTimeAPIPosixSocket::close() {
+	job.reset(); //Thread finishes resolving alone
+	if (fd >= 0) {
+		::close(fd);
+		fd = -1;
+	}
+	state = -1;
+}
+
+void WorldTimeAPIPosixSocket::failed() {
+	if (dns != NULL && !address.empty()) {
+		dns->markFailed(host, address);
+	}
+}
+
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+
+bool WorldTimeAPIWiFiSocket::connect(const char* host, uint16_t port, WorldTimeAPIDNSCache* dns) {
+	close();
+	IPAddress address;
+	bool ok;
+#ifdef ESP32
+	if (dns != NULL && dns->resolve(host, address)) {
+		ok = client.connect(address, port, (int32_t)connectTimeout);
+	}
+	else {
+		ok = client.connect(host, port, (int32_t)connectTimeout);
+	}
+#else
+	client.setTimeout(connectTimeout);
+	if (dns != NULL && dns->resolve(host, address)) {
+		ok = client.connect(address, port);
+	}
+	else {
+		ok = client.connect(host, port);
+	}
+#endif // ESP32
+	if (!ok) {
+		if (dns != NULL) dns->markFailed(host);
+		return false;
+	}
+	client.setNoDelay(true);
+	state = 1;
+	return true;
+}
+
+int8_t WorldTimeAPIWiFiSocket::connected() {
+	return state;
+}
+
+int WorldTimeAPIWiFiSocket::write(const char* data, int length) {
+	if (state != 1) return WTAPI_SOCKET_ERROR;
+	size_t res = client.write((const uint8_t*)data, length);
+	if (res == 0) {
+		return client.connected() ? WTAPI_SOCKET_WOULD_BLOCK : WTAPI_SOCKET_ERROR;
+	}
+	return (int)res;
+}
+
+int WorldTimeAPIWiFiSocket::read(char* buffer, int size) {
+	if (state != 1) return WTAPI_SOCKET_ERROR;
+	int avail = client.available();
+	if (avail <= 0) {
+		return client.connected() ? WTAPI_SOCKET_WOULD_BLOCK : WTAPI_SOCKET_CLOSED;
+	}
+	int res = client.read((uint8_t*)buffer, avail < size ? avail : size);
+	return res > 0 ? res : WTAPI_SOCKET_WOULD_BLOCK;
+}
+
+void WorldTimeAPIWiFiSocket::close() {
+	client.stop();
+	state = -1;
+}
+
+#endif // WTAPI_POSIX_SOCKET
+
+
+WorldTimeAPILookup::WorldTimeAPILookup(WorldTimeAPISocket* socket_) {
+#ifdef WTAPI_DEFAULT_SOCKET
+	socket = (socket_ != NULL) ? socket_ : &ownSocket;
+#else
+	socket = socket_;
+#endif // WTAPI_DEFAULT_SOCKET
+	url[0] = 0;
+}
+
+bool WorldTimeAPILookup::startByTimeZone(const char* tz, uint32_t timeout_) {
+	if (tz == NULL) {
+		cancel();
+		fail(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR);
+		return false;
+	}
+	int len = snprintf(url, sizeof(url), "%s/%s%s", WorldTimeAPI::URL_TimeZone, tz,
+		format == WorldTimeAPI_Format::WTA_FORMAT_TEXT ? ".txt" : "");
+	if (len < 0 || len >= (int)sizeof(url)) {
+		cancel();
+		fail(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR);
+		return false;
+	}
+	return startURL(timeout_);
+}
+
+bool WorldTimeAPILookup::startByIP(const char* IP, uint32_t timeout_) {
+	int len = snprintf(url, sizeof(url), "%s%s%s%s", WorldTimeAPI::URL_IP, IP != NULL ? "/" : "", IP != NULL ? IP : "",
+		format == WorldTimeAPI_Format::WTA_FORMAT_TEXT ? ".txt" : "");
+	if (len < 0 || len >= (int)sizeof(url)) {
+		cancel();
+		fail(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR);
+		return false;
+	}
+	return startURL(timeout_);
+}
+
+bool WorldTimeAPILookup::start(const char* url_, uint32_t timeout_) {
+	if (url_ == NULL || strlen(url_) >= sizeof(url)) {
+		cancel();
+		fail(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR);
+		return false;
+	}
+	strcpy(url, url_);
+	return startURL(timeout_);
+}
+
+bool WorldTimeAPILookup::startURL(uint32_t timeout_) {
+	cancel();
+	result.clear();
+	httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	retryAfter = 0;
+	contentLength = -1;
+	lineLength = 0;
+	lineOverflow = false;
+	bodyLength = 0;
+	requestSent = 0;
+	startedAt = WorldTimeAPIClock::now();
+	timeout = timeout_ > 0 ? timeout_ : 10000;
+
+	int urlLength = (int)strlen(url);
+	requestFormat = (urlLength > 4 && strcmp(url + urlLength - 4, ".txt") == 0) ? WorldTimeAPI_Format::WTA_FORMAT_TEXT : WorldTimeAPI_Format::WTA_FORMAT_JSON;
+
+	char host[WTAPI_DNS_HOST_SIZE];
+	uint16_t port = 0;
+	if (socket == NULL || strncmp(url, "https:", 6) == 0 || !WorldTimeAPIDNSCache::parseURL(url, host, sizeof(host), port)) {
+		fail(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR);
+		return false;
+	}
+
+	//Path starts after host and port
+	const char* path = strstr(url, "://");
+	path = (path != NULL) ? path + 3 : url;
+	path = strchr(path, '/');
+	if (path == NULL) path = "/";
+
+	//HTTP/1.0 is used, so response is never chunked and connection is closed by server
+	requestLength = snprintf(request, sizeof(request), "GET %s HTTP/1.0\r\nHost: %s\r\nUser-Agent: WorldTimeAPI\r\nAccept: */*\r\nConnection: close\r\n\r\n", path, host);
+	if (requestLength < 0 || requestLength >= (int)sizeof(request)) {
+		fail(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR);
+		return false;
+	}
+
+	if (!socket->connect(host, port, dnsCache)) {
+		fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+		return false;
+	}
+	state = ST_CONNECT;
+	return true;
+}
+
+WorldTimeAPI_LookupStatus WorldTimeAPILookup::poll(uint32_t budget) {
+	uint32_t pollStart = WorldTimeAPIClock::now();
+	do {
+		if (state == ST_IDLE || state == ST_DONE) break;
+		if (WorldTimeAPIClock::elapsed(startedAt) >= timeout) {
+			fail(state == ST_CONNECT ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT);
+			break;
+		}
+		if (!step()) break;
+	} while (WorldTimeAPIClock::elapsed(pollStart) < budget);
+	return getStatus();
+}
+
+WorldTimeAPI_LookupStatus WorldTimeAPILookup::getStatus() const {
+	switch (state) {
+	case ST_IDLE:
+		return WorldTimeAPI_LookupStatus::WTA_LOOKUP_IDLE;
+	case ST_DONE:
+		return WorldTimeAPI_LookupStatus::WTA_LOOKUP_DONE;
+	default:
+		return WorldTimeAPI_LookupStatus::WTA_LOOKUP_PENDING;
+	}
+}
+
+void WorldTimeAPILookup::cancel() {
+	if (state != ST_IDLE && state != ST_DONE && socket != NULL) {
+		socket->close();
+	}
+	state = ST_IDLE;
+}
+
+void WorldTimeAPILookup::fail(WorldTimeAPI_HttpCode code) {
+	if (socket != NULL) socket->close();
+	result.clear();
+	result.httpCode = code;
+	state = ST_DONE;
+}
+
+bool WorldTimeAPILookup::step() {
+	switch (state) {
+	case ST_CONNECT: {
+		int8_t res = socket->connected();
+		if (res < 0) {
+			fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+			return false;
+		}
+		if (res == 0) return false;
+		state = ST_SEND;
+		return true;
+	}
+	case ST_SEND: {
+		int res = socket->write(request + requestSent, requestLength - requestSent);
+		if (res < 0) {
+			fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_SEND_HEADER_FAILED);
+			return false;
+		}
+		if (res == WTAPI_SOCKET_WOULD_BLOCK) return false;
+		requestSent += res;
+		if (requestSent >= requestLength) state = ST_STATUS;
+		return true;
+	}
+	case ST_STATUS:
+	case ST_HEADERS: {
+		//Headers are read in small slices, so data after headers can be moved to body
+		char buffer[WTAPI_LOOKUP_LINE_SIZE];
+		int res = socket->read(buffer, sizeof(buffer));
+		if (res == WTAPI_SOCKET_WOULD_BLOCK) return false;
+		if (res < 0) {
+			fail(state == ST_STATUS ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_NO_HTTP_SERVER : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_LOST);
+			return false;
+		}
+		int processed = receiveHeaders(buffer, res);
+		if (state == ST_BODY) {
+			int rest = res - processed;
+			if (rest > WTAPI_LOOKUP_BODY_SIZE) {
+				fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_TOO_LESS_RAM);
+				return false;
+			}
+			memcpy(body, buffer + processed, rest);
+			bodyLength = rest;
+			if (contentLength >= 0 && bodyLength >= contentLength) {
+				bodyLength = contentLength;
+				state = ST_PARSE;
+			}
+		}
+		return state != ST_DONE;
+	}
+	case ST_BODY: {
+		int space = WTAPI_LOOKUP_BODY_SIZE - bodyLength;
+		if (space <= 0) {
+			fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_TOO_LESS_RAM);
+			return false;
+		}
+		int res = socket->read(body + bodyLength, space);
+		if (res == WTAPI_SOCKET_WOULD_BLOCK) return false;
+		if (res == WTAPI_SOCKET_CLOSED && contentLength < 0) {
+			//Body ends with connection
+			state = ST_PARSE;
+			return true;
+		}
+		if (res < 0) {
+			fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_LOST);
+			return false;
+		}
+		bodyLength += res;
+		if (contentLength >= 0 && bodyLength >= contentLength) {
+			bodyLength = contentLength;
+			state = ST_PARSE;
+		}
+		return true;
+	}
+	case ST_PARSE:
+		socket->close();
+		WorldTimeAPI::parseResponse(body, bodyLength, requestFormat, result, httpCode);
+		state = ST_DONE;
+		return false;
+	default:
+		return false;
+	}
+}
+
+/**
+* @brief Compares beginning of text with name of header, case is ignored.
+*/
+static bool equalsIgnoreCase(const char* text, const char* name, int length) {
+	for (int i = 0; i < length; i++) {
+		char c = text[i];
+		char n = name[i];
+		if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+		if (n >= 'A' && n <= 'Z') n += 'a' - 'A';
+		if (c != n) return false;
+	}
+	return true;
+}
+
+int WorldTimeAPILookup::receiveHeaders(const char* data, int length) {
+	for (int i = 0; i < length; i++) {
+		char c = data[i];
+		if (c == '\n') {
+			//Lines longer than buffer are truncated, only short headers are used
+			if (lineLength > 0 && line[lineLength - 1] == '\r') lineLength--;
+			line[lineLength] = 0;
+			if (lineLength == 0 && state == ST_HEADERS) {
+				//Empty line ends headers
+				if (contentLength > WTAPI_LOOKUP_BODY_SIZE) {
+					fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_TOO_LESS_RAM);
+					return length;
+				}
+				state = contentLength == 0 ? ST_PARSE : ST_BODY;
+				return i + 1;
+			}
+			processLine();
+			if (state == ST_DONE) return length;
+			lineLength = 0;
+			lineOverflow = false;
+		}
+		else if (lineLength < WTAPI_LOOKUP_LINE_SIZE - 1) {
+			line[lineLength++] = c;
+		}
+		else {
+			lineOverflow = true;
+		}
+	}
+	return length;
+}
+
+void WorldTimeAPILookup::processLine() {
+	if (state == ST_STATUS) {
+		//Status line, for example: "HTTP/1.1 200 OK"
+		int code = 0;
+		if (strncmp(line, "HTTP/", 5) != 0 || sscanf(line, "%*s %d", &code) != 1 || code < 100 || code > 999) {
+			fail(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_NO_HTTP_SERVER);
+			return;
+		}
+		httpCode = (WorldTimeAPI_HttpCode)code;
+		state = ST_HEADERS;
+		return;
+	}
+	if (lineOverflow) return;
+
+	const char* colon = strchr(line, ':');
+	if (colon == NULL) return;
+	int keyLength = (int)(colon - line);
+	const char* value = colon + 1;
+	while (*value == ' ' || *value == '\t') value++;
+	if (keyLength == 14 && equalsIgnoreCase(line, "Content-Length", 14)) {
+		int32_t val = 0;
+		for (; *value >= '0' && *value <= '9' && val < 0x1000000; value++) {
+			val = val * 10 + (*value - '0');
+		}
+		contentLength = val;
+	}
+	else if (keyLength == 11 && equalsIgnoreCase(line, "Retry-After", 11)) {
+		retryAfter = WorldTimeAPI::parseRetryAfter(value, (int)strlen(value));
+	}
+}
@@ -0,0 +1,351 @@
+/**
+ * @file WorldTimeAPILookup.h
+ * @brief This file contains non-blocking lookup driven by polling from main loop.
+ *
+ * @see WorldTimeAPILookup
+ */
+
+#ifndef WORLD_TIME_API_LOOKUP_H_
+#define WORLD_TIME_API_LOOKUP_H_
+
+#include "WorldTimeAPI.h"
+
+#if defined(SJSONP_UNDER_OS) && !(defined(_WIN64) || defined(_WIN32))
+//Non-blocking BSD sockets are used on unix-like systems
+#define WTAPI_POSIX_SOCKET (1)
+#endif // SJSONP_UNDER_OS && !_WIN32
+
+#if defined(WTAPI_POSIX_SOCKET) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+#define WTAPI_DEFAULT_SOCKET (1)
+#endif // WTAPI_POSIX_SOCKET || ESP
+
+#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#else
+#include <WiFi.h>
+#endif // ESP8266
+#endif // ESP
+
+#if defined(SJSONP_UNDER_OS)
+#define WTAPI_LOOKUP_BODY_SIZE    (2048)
+#else
+#define WTAPI_LOOKUP_BODY_SIZE    (1024)
+#endif // SJSONP_UNDER_OS
+#define WTAPI_LOOKUP_URL_SIZE     (192)
+#define WTAPI_LOOKUP_REQUEST_SIZE (320)
+#define WTAPI_LOOKUP_LINE_SIZE    (128)
+
+//Return values of WorldTimeAPISocket::read() and WorldTimeAPISocket::write()
+#define WTAPI_SOCKET_WOULD_BLOCK  (0)
+#define WTAPI_SOCKET_ERROR        (-1)
+#define WTAPI_SOCKET_CLOSED       (-2)
+
+/**
+* @class WorldTimeAPISocket
+* @brief Interface of non-blocking TCP socket used by WorldTimeAPILookup. No method may wait for network.
+*/
+class WorldTimeAPISocket {
+public:
+	virtual ~WorldTimeAPISocket() {}
+
+	/**
+	* @brief Starts connecting to host. Previous connection is closed. Resolving of host, which is not cached,
+	* may continue in connected().
+	* @param host Host name or address.
+	* @param port Port.
+	* @param dns Cache of resolved addresses or NULL if host should be resolved by socket.
+	* @return Returns false if connecting failed immediately.
+	*/
+	virtual bool connect(const char* host, uint16_t port, WorldTimeAPIDNSCache* dns) = 0;
+
+	/**
+	* @brief Gets state of connecting.
+	* @return Returns 1 if socket is connected, 0 if connecting is in progress and -1 if connecting failed.
+	*/
+	virtual int8_t connected() = 0;
+
+	/**
+	* @brief Writes as much data as possible without blocking.
+	* @return Returns count of written bytes, WTAPI_SOCKET_WOULD_BLOCK or WTAPI_SOCKET_ERROR.
+	*/
+	virtual int write(const char* data, int length) = 0;
+
+	/**
+	* @brief Reads data, which were already received.
+	* @return Returns count of read bytes, WTAPI_SOCKET_WOULD_BLOCK, WTAPI_SOCKET_CLOSED if peer closed
+	* connection or WTAPI_SOCKET_ERROR.
+	*/
+	virtual int read(char* buffer, int size) = 0;
+
+	/**
+	* @brief Closes connection.
+	*/
+	virtual void close() = 0;
+};
+
+#if defined(WTAPI_POSIX_SOCKET)
+/**
+* @class WorldTimeAPIPosixSocket
+* @brief Non-blocking BSD socket. Default socket on unix-like systems. When host is not in DNS cache
+* (first lookup or expired TTL), it is resolved by helper thread and connected() reports connecting
+* in progress until address is known, so resolver of OS does not block caller.
+*/
+class WorldTimeAPIPosixSocket : public WorldTimeAPISocket {
+public:
+	WorldTimeAPIPosixSocket() {}
+	~WorldTimeAPIPosixSocket();
+
+	bool connect(const char* host, uint16_t port, WorldTimeAPIDNSCache* dns) override;
+	int8_t connected() override;
+	int write(const char* data, int length) override;
+	int read(char* buffer, int size) override;
+	void close() override;
+
+protected:
+	/**
+	* @struct ResolveJob
+	* @brief Result of resolving in helper thread. It is shared with thread, so closed socket can forget it.
+	*/
+	struct ResolveJob {
+		std::mutex mutex;
+		bool done = false;
+		std::vector<std::string> addresses;
+	};
+
+	/**
+	* @brief Reports failed address to DNS cache.
+	*/
+	void failed();
+
+	/**
+	* @brief Starts connecting to numeric address (or to host, when address is empty).
+	* @param numericOnly When true, host is not resolved, so it fails if host is not numeric address.
+	*/
+	bool open(bool numericOnly);
+
+	int fd = -1;
+	int8_t state = -1;
+	WorldTimeAPIDNSCache* dns = NULL;
+	char host[WTAPI_DNS_HOST_SIZE];
+	uint16_t port = 0;
+	std::string address;
+	std::shared_ptr<ResolveJob> job;
+};
+
+typedef WorldTimeAPIPosixSocket WorldTimeAPIDefaultSocket;
+
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+/**
+* @class WorldTimeAPIWiFiSocket
+* @brief Socket over WiFiClient. Default socket on ESP8266 and ESP32.
+* @warning WiFiClient resolves and connects synchronously, so connect() blocks while host, which is not
+* in DNS cache, is resolved and until connection is established or connect timeout expires.
+* Sending and receiving do not block.
+*/
+class WorldTimeAPIWiFiSocket : public WorldTimeAPISocket {
+public:
+	/**
+	* @brief Sets timeout of connecting in milliseconds. Default is 2000 ms.
+	*/
+	inline void setConnectTimeout(uint32_t timeout) {
+		connectTimeout = timeout;
+	}
+
+	bool connect(const char* host, uint16_t port, WorldTimeAPIDNSCache* dns) override;
+	int8_t connected() override;
+	int write(const char* data, int length) override;
+	int read(char* buffer, int size) override;
+	void close() override;
+
+protected:
+	WiFiClient client;
+	uint32_t connectTimeout = 2000;
+	int8_t state = -1;
+};
+
+typedef WorldTimeAPIWiFiSocket WorldTimeAPIDefaultSocket;
+#endif // WTAPI_POSIX_SOCKET
+
+//Status of WorldTimeAPILookup
+typedef enum {
+	/**
+	* Lookup was not started or it was cancelled.
+	*/
+	WTA_LOOKUP_IDLE = 0,
+
+	/**
+	* Lookup is in progress, poll() has to be called again.
+	*/
+	WTA_LOOKUP_PENDING = 1,
+
+	/**
+	* Lookup finished, result is available in getResult(). It can be successful or failed.
+	*/
+	WTA_LOOKUP_DONE = 2,
+} WorldTimeAPI_LookupStatus;
+
+/**
+* @class WorldTimeAPILookup
+* @brief Non-blocking lookup for cooperative main loops. Lookup is started by start(), startByTimeZone()
+* or startByIP() and then poll() is called from main loop, until it returns WTA_LOOKUP_DONE.
+* Each call of poll() advances connecting, sending, receiving and parsing of response, but it never waits
+* for network and it returns when given time budget is used. Headers are parsed as they arrive,
+* body is collected to fixed buffer and parsed in separate call of poll(), so no call takes longer than
+* parsing of one response (~400 bytes). Host is resolved by helper thread on unix-like systems, when it is not
+* in DNS cache (WorldTimeAPIWiFiSocket resolves it in connect()). No memory is allocated on heap, except state
+* of that thread.
+* @note Lookup can be used only by one thread. HTTP over TCP is used, HTTPS is not supported.
+* Rate limiter, circuit breaker and cache of WorldTimeAPI client are not used.
+*/
+class WorldTimeAPILookup {
+public:
+	/**
+	* @brief Creates lookup.
+	* @param socket Socket, which is used for connection, or NULL to use default socket (non-blocking BSD socket
+	* on unix-like systems, WiFiClient on ESP8266 and ESP32). Socket has to exist while lookup is used.
+	*/
+	WorldTimeAPILookup(WorldTimeAPISocket* socket = NULL);
+
+	/**
+	* @brief Starts lookup of time zone informations by time zone name. See WorldTimeAPI::getByTimeZone().
+	* @param tz Olson time zone name, for example: "Europe/Amsterdam".
+	* @param timeout Timeout of whole lookup in milliseconds or 0 for default (10 seconds).
+	* @return Returns false if lookup cannot be started, result contains error code then.
+	*/
+	bool startByTimeZone(const char* tz, uint32_t timeout = 10000);
+
+	/**
+	* @brief Starts lookup of time zone informations by public IP address. See WorldTimeAPI::getByIP().
+	* @param IP IP address or NULL to get informations of client's public IP.
+	* @param timeout Timeout of whole lookup in milliseconds or 0 for default (10 seconds).
+	* @return Returns false if lookup cannot be started, result contains error code then.
+	*/
+	bool startByIP(const char* IP = NULL, uint32_t timeout = 10000);
+
+	/**
+	* @brief Starts lookup from full URL of API, for example: "http://worldtimeapi.org/api/timezone/Europe/Bratislava".
+	* Previous lookup is cancelled.
+	* @param url URL of API. Only "http" scheme is supported.
+	* @param timeout Timeout of whole lookup in milliseconds or 0 for default (10 seconds).
+	* @return Returns false if lookup cannot be started, result contains error code then.
+	*/
+	bool start(const char* url, uint32_t timeout = 10000);
+
+	/**
+	* @brief Advances lookup. Call it repeatedly from main loop.
+	* @param budget Time in milliseconds, which can be spent in this call. At least one step is always done.
+	* @return Returns status of lookup.
+	*/
+	WorldTimeAPI_LookupStatus poll(uint32_t budget = 1);
+
+	/**
+	* @brief Cancels lookup and closes connection.
+	*/
+	void cancel();
+
+	/**
+	* @brief Gets status of lookup.
+	*/
+	WorldTimeAPI_LookupStatus getStatus() const;
+
+	/**
+	* @brief Gets result of finished lookup.
+	*/
+	inline const WorldTimeAPIResult& getResult() const {
+		return result;
+	}
+
+	/**
+	* @brief Gets value of Retry-After header of finished lookup in seconds or 0 if it was not found.
+	*/
+	inline uint32_t getRetryAfter() const {
+		return retryAfter;
+	}
+
+	/**
+	* @brief Sets format of responses requested by startByTimeZone() and startByIP().
+	* @param format_ Format of response. Default is WTA_FORMAT_JSON.
+	*/
+	inline void setFormat(WorldTimeAPI_Format format_) {
+		format = format_;
+	}
+
+	/**
+	* @brief Sets cache of resolved addresses of API host. By default, cache shared by all clients is used.
+	* @param cache Cache of resolved addresses or NULL to disable caching.
+	*/
+	inline void setDNSCache(WorldTimeAPIDNSCache* cache) {
+		dnsCache = cache;
+	}
+
+protected:
+
+	//States of lookup
+	enum State : uint8_t {
+		ST_IDLE,
+		ST_CONNECT,
+		ST_SEND,
+		ST_STATUS,
+		ST_HEADERS,
+		ST_BODY,
+		ST_PARSE,
+		ST_DONE
+	};
+
+	/**
+	* @brief Does one step of lookup.
+	* @return Returns false if lookup cannot continue until more data are received or sent.
+	*/
+	bool step();
+
+	/**
+	* @brief Processes received data in headers state.
+	* @return Returns count of processed bytes.
+	*/
+	int receiveHeaders(const char* data, int length);
+
+	/**
+	* @brief Processes one line of status or headers.
+	*/
+	void processLine();
+
+	/**
+	* @brief Finishes lookup with error.
+	*/
+	void fail(WorldTimeAPI_HttpCode code);
+
+	/**
+	* @brief Starts lookup from URL in url buffer.
+	*/
+	bool startURL(uint32_t timeout_);
+
+#ifdef WTAPI_DEFAULT_SOCKET
+	WorldTimeAPIDefaultSocket ownSocket;
+#endif // WTAPI_DEFAULT_SOCKET
+	WorldTimeAPISocket* socket;
+	WorldTimeAPIDNSCache* dnsCache = &WorldTimeAPIDNSCache::global();
+	WorldTimeAPI_Format format = WorldTimeAPI_Format::WTA_FORMAT_JSON;
+	WorldTimeAPI_Format requestFormat = WorldTimeAPI_Format::WTA_FORMAT_JSON;
+
+	State state = ST_IDLE;
+	uint32_t startedAt = 0;
+	uint32_t timeout = 0;
+	WorldTimeAPI_HttpCode httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	uint32_t retryAfter = 0;
+	int32_t contentLength = -1;
+
+	char url[WTAPI_LOOKUP_URL_SIZE];
+	char request[WTAPI_LOOKUP_REQUEST_SIZE];
+	int requestLength = 0;
+	int requestSent = 0;
+	char line[WTAPI_LOOKUP_LINE_SIZE];
+	int lineLength = 0;
+	bool lineOverflow = false;
+	char body[WTAPI_LOOKUP_BODY_SIZE];
+	int bodyLength = 0;
+
+	WorldTimeAPIResult result;
+};
+
+#endif // !WORLD_TIME_API_LOOKUP_H_
@@ -0,0 +1,105 @@
+#include "WorldTimeAPIRateLimiter.h"
+
+WorldTimeAPIRateLimiter::WorldTimeAPIRateLimiter() :
+	rate(0),
+	burst(1),
+	tokens(1),
+	lastRefill(WorldTimeAPIClock::now()),
+	baseDelay(500),
+	maxDelay(60000),
+	blockedUntil(0),
+	blocked(false),
+	failures(0)
+{
+	seed = lastRefill ^ (uint32_t)(uintptr_t)this;
+	if (seed == 0) seed = 0x9E3779B9;
+}
+
+void WorldTimeAPIRateLimiter::setRate(float requestsPerSecond, uint16_t burst_) {
+	WTAPI_RATE_LIMITER_LOCK();
+	rate = (requestsPerSecond > 0) ? requestsPerSecond : 0;
+	burst = (burst_ > 0) ? burst_ : 1;
+	tokens = burst;
+	lastRefill = WorldTimeAPIClock::now();
+}
+
+void WorldTimeAPIRateLimiter::setBackoff(uint32_t baseDelay_, uint32_t maxDelay_) {
+	WTAPI_RATE_LIMITER_LOCK();
+	baseDelay = baseDelay_;
+	maxDelay = (maxDelay_ < baseDelay_) ? baseDelay_ : maxDelay_;
+}
+
+int32_t WorldTimeAPIRateLimiter::reserve(uint32_t maxWait) {
+	WTAPI_RATE_LIMITER_LOCK();
+	uint32_t now = WorldTimeAPIClock::now();
+	uint32_t wait = 0;
+
+	if (blocked) {
+		if (WorldTimeAPIClock::isBefore(now, blockedUntil)) {
+			wait = blockedUntil - now;
+		}
+		else {
+			blocked = false;
+		}
+	}
+
+	if (rate > 0) {
+		//Refilling tokens
+		tokens += (now - lastRefill) * rate / 1000.0f;
+		if (tokens > burst) tokens = burst;
+		lastRefill = now;
+
+		if (tokens < 1) {
+			//Tokens can be negative, when more callers are waiting
+			uint32_t tokenWait = (uint32_t)((1 - tokens) * 1000.0f / rate);
+			if (tokenWait > wait) wait = tokenWait;
+		}
+	}
+
+	if (wait > maxWait) {
+		return -1; //Caller will not wait so long
+	}
+
+	if (rate > 0) {
+		tokens -= 1;
+	}
+	return (int32_t)wait;
+}
+
+bool WorldTimeAPIRateLimiter::onResponse(int httpCode, uint32_t retryAfter) {
+	WTAPI_RATE_LIMITER_LOCK();
+	if (httpCode == 429 || httpCode == 503) {
+		if (failures < 31) failures++;
+
+		//Exponential backoff with jitter in range <backoff/2, backoff>
+		uint32_t backoff = maxDelay;
+		if (failures <= 16 && ((uint64_t)baseDelay << (failures - 1)) < maxDelay) {
+			backoff = baseDelay << (failures - 1);
+		}
+		backoff = backoff / 2 + nextRandom() % (backoff / 2 + 1);
+
+		if (retryAfter > 0) {
+			uint32_t serverDelay = (retryAfter > 86400) ? 86400000 : retryAfter * 1000;
+			if (serverDelay > backoff) backoff = serverDelay;
+		}
+
+		uint32_t until = WorldTimeAPIClock::now() + backoff;
+		if (!blocked || WorldTimeAPIClock::isBefore(blockedUntil, until)) {
+			blockedUntil = until;
+		}
+		blocked = true;
+		return true;
+	}
+	else if (httpCode > 0) {
+		//Server responded, so it is not overloaded anymore
+		failures = 0;
+	}
+	return false;
+}
+
+uint32_t WorldTimeAPIRateLimiter::nextRandom() {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file WorldTimeAPIRateLimiter.h
+ * @brief This file contains client side rate limiter of WorldTimeAPI requests.
+ *
+ * @see WorldTimeAPIRateLimiter
+ */
+
+#ifndef WORLD_TIME_API_RATE_LIMITER_H_
+#define WORLD_TIME_API_RATE_LIMITER_H_
+
+#include "WorldTimeAPIClock.h"
+
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+#include <mutex>
+#define WTAPI_RATE_LIMITER_LOCK() std::lock_guard<std::mutex> lock(mutex)
+#else
+#define WTAPI_RATE_LIMITER_LOCK()
+#endif // SJSONP_UNDER_OS || ESP32
+
+/**
+* @class WorldTimeAPIRateLimiter
+* @brief Token bucket rate limiter with jittered exponential backoff. One instance is shared by all
+* callers of one WorldTimeAPI client.
+*
+* Before each request, reserve() has to be called. It returns time, for which caller has to wait before
+* sending request. After response is received, onResponse() has to be called. When server responds with
+* 429 (Too many requests) or 503 (Service unavailable), all requests are blocked for time given by
+* Retry-After header or by exponential backoff (whichever is longer).
+*/
+class WorldTimeAPIRateLimiter {
+public:
+	WorldTimeAPIRateLimiter();
+
+	/**
+	* @brief Sets maximal rate of requests.
+	* @param requestsPerSecond Count of requests per second. If set to 0, rate is not limited.
+	* @param burst Maximal count of requests, that can be sent at once.
+	*/
+	void setRate(float requestsPerSecond, uint16_t burst = 1);
+
+	/**
+	* @brief Sets backoff parameters.
+	* @param baseDelay Delay after first throttled response in milliseconds. It is doubled with each next throttled response.
+	* @param maxDelay Maximal delay in milliseconds.
+	*/
+	void setBackoff(uint32_t baseDelay, uint32_t maxDelay);
+
+	/**
+	* @brief Reserves slot for one request.
+	* @param maxWait Maximal time in milliseconds, which caller is willing to wait.
+	* @return Returns time in milliseconds, for which caller has to wait before sending request.
+	* Returns negative value, when caller would have to wait longer than maxWait. No slot is reserved in that case.
+	*/
+	int32_t reserve(uint32_t maxWait);
+
+	/**
+	* @brief Updates backoff state from response.
+	* @param httpCode HTTP code of response.
+	* @param retryAfter Value of Retry-After header in seconds or 0 if header was not found.
+	* @return Returns true if response was throttled (429 or 503).
+	*/
+	bool onResponse(int httpCode, uint32_t retryAfter);
+
+	/**
+	* @brief Gets count of throttled responses in a row.
+	*/
+	inline uint8_t getFailures() const {
+		return failures;
+	}
+
+protected:
+	/**
+	* @brief Gets pseudo random number (xorshift32).
+	*/
+	uint32_t nextRandom();
+
+	float rate;
+	float burst;
+	float tokens;
+	uint32_t lastRefill;
+
+	uint32_t baseDelay;
+	uint32_t maxDelay;
+	uint32_t blockedUntil;
+	bool blocked;
+	uint8_t failures;
+
+	uint32_t seed;
+
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+	std::mutex mutex;
+#endif // SJSONP_UNDER_OS || ESP32
+};
+
+#endif // !WORLD_TIME_API_RATE_LIMITER_H_
@@ -0,0 +1,204 @@
+#include "WorldTimeAPIReplay.h"
+
+#ifdef WTAPI_REPLAY
+#include <string.h>
+#include <chrono>
+
+static const char WTAPI_REPLAY_MAGIC[8] = { 'W', 'T', 'A', 'P', 'I', 'R', 'E', 'C' };
+
+//Header of record: timestamp (8), duration (4), httpCode (4), retryAfter (4), url length (4), body length (4)
+#define WTAPI_RECORD_HEADER_SIZE  (28)
+#define WTAPI_RECORD_MAX_LENGTH   (64 * 1024 * 1024)
+
+static void putLE(uint8_t* buffer, uint64_t value, int bytes) {
+	for (int i = 0; i < bytes; i++) {
+		buffer[i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+static uint64_t getLE(const uint8_t* buffer, int bytes) {
+	uint64_t value = 0;
+	for (int i = bytes - 1; i >= 0; i--) {
+		value = (value << 8) | buffer[i];
+	}
+	return value;
+}
+
+static int64_t systemMillis() {
+	return (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool WorldTimeAPIRecord::isList() const {
+	//List is always requested as text and contains only names
+	size_t len = url.length();
+	if (len < 4 || url.compare(len - 4, 4, ".txt") != 0 || url.find("/timezone") == std::string::npos) {
+		return false;
+	}
+	return httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK && body.compare(0, 6, "abbrev") != 0;
+}
+
+bool WorldTimeAPIRecord::write(FILE* file) const {
+	uint8_t header[WTAPI_RECORD_HEADER_SIZE];
+	putLE(header, (uint64_t)timestamp, 8);
+	putLE(header + 8, duration, 4);
+	putLE(header + 12, (uint32_t)(int32_t)httpCode, 4);
+	putLE(header + 16, retryAfter, 4);
+	putLE(header + 20, (uint32_t)url.length(), 4);
+	putLE(header + 24, (uint32_t)body.length(), 4);
+	return fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+		fwrite(url.data(), 1, url.length(), file) == url.length() &&
+		fwrite(body.data(), 1, body.length(), file) == body.length();
+}
+
+bool WorldTimeAPIRecord::read(FILE* file) {
+	uint8_t header[WTAPI_RECORD_HEADER_SIZE];
+	if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+		return false;
+	}
+	timestamp = (int64_t)getLE(header, 8);
+	duration = (uint32_t)getLE(header + 8, 4);
+	httpCode = (WorldTimeAPI_HttpCode)(int32_t)(uint32_t)getLE(header + 12, 4);
+	retryAfter = (uint32_t)getLE(header + 16, 4);
+	uint32_t urlLength = (uint32_t)getLE(header + 20, 4);
+	uint32_t bodyLength = (uint32_t)getLE(header + 24, 4);
+	if (urlLength > WTAPI_RECORD_MAX_LENGTH || bodyLength > WTAPI_RECORD_MAX_LENGTH) {
+		return false; //Corrupted record
+	}
+	url.resize(urlLength);
+	body.resize(bodyLength);
+	return fread(&url[0], 1, urlLength, file) == urlLength && fread(&body[0], 1, bodyLength, file) == bodyLength;
+}
+
+
+WorldTimeAPIRecordingTransport::WorldTimeAPIRecordingTransport(WorldTimeAPITransport& inner_, const char* path) :
+	inner(inner_)
+{
+	file = fopen(path, "ab");
+	if (file != NULL && ftell(file) == 0) {
+		//New file
+		fwrite(WTAPI_REPLAY_MAGIC, 1, sizeof(WTAPI_REPLAY_MAGIC), file);
+		fflush(file);
+	}
+}
+
+WorldTimeAPIRecordingTransport::~WorldTimeAPIRecordingTransport() {
+	if (file != NULL) {
+		fclose(file);
+	}
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIRecordingTransport::get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	WorldTimeAPIRecord record;
+	record.timestamp = systemMillis();
+	uint32_t start = WorldTimeAPIClock::now();
+	record.retryAfter = 0;
+	record.httpCode = inner.get(url, body, &record.retryAfter, timeout, dns);
+	record.duration = WorldTimeAPIClock::elapsed(start);
+	if (retryAfter != NULL) {
+		*retryAfter = record.retryAfter;
+	}
+
+	if (file != NULL) {
+		record.url = url;
+		record.body = body;
+		std::lock_guard<std::mutex> lock(mutex);
+		record.write(file);
+		fflush(file); //Records are kept when process is killed
+	}
+	return record.httpCode;
+}
+
+
+WorldTimeAPIReplayTransport::WorldTimeAPIReplayTransport(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return;
+	}
+	char magic[sizeof(WTAPI_REPLAY_MAGIC)];
+	if (fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, WTAPI_REPLAY_MAGIC, sizeof(magic)) == 0) {
+		WorldTimeAPIRecord record;
+		while (record.read(file)) {
+			queues[record.url].indexes.push_back(records.size());
+			records.push_back(record);
+		}
+	}
+	fclose(file);
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIReplayTransport::get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache*) {
+	const WorldTimeAPIRecord* record = NULL;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = queues.find(url);
+		if (it != queues.end()) {
+			Queue& queue = it->second;
+			record = &records[queue.indexes[queue.next]];
+			queue.next = (queue.next + 1) % queue.indexes.size();
+		}
+	}
+	if (retryAfter != NULL) {
+		*retryAfter = 0;
+	}
+	if (record == NULL) {
+		body = "";
+		return WorldTimeAPI_HttpCode::WTA_HTTP_CODE_NOT_FOUND; //Not recorded
+	}
+
+	if (simulateLatency && latencyScale > 0) {
+		uint32_t delay = (uint32_t)(record->duration * latencyScale);
+		WorldTimeAPIClock::sleep(delay < timeout ? delay : timeout);
+		if (record->duration * latencyScale >= timeout) {
+			body = "";
+			return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+		}
+	}
+	body = record->body;
+	if (retryAfter != NULL) {
+		*retryAfter = record->retryAfter;
+	}
+	return record->httpCode;
+}
+
+size_t WorldTimeAPIReplayTransport::run(WorldTimeAPI& api, float speed) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& queue : queues) {
+			queue.second.next = 0;
+		}
+	}
+	latencyScale = speed > 0 ? 1.0f / speed : 0;
+
+	size_t matched = 0;
+	uint32_t start = WorldTimeAPIClock::now();
+	for (const WorldTimeAPIRecord& record : records) {
+		if (speed > 0) {
+			//Waiting for recorded time of request
+			uint32_t at = (uint32_t)((record.timestamp - records[0].timestamp) / speed);
+			uint32_t elapsed = WorldTimeAPIClock::elapsed(start);
+			if (at > elapsed) {
+				WorldTimeAPIClock::sleep(at - elapsed);
+			}
+		}
+
+		WorldTimeAPI_HttpCode httpCode;
+		if (record.isList()) {
+			//Part of time zone name is after "/timezone/"
+			size_t pos = record.url.find("/timezone") + 9;
+			std::string tz;
+			if (pos < record.url.length() - 4 && record.url[pos] == '/') {
+				tz = record.url.substr(pos + 1, record.url.length() - 4 - pos - 1);
+			}
+			std::string list;
+			httpCode = api.getListOfTimeZones(list, tz.empty() ? NULL : tz.c_str());
+		}
+		else {
+			WorldTimeAPIResult result;
+			httpCode = api.getByURL(record.url.c_str(), result);
+		}
+		if (httpCode == record.httpCode) {
+			matched++;
+		}
+	}
+	return matched;
+}
+#endif // WTAPI_REPLAY
@@ -0,0 +1,179 @@
+/**
+ * @file WorldTimeAPIReplay.h
+ * @brief This file contains recording of API traffic and its replay.
+ *
+ * @see WorldTimeAPIRecordingTransport
+ * @see WorldTimeAPIReplayTransport
+ */
+
+#ifndef WORLD_TIME_API_REPLAY_H_
+#define WORLD_TIME_API_REPLAY_H_
+
+#include "WorldTimeAPITransport.h"
+
+#if defined(SJSONP_UNDER_OS)
+//Records are stored in files
+#define WTAPI_REPLAY (1)
+#endif // SJSONP_UNDER_OS
+
+#ifdef WTAPI_REPLAY
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+/**
+* @struct WorldTimeAPIRecord
+* @brief One recorded request and its response.
+*/
+struct WorldTimeAPIRecord {
+	/**
+	* @brief System time of request in milliseconds since 1970-01-01.
+	*/
+	int64_t timestamp;
+
+	/**
+	* @brief Duration of request in milliseconds.
+	*/
+	uint32_t duration;
+
+	/**
+	* @brief HTTP code of response or negative error code.
+	*/
+	WorldTimeAPI_HttpCode httpCode;
+
+	/**
+	* @brief Value of Retry-After header in seconds or 0.
+	*/
+	uint32_t retryAfter;
+
+	/**
+	* @brief URL of request.
+	*/
+	std::string url;
+
+	/**
+	* @brief Body of response.
+	*/
+	std::string body;
+
+	/**
+	* @brief Returns true if request was sent by getListOfTimeZones().
+	*/
+	bool isList() const;
+
+	/**
+	* @brief Appends record to file in binary format.
+	* @return Returns true if record was written.
+	*/
+	bool write(FILE* file) const;
+
+	/**
+	* @brief Reads next record from file.
+	* @return Returns false at the end of file or when record is not complete.
+	*/
+	bool read(FILE* file);
+};
+
+/**
+* @class WorldTimeAPIRecordingTransport
+* @brief Transport, which sends requests by another transport and appends every request (URL, status, Retry-After,
+* body and timing) to file. File starts with "WTAPIREC" and contains binary records, see WorldTimeAPIRecord::write().
+* Records from multiple runs can be appended to one file.
+*/
+class WorldTimeAPIRecordingTransport : public WorldTimeAPITransport {
+public:
+	/**
+	* @brief Creates recording transport.
+	* @param inner Transport, which sends requests.
+	* @param path Path to file. If file exists, records are appended.
+	*/
+	WorldTimeAPIRecordingTransport(WorldTimeAPITransport& inner, const char* path);
+	~WorldTimeAPIRecordingTransport();
+
+	/**
+	* @brief Returns true if file was opened.
+	*/
+	inline bool isOpen() const {
+		return file != NULL;
+	}
+
+	WorldTimeAPI_HttpCode get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+protected:
+	WorldTimeAPITransport& inner;
+	FILE* file;
+	std::mutex mutex;
+};
+
+/**
+* @class WorldTimeAPIReplayTransport
+* @brief Transport, which serves recorded responses. Response for URL is the next record of that URL
+* (records of URL are served in recorded order and then repeated). run() sends recorded requests through client
+* in recorded order and with recorded timing, so parsing, caching and throttling of client are the same as in
+* production.
+*
+* @code
+* WorldTimeAPIReplayTransport replay("traffic.rec");
+* WorldTimeAPI api(&replay);
+* replay.run(api, 10.0f); //10 times faster than recorded
+* @endcode
+*/
+class WorldTimeAPIReplayTransport : public WorldTimeAPITransport {
+public:
+	/**
+	* @brief Creates replay transport.
+	* @param path Path to file with records.
+	*/
+	explicit WorldTimeAPIReplayTransport(const char* path);
+
+	/**
+	* @brief Gets count of loaded records.
+	*/
+	inline size_t size() const {
+		return records.size();
+	}
+
+	/**
+	* @brief Gets loaded record.
+	*/
+	inline const WorldTimeAPIRecord& operator[](size_t index) const {
+		return records[index];
+	}
+
+	/**
+	* @brief Sets whether get() waits for recorded duration of request (divided by speed of run()).
+	* Disabled by default.
+	*/
+	inline void setSimulateLatency(bool simulate) {
+		simulateLatency = simulate;
+	}
+
+	/**
+	* @brief Sends all recorded requests through client. Requests for time zone and IP address are sent by
+	* WorldTimeAPI::getByURL(), requests for list by WorldTimeAPI::getListOfTimeZones().
+	* @param api Client, which uses this transport.
+	* @param speed Speed of replay, 1 - original timing, 10 - 10 times faster, 0 - as fast as possible.
+	* @return Returns count of requests, which got the same HTTP code as recorded.
+	*/
+	size_t run(WorldTimeAPI& api, float speed = 1.0f);
+
+	WorldTimeAPI_HttpCode get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+protected:
+	struct Queue {
+		std::vector<size_t> indexes; //Records of URL
+		size_t next = 0;
+	};
+
+	std::vector<WorldTimeAPIRecord> records;
+	std::map<std::string, Queue> queues;
+	bool simulateLatency = false;
+	float latencyScale = 1.0f;
+	std::mutex mutex;
+};
+
+#endif // WTAPI_REPLAY
+
+#endif // !WORLD_TIME_API_REPLAY_H_
@@ -0,0 +1,190 @@
+#include "WorldTimeAPIResponse.h"
+
+#include <ctype.h>
+
+bool WorldTimeAPIStringView::equalsIgnoreCase(const char* text) const {
+	size_t i = 0;
+	for (; i < length && text[i] != 0; i++) {
+		if (tolower((unsigned char)data[i]) != tolower((unsigned char)text[i])) return false;
+	}
+	return i == length && text[i] == 0;
+}
+
+WorldTimeAPIResponse::WorldTimeAPIResponse() {
+	clear();
+}
+
+void WorldTimeAPIResponse::clear() {
+	buffer = ""; //Capacity is kept
+	arena.reset();
+	bytes = NULL;
+	bytesLength = 0;
+	bytesCapacity = 0;
+	httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	retryAfter = 0;
+	statusOffset = 0;
+	statusLength = 0;
+	bodyOffset = 0;
+	bodyLength = 0;
+	externalBody = NULL;
+	headerCount = 0;
+}
+
+bool WorldTimeAPIResponse::append(const char* data, size_t length) {
+	size_t needed = bytesLength + length + 1; //Data are null terminated like buffer
+	if (needed > bytesCapacity) {
+		size_t newCapacity = bytesCapacity * 2;
+		if (newCapacity < needed) newCapacity = needed;
+		if (newCapacity < 256) newCapacity = 256;
+		if (bytes == NULL || !arena.extend(bytes, bytesCapacity, newCapacity)) {
+			//Not the last allocation of arena or block is full
+			char* moved = (char*)arena.alloc(newCapacity);
+			if (moved == NULL) return false;
+			if (bytesLength > 0) memcpy(moved, bytes, bytesLength);
+			bytes = moved;
+		}
+		bytesCapacity = newCapacity;
+	}
+	memcpy(bytes + bytesLength, data, length);
+	bytesLength += length;
+	bytes[bytesLength] = 0;
+	return true;
+}
+
+WorldTimeAPIStringView WorldTimeAPIResponse::getStatus() const {
+	WorldTimeAPIStringView view = { data() + statusOffset, statusLength };
+	return view;
+}
+
+WorldTimeAPIStringView WorldTimeAPIResponse::getBody() const {
+	WorldTimeAPIStringView view = { externalBody != NULL ? externalBody : data() + bodyOffset, bodyLength };
+	return view;
+}
+
+WorldTimeAPIStringView WorldTimeAPIResponse::getRaw() const {
+	WorldTimeAPIStringView view = { data(), size() };
+	return view;
+}
+
+WorldTimeAPIStringView WorldTimeAPIResponse::getHeaderName(uint8_t index) const {
+	WorldTimeAPIStringView view = { data() + headers[index].name, headers[index].nameLength };
+	return view;
+}
+
+WorldTimeAPIStringView WorldTimeAPIResponse::getHeaderValue(uint8_t index) const {
+	WorldTimeAPIStringView view = { data() + headers[index].value, headers[index].valueLength };
+	return view;
+}
+
+bool WorldTimeAPIResponse::findHeader(const char* name, WorldTimeAPIStringView& value) const {
+	for (uint8_t i = 0; i < headerCount; i++) {
+		if (getHeaderName(i).equalsIgnoreCase(name)) {
+			value = getHeaderValue(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIResponse::parse() {
+	const char* p = data();
+	size_t length = size();
+	size_t pos = 0;
+	externalBody = NULL;
+	while (true) {
+		headerCount = 0;
+		retryAfter = 0;
+
+		//Status line: "HTTP/1.1 200 OK"
+		if (length - pos < 12 || strncmp(p + pos, "HTTP/", 5) != 0) {
+			setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+			return httpCode;
+		}
+		size_t i = pos + 5;
+		for (; i < length && p[i] != ' ' && p[i] != '\n'; i++);
+		int code = 0;
+		int digits = 0;
+		for (i++; i < length && p[i] >= '0' && p[i] <= '9'; i++, digits++) {
+			code = code * 10 + (p[i] - '0');
+		}
+		if (digits != 3) {
+			setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+			return httpCode;
+		}
+		for (; i < length && p[i] != '\n'; i++);
+		statusOffset = (uint32_t)pos;
+		statusLength = (uint32_t)(i - pos);
+		if (statusLength > 0 && p[pos + statusLength - 1] == '\r') statusLength--;
+		i++;
+
+		//Headers until empty line, each line is scanned only once
+		bool headersEnd = false;
+		while (i < length) {
+			size_t lineStart = i;
+			size_t colon = 0;
+			for (; i < length && p[i] != '\n'; i++) {
+				if (p[i] == ':' && colon == 0) colon = i;
+			}
+			size_t lineEnd = i;
+			if (lineEnd > lineStart && p[lineEnd - 1] == '\r') lineEnd--;
+			i++;
+			if (lineEnd == lineStart) {
+				headersEnd = true;
+				break;
+			}
+			if (colon == 0 || headerCount >= WTAPI_RESPONSE_MAX_HEADERS) {
+				continue; //Not header or no space in index
+			}
+			size_t value = colon + 1;
+			for (; value < lineEnd && (p[value] == ' ' || p[value] == '\t'); value++);
+			size_t valueEnd = lineEnd;
+			for (; valueEnd > value && (p[valueEnd - 1] == ' ' || p[valueEnd - 1] == '\t'); valueEnd--);
+			Header& hdr = headers[headerCount++];
+			hdr.name = (uint32_t)lineStart;
+			hdr.nameLength = (uint16_t)((colon - lineStart) < 0xFFFF ? colon - lineStart : 0xFFFF);
+			hdr.value = (uint32_t)value;
+			hdr.valueLength = (uint16_t)((valueEnd - value) < 0xFFFF ? valueEnd - value : 0xFFFF);
+			if (hdr.nameLength == 11 && getHeaderName(headerCount - 1).equalsIgnoreCase("Retry-After")) {
+				retryAfter = WorldTimeAPI::parseRetryAfter(p + hdr.value, hdr.valueLength);
+			}
+		}
+		if (!headersEnd) {
+			setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+			return httpCode;
+		}
+		if (code >= 100 && code < 200 && code != 101) {
+			//Interim response (for example "100 Continue"), final response follows
+			pos = i;
+			continue;
+		}
+		bodyOffset = (uint32_t)i;
+		bodyLength = (uint32_t)(length - i);
+		httpCode = (WorldTimeAPI_HttpCode)code;
+		return httpCode;
+	}
+}
+
+void WorldTimeAPIResponse::setBodyOnly(WorldTimeAPI_HttpCode httpCode_, uint32_t retryAfter_) {
+	httpCode = httpCode_;
+	retryAfter = retryAfter_;
+	statusOffset = 0;
+	statusLength = 0;
+	bodyOffset = 0;
+	bodyLength = (uint32_t)size();
+	externalBody = NULL;
+	headerCount = 0;
+}
+
+void WorldTimeAPIResponse::setExternalBody(WorldTimeAPI_HttpCode httpCode_, uint32_t retryAfter_, const char* body, size_t length) {
+	buffer = "";
+	bytesLength = 0;
+	setBodyOnly(httpCode_, retryAfter_);
+	externalBody = body;
+	bodyLength = (uint32_t)length;
+}
+
+void WorldTimeAPIResponse::setError(WorldTimeAPI_HttpCode httpCode_) {
+	buffer = "";
+	bytesLength = 0;
+	setBodyOnly(httpCode_, 0);
+}
@@ -0,0 +1,205 @@
+/**
+ * @file WorldTimeAPIResponse.h
+ * @brief This file contains reusable receive buffer of HTTP response with views of status, headers and body.
+ *
+ * @see WorldTimeAPIResponse
+ */
+
+#ifndef WORLD_TIME_API_RESPONSE_H_
+#define WORLD_TIME_API_RESPONSE_H_
+
+#include "WorldTimeAPI.h"
+#include "WorldTimeAPIArena.h"
+
+#if defined(SJSONP_UNDER_OS)
+#define WTAPI_RESPONSE_MAX_HEADERS (32)
+#else
+#define WTAPI_RESPONSE_MAX_HEADERS (16)
+#endif // SJSONP_UNDER_OS
+
+/**
+* @struct WorldTimeAPIStringView
+* @brief Part of string, which is not owned. It is not null terminated.
+*/
+struct WorldTimeAPIStringView {
+	const char* data;
+	size_t length;
+
+	/**
+	* @brief Compares view with null terminated string, letters are compared case insensitive.
+	*/
+	bool equalsIgnoreCase(const char* text) const;
+};
+
+/**
+* @class WorldTimeAPIResponse
+* @brief Receive buffer of HTTP response. Transport stores raw response (status line, headers and body)
+* to buffer and indexes it in one pass, so status, headers and body are only views of buffer and body
+* is passed to parser without copying. Buffer keeps its capacity, so response reused by next requests
+* does not allocate memory, when new response is not longer than previous ones.
+*
+* Transports, which receive data in parts, store them by append() to arena of response. Arena is
+* released in O(1) by clear() and its block is sized from high-water mark of previous responses.
+* Transports, which implement only get(), store body to getBuffer().
+* @note Views are valid until response is cleared or reused.
+* @see WorldTimeAPITransport::fetch()
+*/
+class WorldTimeAPIResponse {
+public:
+	WorldTimeAPIResponse();
+
+	/**
+	* @brief Clears response and resets arena. Capacity of buffer and block of arena are kept.
+	*/
+	void clear();
+
+	/**
+	* @brief Gets arena, from which received data are allocated. It can be used for scratch memory of request too.
+	*/
+	inline WorldTimeAPIArena& getArena() {
+		return arena;
+	}
+
+	/**
+	* @brief Gets HTTP code of response or negative error code.
+	*/
+	inline WorldTimeAPI_HttpCode getHttpCode() const {
+		return httpCode;
+	}
+
+	/**
+	* @brief Gets value of Retry-After header in seconds or 0 if it was not found.
+	*/
+	inline uint32_t getRetryAfter() const {
+		return retryAfter;
+	}
+
+	/**
+	* @brief Gets status line without line ending, for example "HTTP/1.1 200 OK". It is empty,
+	* if transport provides only body.
+	*/
+	WorldTimeAPIStringView getStatus() const;
+
+	/**
+	* @brief Gets body of response.
+	*/
+	WorldTimeAPIStringView getBody() const;
+
+	/**
+	* @brief Gets all received data (status line, headers and body) as they were stored by transport.
+	*/
+	WorldTimeAPIStringView getRaw() const;
+
+	/**
+	* @brief Gets count of indexed headers. At most WTAPI_RESPONSE_MAX_HEADERS headers are indexed.
+	*/
+	inline uint8_t getHeaderCount() const {
+		return headerCount;
+	}
+
+	/**
+	* @brief Gets name of header.
+	*/
+	WorldTimeAPIStringView getHeaderName(uint8_t index) const;
+
+	/**
+	* @brief Gets value of header without leading and trailing white characters.
+	*/
+	WorldTimeAPIStringView getHeaderValue(uint8_t index) const;
+
+	/**
+	* @brief Finds value of header by name (case insensitive).
+	* @param[in] name Name of header, for example "Content-Type".
+	* @param[out] value Value of header.
+	* @return Returns false if header was not found.
+	*/
+	bool findHeader(const char* name, WorldTimeAPIStringView& value) const;
+
+	//Methods used by transports
+
+#if defined(SJSONP_UNDER_OS)
+	/**
+	* @brief Gets buffer, to which transport stores received data.
+	*/
+	inline std::string& getBuffer() {
+		return buffer;
+	}
+#elif defined(ARDUINO)
+	inline String& getBuffer() {
+		return buffer;
+	}
+#endif // SJSONP_UNDER_OS
+
+	/**
+	* @brief Appends received data to arena. Data are stored in one piece, which grows in place while
+	* it is the last allocation of arena.
+	* @return Returns false if memory cannot be allocated.
+	*/
+	bool append(const char* data, size_t length);
+
+	/**
+	* @brief Indexes raw response (status line, headers and body) stored in buffer. Status code,
+	* Retry-After header, headers and body are found in one pass. Interim responses (1xx) are skipped.
+	* @return Returns HTTP code of response or WTA_HTTP_ERROR_CONNECTION_FAILED if buffer does not contain HTTP response.
+	*/
+	WorldTimeAPI_HttpCode parse();
+
+	/**
+	* @brief Sets result of transport, which stored only body to buffer.
+	*/
+	void setBodyOnly(WorldTimeAPI_HttpCode httpCode_, uint32_t retryAfter_);
+
+	/**
+	* @brief Sets result with body, which is not stored in buffer (for example canned response).
+	* @param body Body of response, it has to exist while response is used.
+	*/
+	void setExternalBody(WorldTimeAPI_HttpCode httpCode_, uint32_t retryAfter_, const char* body, size_t length);
+
+	/**
+	* @brief Sets error of request. Body is empty.
+	*/
+	void setError(WorldTimeAPI_HttpCode httpCode_);
+
+protected:
+	/**
+	* @struct Header
+	* @brief Offsets of header in buffer.
+	*/
+	struct Header {
+		uint32_t name;
+		uint32_t value;
+		uint16_t nameLength;
+		uint16_t valueLength;
+	};
+
+	inline const char* data() const {
+		return bytes != NULL ? bytes : buffer.c_str();
+	}
+
+	inline size_t size() const {
+		return bytes != NULL ? bytesLength : buffer.length();
+	}
+
+#if defined(SJSONP_UNDER_OS)
+	std::string buffer;
+#elif defined(ARDUINO)
+	String buffer;
+#endif // SJSONP_UNDER_OS
+
+	WorldTimeAPIArena arena;
+	char* bytes;          //Data appended to arena, NULL if buffer is used
+	size_t bytesLength;
+	size_t bytesCapacity;
+
+	WorldTimeAPI_HttpCode httpCode;
+	uint32_t retryAfter;
+	uint32_t statusOffset;
+	uint32_t statusLength;
+	uint32_t bodyOffset;
+	uint32_t bodyLength;
+	const char* externalBody;
+	Header headers[WTAPI_RESPONSE_MAX_HEADERS];
+	uint8_t headerCount;
+};
+
+#endif // !WORLD_TIME_API_RESPONSE_H_
@@ -0,0 +1,683 @@
+#include "WorldTimeAPITLS.h"
+
+#include <cstring>
+#include <ctype.h>
+#include <stdio.h>
+
+#if defined(WTAPI_OPENSSL)
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL (0)
+#endif // !MSG_NOSIGNAL
+
+/**
+* @brief Blocks SIGPIPE in current thread while OpenSSL writes to socket, which was closed by peer.
+* Pending SIGPIPE raised by write is consumed, so signal handlers of application are not affected.
+*/
+class WorldTimeAPISigPipeGuard {
+public:
+	WorldTimeAPISigPipeGuard() {
+		sigemptyset(&set);
+		sigaddset(&set, SIGPIPE);
+		sigset_t pending;
+		sigemptyset(&pending);
+		sigpending(&pending);
+		wasPending = sigismember(&pending, SIGPIPE) == 1;
+		pthread_sigmask(SIG_BLOCK, &set, &old);
+	}
+
+	~WorldTimeAPISigPipeGuard() {
+		if (!wasPending) {
+			sigset_t pending;
+			sigemptyset(&pending);
+			sigpending(&pending);
+			if (sigismember(&pending, SIGPIPE) == 1) {
+				struct timespec zero = { 0, 0 };
+				sigtimedwait(&set, NULL, &zero);
+			}
+		}
+		pthread_sigmask(SIG_SETMASK, &old, NULL);
+	}
+
+protected:
+	sigset_t set;
+	sigset_t old;
+	bool wasPending;
+};
+
+/**
+* @brief Waits until socket is ready or deadline passes.
+* @return Returns false on timeout or error.
+*/
+static bool waitSocket(int fd, short events, uint32_t deadline) {
+	uint32_t now = WorldTimeAPIClock::now();
+	if (!WorldTimeAPIClock::isBefore(now, deadline)) return false;
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = events;
+	pfd.revents = 0;
+	int res;
+	do {
+		res = ::poll(&pfd, 1, (int)(deadline - now));
+	} while (res < 0 && errno == EINTR);
+	return res > 0;
+}
+
+WorldTimeAPIOpenSSLTransport::WorldTimeAPIOpenSSLTransport() :
+	verifyPeer(true),
+	maxIdle(WTAPI_TLS_MAX_IDLE),
+	idleTimeout(30000),
+	handshakes(0),
+	resumed(0),
+	reused(0)
+{
+	ctx = SSL_CTX_new(TLS_client_method());
+	if (ctx != NULL) {
+		SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+		SSL_CTX_set_default_verify_paths(ctx);
+		SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, NULL);
+		//Sessions are cached by transport per host, internal cache of OpenSSL is not used
+		SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+	}
+}
+
+WorldTimeAPIOpenSSLTransport::~WorldTimeAPIOpenSSLTransport() {
+	clear();
+	if (ctx != NULL) {
+		SSL_CTX_free(ctx);
+	}
+}
+
+bool WorldTimeAPIOpenSSLTransport::setCAFile(const char* path) {
+	return ctx != NULL && SSL_CTX_load_verify_locations(ctx, path, NULL) == 1;
+}
+
+void WorldTimeAPIOpenSSLTransport::setVerifyPeer(bool verify) {
+	verifyPeer = verify;
+	if (ctx != NULL) {
+		SSL_CTX_set_verify(ctx, verify ? SSL_VERIFY_PEER : SSL_VERIFY_NONE, NULL);
+	}
+}
+
+void WorldTimeAPIOpenSSLTransport::setKeepAlive(uint8_t maxIdle_, uint32_t idleTimeout_) {
+	std::lock_guard<std::mutex> lock(mutex);
+	maxIdle = maxIdle_ < WTAPI_TLS_MAX_IDLE ? maxIdle_ : WTAPI_TLS_MAX_IDLE;
+	idleTimeout = idleTimeout_;
+	while (idle.size() > maxIdle) {
+		close(idle.back());
+		idle.pop_back();
+	}
+}
+
+void WorldTimeAPIOpenSSLTransport::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < idle.size(); i++) {
+		close(idle[i]);
+	}
+	idle.clear();
+	for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+		SSL_SESSION_free(it->second);
+	}
+	sessions.clear();
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIOpenSSLTransport::get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	body.clear();
+	if (retryAfter != NULL) {
+		*retryAfter = 0;
+	}
+	char host[WTAPI_DNS_HOST_SIZE];
+	uint16_t port = 0;
+	bool tls = strncmp(url, "https://", 8) == 0;
+	if (ctx == NULL || (!tls && strncmp(url, "http://", 7) != 0) || !WorldTimeAPIDNSCache::parseURL(url, host, sizeof(host), port)) {
+		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+	}
+
+	const char* path = strchr(url + (tls ? 8 : 7), '/');
+	if (path == NULL) path = "/";
+	std::string request = "GET ";
+	request += path;
+	request += " HTTP/1.1\r\nHost: ";
+	request += host;
+	if (port != (tls ? 443 : 80)) {
+		request += ':';
+		request += std::to_string(port);
+	}
+	request += "\r\nUser-Agent: WorldTimeAPI\r\nAccept: */*\r\nConnection: ";
+	request += maxIdle > 0 ? "keep-alive\r\n\r\n" : "close\r\n\r\n";
+
+	uint32_t deadline = WorldTimeAPIClock::now() + timeout;
+	for (uint8_t attempt = 0; attempt < 2; attempt++) {
+		Connection conn;
+		bool wasReused = false;
+		WorldTimeAPI_HttpCode httpCode = acquire(conn, host, port, tls, deadline, dns, wasReused);
+		if (httpCode != WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+			return httpCode;
+		}
+
+		bool keepAlive = false;
+		bool received = false;
+		httpCode = exchange(conn, request.c_str(), (int)request.length(), body, retryAfter, deadline, keepAlive, received);
+		if (httpCode <= WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE && wasReused && !received &&
+			WorldTimeAPIClock::isBefore(WorldTimeAPIClock::now(), deadline)) {
+			//Idle connection was closed by server, request is sent again over new connection
+			close(conn);
+			continue;
+		}
+		release(conn, keepAlive && httpCode > WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE);
+		return httpCode;
+	}
+	return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_LOST;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIOpenSSLTransport::acquire(Connection& conn, const char* host, uint16_t port, bool tls, uint32_t deadline, WorldTimeAPIDNSCache* dns, bool& wasReused) {
+	conn.key = tls ? "https://" : "http://";
+	conn.key += host;
+	conn.key += ':';
+	conn.key += std::to_string(port);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t i = idle.size(); i-- > 0;) {
+			if (WorldTimeAPIClock::elapsed(idle[i].lastUsed) >= idleTimeout) {
+				//Server probably closed it already
+				close(idle[i]);
+				idle.erase(idle.begin() + i);
+			}
+			else if (!wasReused && idle[i].key == conn.key) {
+				conn = idle[i];
+				idle.erase(idle.begin() + i);
+				wasReused = true;
+			}
+		}
+	}
+	if (wasReused) {
+		reused++;
+		return WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	}
+	return open(conn, host, port, tls, deadline, dns);
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIOpenSSLTransport::open(Connection& conn, const char* host, uint16_t port, bool tls, uint32_t deadline, WorldTimeAPIDNSCache* dns) {
+	//Resolving
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	std::vector<std::string> addresses;
+	std::string address;
+	if (dns != NULL && dns->resolve(host, addresses)) {
+		address = addresses[0];
+		hints.ai_flags = AI_NUMERICHOST;
+		if (address.size() > 2 && address[0] == '[') {
+			address = address.substr(1, address.size() - 2);
+		}
+	}
+	char service[8];
+	snprintf(service, sizeof(service), "%u", (unsigned)port);
+	struct addrinfo* info = NULL;
+	if (getaddrinfo(address.empty() ? host : address.c_str(), service, &hints, &info) != 0 || info == NULL) {
+		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+	}
+
+	//Connecting
+	conn.fd = ::socket(info->ai_family, SOCK_STREAM, 0);
+	if (conn.fd < 0) {
+		freeaddrinfo(info);
+		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+	}
+	fcntl(conn.fd, F_SETFL, fcntl(conn.fd, F_GETFL, 0) | O_NONBLOCK);
+	int res = ::connect(conn.fd, info->ai_addr, info->ai_addrlen);
+	freeaddrinfo(info);
+	if (res != 0) {
+		bool connected = false;
+		bool timedOut = false;
+		if (errno == EINPROGRESS) {
+			if (waitSocket(conn.fd, POLLOUT, deadline)) {
+				int err = 0;
+				socklen_t len = sizeof(err);
+				connected = getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0;
+			}
+			else {
+				timedOut = true;
+			}
+		}
+		if (!connected) {
+			close(conn);
+			if (dns != NULL && !address.empty()) {
+				dns->markFailed(host, addresses[0]);
+			}
+			return timedOut ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+		}
+	}
+	if (!tls) {
+		return WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+	}
+
+	//TLS handshake, cached session of host is resumed
+	conn.ssl = SSL_new(ctx);
+	if (conn.ssl == NULL) {
+		close(conn);
+		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+	}
+	SSL_set_fd(conn.ssl, conn.fd);
+	unsigned char ip[16];
+	bool isIP = inet_pton(AF_INET, host, ip) == 1 || inet_pton(AF_INET6, host, ip) == 1;
+	if (isIP) {
+		X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(conn.ssl), host);
+	}
+	else {
+		SSL_set_tlsext_host_name(conn.ssl, host);
+		SSL_set1_host(conn.ssl, host);
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = sessions.find(conn.key);
+		if (it != sessions.end()) {
+			SSL_set_session(conn.ssl, it->second);
+		}
+	}
+
+	while (true) {
+		int ret;
+		{
+			WorldTimeAPISigPipeGuard guard;
+			ret = SSL_connect(conn.ssl);
+		}
+		if (ret == 1) break;
+		int err = SSL_get_error(conn.ssl, ret);
+		bool ready = false;
+		if (err == SSL_ERROR_WANT_READ) {
+			ready = waitSocket(conn.fd, POLLIN, deadline);
+		}
+		else if (err == SSL_ERROR_WANT_WRITE) {
+			ready = waitSocket(conn.fd, POLLOUT, deadline);
+		}
+		else {
+			//Handshake or verification failed, cached session is not used again
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = sessions.find(conn.key);
+			if (it != sessions.end()) {
+				SSL_SESSION_free(it->second);
+				sessions.erase(it);
+			}
+			close(conn);
+			return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+		}
+		if (!ready) {
+			close(conn);
+			return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+		}
+	}
+	if (SSL_session_reused(conn.ssl)) {
+		resumed++;
+	}
+	else {
+		handshakes++;
+	}
+	return WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE;
+}
+
+void WorldTimeAPIOpenSSLTransport::release(Connection& conn, bool keep) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (conn.ssl != NULL) {
+		//TLS 1.3 tickets are received after handshake, so session is stored after response
+		SSL_SESSION* session = SSL_get1_session(conn.ssl);
+		if (session != NULL && SSL_SESSION_is_resumable(session)) {
+			auto it = sessions.find(conn.key);
+			if (it != sessions.end()) {
+				if (it->second == session) {
+					SSL_SESSION_free(session); //Already cached
+				}
+				else {
+					SSL_SESSION_free(it->second);
+					it->second = session;
+				}
+			}
+			else {
+				sessions[conn.key] = session;
+			}
+		}
+		else if (session != NULL) {
+			SSL_SESSION_free(session);
+		}
+	}
+	if (keep && idle.size() < maxIdle) {
+		conn.lastUsed = WorldTimeAPIClock::now();
+		idle.push_back(conn);
+	}
+	else {
+		close(conn);
+	}
+}
+
+void WorldTimeAPIOpenSSLTransport::close(Connection& conn) {
+	if (conn.ssl != NULL) {
+		{
+			//Sending close_notify, so session stays resumable
+			WorldTimeAPISigPipeGuard guard;
+			SSL_shutdown(conn.ssl);
+		}
+		SSL_free(conn.ssl);
+		conn.ssl = NULL;
+	}
+	if (conn.fd >= 0) {
+		::close(conn.fd);
+		conn.fd = -1;
+	}
+}
+
+bool WorldTimeAPIOpenSSLTransport::writeAll(Connection& conn, const char* data, int length, uint32_t deadline) {
+	int sent = 0;
+	while (sent < length) {
+		if (conn.ssl != NULL) {
+			int ret;
+			{
+				WorldTimeAPISigPipeGuard guard;
+				ret = SSL_write(conn.ssl, data + sent, length - sent);
+			}
+			if (ret > 0) {
+				sent += ret;
+				continue;
+			}
+			int err = SSL_get_error(conn.ssl, ret);
+			if (err == SSL_ERROR_WANT_WRITE) {
+				if (!waitSocket(conn.fd, POLLOUT, deadline)) return false;
+			}
+			else if (err == SSL_ERROR_WANT_READ) {
+				if (!waitSocket(conn.fd, POLLIN, deadline)) return false;
+			}
+			else {
+				return false;
+			}
+		}
+		else {
+			ssize_t ret = ::send(conn.fd, data + sent, length - sent, MSG_NOSIGNAL);
+			if (ret > 0) {
+				sent += (int)ret;
+			}
+			else if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+				if (!waitSocket(conn.fd, POLLOUT, deadline)) return false;
+			}
+			else {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int WorldTimeAPIOpenSSLTransport::readSome(Connection& conn, char* buffer, int size, uint32_t deadline) {
+	while (true) {
+		if (conn.ssl != NULL) {
+			int ret = SSL_read(conn.ssl, buffer, size);
+			if (ret > 0) return ret;
+			int err = SSL_get_error(conn.ssl, ret);
+			if (err == SSL_ERROR_WANT_READ) {
+				if (!waitSocket(conn.fd, POLLIN, deadline)) return -1;
+			}
+			else if (err == SSL_ERROR_WANT_WRITE) {
+				if (!waitSocket(conn.fd, POLLOUT, deadline)) return -1;
+			}
+			else if (err == SSL_ERROR_ZERO_RETURN || (err == SSL_ERROR_SYSCALL && ret == 0)) {
+				return 0; //Closed by peer
+			}
+			else {
+				return -1;
+			}
+		}
+		else {
+			ssize_t ret = ::recv(conn.fd, buffer, size, 0);
+			if (ret >= 0) return (int)ret;
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+				if (!waitSocket(conn.fd, POLLIN, deadline)) return -1;
+			}
+			else {
+				return -1;
+			}
+		}
+	}
+}
+
+/**
+* @brief Compares name of header with lower case key.
+*/
+static bool headerIs(const char* line, size_t nameLength, const char* key) {
+	if (strlen(key) != nameLength) return false;
+	for (size_t i = 0; i < nameLength; i++) {
+		if (tolower((unsigned char)line[i]) != key[i]) return false;
+	}
+	return true;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIOpenSSLTransport::exchange(Connection& conn, const char* request, int requestLength, std::string& body, uint32_t* retryAfter,
+	uint32_t deadline, bool& keepAlive, bool& received) {
+	keepAlive = false;
+	received = false;
+	if (!writeAll(conn, request, requestLength, deadline)) {
+		return WorldTimeAPIClock::isBefore(WorldTimeAPIClock::now(), deadline) ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_SEND_HEADER_FAILED : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+	}
+
+	//Receiving headers
+	std::string rx;
+	char buffer[4096];
+	size_t headersEnd;
+	while ((headersEnd = rx.find("\r\n\r\n")) == std::string::npos) {
+		int len = readSome(conn, buffer, sizeof(buffer), deadline);
+		if (len <= 0) {
+			if (len < 0 && !WorldTimeAPIClock::isBefore(WorldTimeAPIClock::now(), deadline)) return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+			return received ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_LOST : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_NOT_CONNECTED;
+		}
+		received = true;
+		rx.append(buffer, len);
+	}
+
+	int httpCode = 0;
+	if (rx.compare(0, 5, "HTTP/") != 0 || sscanf(rx.c_str(), "%*s %d", &httpCode) != 1 || httpCode < 100) {
+		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_NO_HTTP_SERVER;
+	}
+	keepAlive = rx.compare(0, 8, "HTTP/1.1") == 0;
+	int64_t contentLength = -1;
+	bool chunked = false;
+	for (size_t line = rx.find("\r\n") + 2; line < headersEnd; ) {
+		size_t lineEnd = rx.find("\r\n", line);
+		size_t colon = rx.find(':', line);
+		if (colon != std::string::npos && colon < lineEnd) {
+			size_t value = colon + 1;
+			while (value < lineEnd && (rx[value] == ' ' || rx[value] == '\t')) value++;
+			const char* name = rx.c_str() + line;
+			size_t nameLength = colon - line;
+			if (headerIs(name, nameLength, "content-length")) {
+				contentLength = strtoll(rx.c_str() + value, NULL, 10);
+			}
+			else if (headerIs(name, nameLength, "transfer-encoding")) {
+				chunked = rx.compare(value, 7, "chunked") == 0;
+			}
+			else if (headerIs(name, nameLength, "connection")) {
+				keepAlive = rx.compare(value, 10, "keep-alive") == 0 || (keepAlive && rx.compare(value, 5, "close") != 0);
+			}
+			else if (headerIs(name, nameLength, "retry-after") && retryAfter != NULL) {
+				*retryAfter = WorldTimeAPI::parseRetryAfter(rx.c_str() + value, (int)(lineEnd - value));
+			}
+		}
+		line = lineEnd + 2;
+	}
+	rx.erase(0, headersEnd + 4);
+
+	//Receiving body
+	if (httpCode == 204 || httpCode == 304 || httpCode < 200) {
+		return (WorldTimeAPI_HttpCode)httpCode;
+	}
+	if (chunked) {
+		size_t pos = 0;
+		bool lastChunk = false;
+		while (true) {
+			size_t lineEnd = rx.find("\r\n", pos);
+			if (lineEnd != std::string::npos && lastChunk) {
+				if (lineEnd == pos) {
+					//Empty line ends trailers
+					pos += 2;
+					break;
+				}
+				pos = lineEnd + 2; //Trailer is ignored
+				continue;
+			}
+			if (lineEnd != std::string::npos) {
+				const char* sizeStart = rx.c_str() + pos;
+				char* sizeEnd = NULL;
+				unsigned long size = strtoul(sizeStart, &sizeEnd, 16);
+				if (!isxdigit((unsigned char)*sizeStart) || size > 0x7FFFFFFF || (*sizeEnd != ';' && *sizeEnd != ' ' && *sizeEnd != '\t' && *sizeEnd != '\r')) {
+					keepAlive = false; //Rest of body cannot be found
+					return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_ENCODING;
+				}
+				if (size == 0) {
+					lastChunk = true;
+					pos = lineEnd + 2;
+					continue;
+				}
+				if (rx.length() >= lineEnd + 2 + size + 2) {
+					if (rx.compare(lineEnd + 2 + size, 2, "\r\n") != 0) {
+						keepAlive = false;
+						return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_ENCODING;
+					}
+					body.append(rx, lineEnd + 2, size);
+					pos = lineEnd + 2 + size + 2;
+					continue;
+				}
+			}
+			int len = readSome(conn, buffer, sizeof(buffer), deadline);
+			if (len <= 0) {
+				keepAlive = false;
+				return len < 0 ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_LOST;
+			}
+			rx.append(buffer, len);
+		}
+		if (rx.length() > pos) {
+			keepAlive = false; //Unexpected data after body, connection cannot be reused
+		}
+	}
+	else if (contentLength >= 0) {
+		while ((int64_t)rx.length() < contentLength) {
+			int len = readSome(conn, buffer, sizeof(buffer), deadline);
+			if (len <= 0) {
+				keepAlive = false;
+				return len < 0 ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_LOST;
+			}
+			rx.append(buffer, len);
+		}
+		if ((int64_t)rx.length() > contentLength) {
+			keepAlive = false; //Unexpected data after body, connection cannot be reused
+			rx.resize((size_t)contentLength);
+		}
+		body.swap(rx);
+	}
+	else {
+		//Body ends with connection
+		keepAlive = false;
+		int len;
+		while ((len = readSome(conn, buffer, sizeof(buffer), deadline)) > 0) {
+			rx.append(buffer, len);
+		}
+		if (len < 0) {
+			return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+		}
+		body.swap(rx);
+	}
+	return (WorldTimeAPI_HttpCode)httpCode;
+}
+#endif // WTAPI_OPENSSL
+
+
+#if defined(WTAPI_SECURE_CLIENT)
+WorldTimeAPISecureClientTransport::WorldTimeAPISecureClientTransport() {
+#if defined(ESP8266)
+	trustAnchors = NULL;
+	client.setSession(&session);
+	client.setBufferSizes(1024, 512); //Responses are small, so smaller buffers are used if server supports MFLN
+#endif // ESP8266
+	http.setReuse(true);
+}
+
+WorldTimeAPISecureClientTransport::~WorldTimeAPISecureClientTransport() {
+	http.end();
+	client.stop();
+#if defined(ESP8266)
+	delete trustAnchors;
+#endif // ESP8266
+}
+
+void WorldTimeAPISecureClientTransport::setCACert(const char* pem) {
+#if defined(ESP8266)
+	delete trustAnchors;
+	trustAnchors = new BearSSL::X509List(pem);
+	client.setTrustAnchors(trustAnchors);
+#else
+	client.setCACert(pem);
+#endif // ESP8266
+}
+
+void WorldTimeAPISecureClientTransport::setInsecure() {
+	client.setInsecure();
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPISecureClientTransport::get(const char* url, String& resp, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	WorldTimeAPIResponse response;
+	WorldTimeAPI_HttpCode httpCode = fetch(url, response, timeout, dns);
+	WorldTimeAPIStringView body = response.getBody();
+	resp = "";
+	resp.concat(body.data, body.length);
+	if (retryAfter != NULL) {
+		*retryAfter = response.getRetryAfter();
+	}
+	return httpCode;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPISecureClientTransport::fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+#if defined(ESP32)
+	std::lock_guard<std::mutex> lock(mutex);
+#endif // ESP32
+	response.clear();
+	http.setTimeout(timeout > 0xFFFF ? 0xFFFF : timeout); //ESP8266 accepts only 16 bit timeout
+#ifdef ESP32
+	http.setConnectTimeout(timeout);
+#endif // ESP32
+
+	//Host name is needed for SNI and verification of certificate, so DNS cache is not used.
+	//HTTPClient keeps connection open, when begin() is called with the same host and port.
+	if (!http.begin(client, url)) {
+		response.setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+		return response.getHttpCode();
+	}
+	const char* headerKeys[] = { "Retry-After" };
+	http.collectHeaders(headerKeys, 1);
+	int httpCode = http.GET();
+	if (httpCode <= 0) {
+		http.end();
+		response.setError((WorldTimeAPI_HttpCode)httpCode);
+		return response.getHttpCode();
+	}
+	String value = http.header(headerKeys[0]);
+	uint32_t retryAfter = WorldTimeAPI::parseRetryAfter(value.c_str(), (int)value.length());
+	WorldTimeAPIResponseWriter writer(response); //Body is decoded to arena, keep-alive is kept
+	int written = http.writeToStream(&writer);
+	http.end(); //Connection is kept, if server allows keep-alive
+	if (written < 0) {
+		response.setError((WorldTimeAPI_HttpCode)written);
+		return response.getHttpCode();
+	}
+	response.setBodyOnly((WorldTimeAPI_HttpCode)httpCode, retryAfter);
+	return response.getHttpCode();
+}
+#endif // WTAPI_SECURE_CLIENT
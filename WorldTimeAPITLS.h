@@ -0,0 +1,223 @@
+/**
+ * @file WorldTimeAPITLS.h
+ * @brief This file contains HTTPS transports with TLS session resumption and reuse of connections.
+ *
+ * @see WorldTimeAPIOpenSSLTransport
+ * @see WorldTimeAPISecureClientTransport
+ */
+
+#ifndef WORLD_TIME_API_TLS_H_
+#define WORLD_TIME_API_TLS_H_
+
+#include "WorldTimeAPITransport.h"
+
+#if defined(SJSONP_UNDER_OS) && defined(WTAPI_USE_OPENSSL) && !(defined(_WIN64) || defined(_WIN32))
+//OpenSSL transport has to be enabled by WTAPI_USE_OPENSSL and application has to be linked with -lssl -lcrypto
+#define WTAPI_OPENSSL (1)
+#endif // SJSONP_UNDER_OS && WTAPI_USE_OPENSSL
+
+#if (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+#define WTAPI_SECURE_CLIENT (1)
+#endif // ESP8266 || ESP32
+
+#define WTAPI_TLS_MAX_IDLE        (4)
+
+#if defined(WTAPI_OPENSSL)
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+typedef struct ssl_ctx_st SSL_CTX;
+typedef struct ssl_st SSL;
+typedef struct ssl_session_st SSL_SESSION;
+
+/**
+* @class WorldTimeAPIOpenSSLTransport
+* @brief HTTPS and HTTP transport over OpenSSL with keep-alive connections. Idle connections are kept in pool
+* and reused by next requests to the same host, so steady-state requests need no TCP or TLS handshake.
+* When new connection has to be opened, cached TLS session (or TLS 1.3 ticket) of host is resumed,
+* so full handshake is done only once per host. Certificate of server and host name are verified.
+* Transport can be used by multiple threads at once, each request uses its own connection.
+*
+* @code
+* //Compile with -DWTAPI_USE_OPENSSL and link with -lssl -lcrypto
+* WorldTimeAPIOpenSSLTransport tls;
+* WorldTimeAPI api(&tls);
+* WorldTimeAPIEndpoints endpoints;
+* endpoints.add("https://worldtimeapi.org/api");
+* api.setEndpoints(&endpoints);
+* @endcode
+*/
+class WorldTimeAPIOpenSSLTransport : public WorldTimeAPITransport {
+public:
+	WorldTimeAPIOpenSSLTransport();
+	~WorldTimeAPIOpenSSLTransport();
+
+	/**
+	* @brief Sets file with trusted certificates in PEM format. By default, certificates of system are used.
+	* @param path Path to file, for example self-signed certificate of test server.
+	* @return Returns true if certificates were loaded.
+	*/
+	bool setCAFile(const char* path);
+
+	/**
+	* @brief Enables or disables verification of server certificate. Enabled by default.
+	* @warning Disable verification only for testing.
+	*/
+	void setVerifyPeer(bool verify);
+
+	/**
+	* @brief Sets limits of pool of idle connections.
+	* @param maxIdle Maximal count of idle connections (at most WTAPI_TLS_MAX_IDLE). If 0, connections are not reused.
+	* @param idleTimeout Time in milliseconds, after which idle connection is closed. Default is 30000 ms.
+	*/
+	void setKeepAlive(uint8_t maxIdle, uint32_t idleTimeout = 30000);
+
+	/**
+	* @brief Closes all idle connections and forgets cached TLS sessions.
+	*/
+	void clear();
+
+	/**
+	* @brief Gets count of full TLS handshakes.
+	*/
+	inline uint32_t getHandshakeCount() const {
+		return handshakes.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Gets count of TLS handshakes, which resumed cached session.
+	*/
+	inline uint32_t getResumedCount() const {
+		return resumed.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Gets count of requests sent over reused connection.
+	*/
+	inline uint32_t getReusedCount() const {
+		return reused.load(std::memory_order_relaxed);
+	}
+
+	WorldTimeAPI_HttpCode get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+protected:
+	/**
+	* @struct Connection
+	* @brief Open connection. SSL is NULL for plain HTTP.
+	*/
+	struct Connection {
+		std::string key; //"https://host:port" or "http://host:port"
+		int fd = -1;
+		SSL* ssl = NULL;
+		uint32_t lastUsed = 0;
+	};
+
+	/**
+	* @brief Takes idle connection from pool or opens new one.
+	*/
+	WorldTimeAPI_HttpCode acquire(Connection& conn, const char* host, uint16_t port, bool tls, uint32_t deadline, WorldTimeAPIDNSCache* dns, bool& wasReused);
+
+	/**
+	* @brief Opens TCP connection and makes TLS handshake.
+	*/
+	WorldTimeAPI_HttpCode open(Connection& conn, const char* host, uint16_t port, bool tls, uint32_t deadline, WorldTimeAPIDNSCache* dns);
+
+	/**
+	* @brief Returns connection to pool or closes it.
+	*/
+	void release(Connection& conn, bool keep);
+
+	/**
+	* @brief Closes connection.
+	*/
+	static void close(Connection& conn);
+
+	/**
+	* @brief Sends request and receives response.
+	* @param[out] received True if at least one byte of response was received.
+	*/
+	static WorldTimeAPI_HttpCode exchange(Connection& conn, const char* request, int requestLength, std::string& body, uint32_t* retryAfter,
+		uint32_t deadline, bool& keepAlive, bool& received);
+
+	static bool writeAll(Connection& conn, const char* data, int length, uint32_t deadline);
+
+	/**
+	* @brief Reads data from connection.
+	* @return Returns count of read bytes, 0 if connection was closed or -1 on error or timeout.
+	*/
+	static int readSome(Connection& conn, char* buffer, int size, uint32_t deadline);
+
+	SSL_CTX* ctx;
+	bool verifyPeer;
+	uint8_t maxIdle;
+	uint32_t idleTimeout;
+
+	std::mutex mutex;
+	std::vector<Connection> idle;
+	std::map<std::string, SSL_SESSION*> sessions;
+
+	std::atomic<uint32_t> handshakes;
+	std::atomic<uint32_t> resumed;
+	std::atomic<uint32_t> reused;
+};
+#endif // WTAPI_OPENSSL
+
+#if defined(WTAPI_SECURE_CLIENT)
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#include <WiFiClientSecure.h>
+#else
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include <mutex>
+#endif // ESP8266
+
+/**
+* @class WorldTimeAPISecureClientTransport
+* @brief HTTPS transport over WiFiClientSecure. Connection is kept open between requests (keep-alive),
+* so steady-state requests need no TLS handshake. On ESP8266 BearSSL session is cached, so reconnecting
+* resumes session instead of full handshake. ESP32 core does not expose session resumption, only connection
+* is reused.
+* @note Connection is shared, so requests from multiple threads are serialized.
+*/
+class WorldTimeAPISecureClientTransport : public WorldTimeAPITransport {
+public:
+	WorldTimeAPISecureClientTransport();
+	~WorldTimeAPISecureClientTransport();
+
+	/**
+	* @brief Sets trusted root certificate in PEM format. It is not copied on ESP32, so it has to exist while transport is used.
+	*/
+	void setCACert(const char* pem);
+
+	/**
+	* @brief Disables verification of server certificate.
+	* @warning Use it only for testing.
+	*/
+	void setInsecure();
+
+	WorldTimeAPI_HttpCode get(const char* url, String& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+	/**
+	* @brief Stores body to arena of response while it is received, String is not used.
+	*/
+	WorldTimeAPI_HttpCode fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+protected:
+	WiFiClientSecure client;
+	HTTPClient http;
+#if defined(ESP8266)
+	BearSSL::Session session;
+	BearSSL::X509List* trustAnchors;
+#else
+	std::mutex mutex;
+#endif // ESP8266
+};
+#endif // WTAPI_SECURE_CLIENT
+
+#endif // !WORLD_TIME_API_TLS_H_
@@ -0,0 +1,456 @@
+#include "WorldTimeAPITZif.h"
+
+#ifdef WTAPI_TZIF
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//Maximal length of time zone name
+#define WTAPI_TZIF_MAX_NAME       (128)
+
+static inline uint32_t readBE32(const uint8_t* p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint64_t readBE64(const uint8_t* p) {
+	return ((uint64_t)readBE32(p) << 32) | readBE32(p + 4);
+}
+
+static void copyAbbr(char* dest, const char* src, int srcLength) {
+	int len = 0;
+	for (; len < srcLength && len < WTAPI_TZIF_ABR_SIZE - 1 && src[len] != 0; len++) {
+		dest[len] = src[len];
+	}
+	dest[len] = 0;
+}
+
+WorldTimeAPITZif& WorldTimeAPITZif::global() {
+	static WorldTimeAPITZif resolver;
+	return resolver;
+}
+
+WorldTimeAPITZif::WorldTimeAPITZif() : directory("/usr/share/zoneinfo")
+{}
+
+WorldTimeAPITZif::~WorldTimeAPITZif() {
+	for (auto& it : zones) {
+		munmap((void*)it.second->map, it.second->mapSize);
+		delete it.second;
+	}
+}
+
+void WorldTimeAPITZif::setDirectory(const char* dir) {
+	std::lock_guard<std::mutex> lock(mutex);
+	directory = (dir != NULL) ? dir : "";
+}
+
+bool WorldTimeAPITZif::lookup(const char* tz, int64_t unixTime, ZoneState& state) {
+	const Zone* zone = getZone(tz);
+	if (zone == NULL) {
+		return false;
+	}
+	getState(*zone, unixTime, state);
+	return true;
+}
+
+const WorldTimeAPITZif::Zone* WorldTimeAPITZif::getZone(const char* tz) {
+	if (tz == NULL || tz[0] == 0 || tz[0] == '/') return NULL;
+
+	//Validating name, so it cannot point outside of directory
+	size_t len = 0;
+	for (; tz[len] != 0; len++) {
+		char c = tz[len];
+		bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+			c == '_' || c == '-' || c == '+' || (c == '/' && tz[len + 1] != '/');
+		if (!valid || len >= WTAPI_TZIF_MAX_NAME || (c == '/' && tz[len + 1] == '.')) {
+			return NULL;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = zones.find(tz);
+	if (it != zones.end()) {
+		return it->second;
+	}
+
+	std::string path = directory + '/' + tz;
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return NULL;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < 44) {
+		close(fd);
+		return NULL;
+	}
+	void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return NULL;
+	}
+
+	Zone* zone = new Zone();
+	zone->map = (const uint8_t*)map;
+	zone->mapSize = (size_t)st.st_size;
+	if (!parseZone(*zone)) {
+		munmap(map, zone->mapSize);
+		delete zone;
+		return NULL;
+	}
+	zones[tz] = zone;
+	return zone;
+}
+
+bool WorldTimeAPITZif::parseZone(Zone& zone) {
+	const uint8_t* data = zone.map;
+	size_t size = zone.mapSize;
+	if (size < 44 || memcmp(data, "TZif", 4) != 0) {
+		return false; //Not TZif file
+	}
+	uint8_t version = data[4];
+
+	size_t pos = 0;
+	uint32_t isutcnt = readBE32(data + 20);
+	uint32_t isstdcnt = readBE32(data + 24);
+	uint32_t leapcnt = readBE32(data + 28);
+	uint32_t timecnt = readBE32(data + 32);
+	uint32_t typecnt = readBE32(data + 36);
+	uint32_t charcnt = readBE32(data + 40);
+	size_t blockSize = (size_t)timecnt * 5 + (size_t)typecnt * 6 + charcnt + (size_t)leapcnt * 8 + isstdcnt + isutcnt;
+	zone.timeSize = 4;
+
+	if (version >= '2') {
+		//Skipping version 1 data, version 2 data has 64 bit times
+		pos = 44 + blockSize;
+		if (pos + 44 > size || memcmp(data + pos, "TZif", 4) != 0) {
+			return false;
+		}
+		isutcnt = readBE32(data + pos + 20);
+		isstdcnt = readBE32(data + pos + 24);
+		leapcnt = readBE32(data + pos + 28);
+		timecnt = readBE32(data + pos + 32);
+		typecnt = readBE32(data + pos + 36);
+		charcnt = readBE32(data + pos + 40);
+		blockSize = (size_t)timecnt * 9 + (size_t)typecnt * 6 + charcnt + (size_t)leapcnt * 12 + isstdcnt + isutcnt;
+		zone.timeSize = 8;
+	}
+	pos += 44;
+
+	if (typecnt == 0 || pos + blockSize > size) {
+		return false; //Corrupted file
+	}
+
+	zone.timeCount = timecnt;
+	zone.times = data + pos;
+	zone.timeTypes = zone.times + (size_t)timecnt * zone.timeSize;
+	zone.typeCount = typecnt;
+	zone.types = zone.timeTypes + timecnt;
+	zone.abbrs = (const char*)(zone.types + (size_t)typecnt * 6);
+	zone.abbrCount = charcnt;
+
+	for (uint32_t i = 0; i < timecnt; i++) {
+		if (zone.timeTypes[i] >= typecnt) return false;
+	}
+	for (uint32_t i = 0; i < typecnt; i++) {
+		if (zone.types[i * 6 + 5] >= charcnt) return false;
+	}
+
+	//Footer with POSIX TZ rule: "\n<rule>\n"
+	zone.hasFooter = false;
+	pos += blockSize;
+	if (version >= '2' && pos < size && data[pos] == '\n') {
+		size_t end = pos + 1;
+		for (; end < size && data[end] != '\n'; end++);
+		if (end < size && end > pos + 1) {
+			zone.hasFooter = zone.footer.parse((const char*)data + pos + 1, (int)(end - pos - 1));
+		}
+	}
+	return true;
+}
+
+int64_t WorldTimeAPITZif::Zone::time(uint32_t i) const {
+	if (timeSize == 8) {
+		return (int64_t)readBE64(times + (size_t)i * 8);
+	}
+	return (int32_t)readBE32(times + (size_t)i * 4);
+}
+
+int32_t WorldTimeAPITZif::Zone::typeOffset(uint8_t type) const {
+	return (int32_t)readBE32(types + (size_t)type * 6);
+}
+
+bool WorldTimeAPITZif::Zone::typeIsDST(uint8_t type) const {
+	return types[(size_t)type * 6 + 4] != 0;
+}
+
+const char* WorldTimeAPITZif::Zone::typeAbbr(uint8_t type) const {
+	return abbrs + types[(size_t)type * 6 + 5];
+}
+
+void WorldTimeAPITZif::getState(const Zone& zone, int64_t unixTime, ZoneState& state) {
+	uint32_t n = zone.timeCount;
+	if (zone.hasFooter && (n == 0 || unixTime >= zone.time(n - 1))) {
+		//After last transition, rule from footer is used
+		zone.footer.getState(unixTime, state);
+		return;
+	}
+
+	//Binary search of last transition before unixTime
+	int64_t idx = -1;
+	uint32_t lo = 0, hi = n;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (zone.time(mid) <= unixTime) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	idx = (int64_t)lo - 1;
+
+	uint8_t type = (idx >= 0) ? zone.timeTypes[idx] : 0;
+	state.utcOffset = zone.typeOffset(type);
+	state.isDST = zone.typeIsDST(type);
+	const char* abbr = zone.typeAbbr(type);
+	copyAbbr(state.abbreviation, abbr, (int)(zone.abbrCount - (abbr - zone.abbrs)));
+	state.hasDST = false;
+	state.dstFrom = 0;
+	state.dstUntil = 0;
+	state.stdOffset = state.utcOffset;
+	state.dstOffset = 0;
+
+	if (state.isDST) {
+		//Looking for end of current DST period
+		state.dstFrom = (idx >= 0) ? zone.time((uint32_t)idx) : unixTime;
+		uint32_t j = (uint32_t)(idx + 1);
+		for (; j < n && zone.typeIsDST(zone.timeTypes[j]); j++);
+		if (j < n) {
+			state.hasDST = true;
+			state.dstUntil = zone.time(j);
+			state.stdOffset = zone.typeOffset(zone.timeTypes[j]);
+		}
+		else if (zone.hasFooter && zone.footer.hasDST) {
+			ZoneState next;
+			zone.footer.getState(zone.time(n - 1), next);
+			state.hasDST = true;
+			state.dstUntil = next.dstUntil;
+			state.stdOffset = zone.footer.stdOffset;
+		}
+	}
+	else {
+		//Looking for next DST period
+		uint32_t j = (uint32_t)(idx + 1);
+		for (; j < n && !zone.typeIsDST(zone.timeTypes[j]); j++);
+		if (j < n) {
+			state.dstFrom = zone.time(j);
+			uint32_t k = j + 1;
+			for (; k < n && zone.typeIsDST(zone.timeTypes[k]); k++);
+			if (k < n) {
+				state.hasDST = true;
+				state.dstUntil = zone.time(k);
+			}
+			else if (zone.hasFooter && zone.footer.hasDST) {
+				ZoneState next;
+				zone.footer.getState(state.dstFrom, next);
+				state.hasDST = true;
+				state.dstUntil = next.dstUntil;
+			}
+			if (state.hasDST) {
+				int32_t before = (j > 0) ? zone.typeOffset(zone.timeTypes[j - 1]) : state.utcOffset;
+				state.stdOffset = state.utcOffset;
+				state.dstOffset = zone.typeOffset(zone.timeTypes[j]) - before;
+				return;
+			}
+		}
+		else if (zone.hasFooter && zone.footer.hasDST) {
+			//Next DST period is given by footer
+			ZoneState next;
+			zone.footer.getState(zone.time(n - 1), next);
+			state.hasDST = true;
+			state.dstFrom = next.dstFrom;
+			state.dstUntil = next.dstUntil;
+			state.dstOffset = zone.footer.dstOffset - zone.footer.stdOffset;
+			return;
+		}
+	}
+	state.dstOffset = state.utcOffset - state.stdOffset;
+	if (!state.hasDST && state.isDST) {
+		//DST without known end, it is handled as standard time
+		state.isDST = false;
+		state.stdOffset = state.utcOffset;
+		state.dstOffset = 0;
+	}
+}
+
+
+static int parseRuleName(const char* text, int textLength, int pos, char* name) {
+	int start = pos;
+	int len;
+	if (pos < textLength && text[pos] == '<') {
+		//Quoted name, for example: <+03>
+		start = ++pos;
+		for (; pos < textLength && text[pos] != '>'; pos++);
+		if (pos >= textLength) return -1;
+		len = pos - start;
+		pos++;
+	}
+	else {
+		for (; pos < textLength && ((text[pos] >= 'a' && text[pos] <= 'z') || (text[pos] >= 'A' && text[pos] <= 'Z')); pos++);
+		len = pos - start;
+	}
+	if (len <= 0) return -1;
+	copyAbbr(name, text + start, len);
+	return pos;
+}
+
+static int parseRuleTime(const char* text, int textLength, int pos, int32_t& seconds) {
+	bool neg = false;
+	if (pos < textLength && (text[pos] == '+' || text[pos] == '-')) {
+		neg = text[pos] == '-';
+		pos++;
+	}
+	int32_t parts[3] = { 0, 0, 0 };
+	for (int p = 0; p < 3; p++) {
+		int digits = 0;
+		for (; pos < textLength && text[pos] >= '0' && text[pos] <= '9' && digits < 3; pos++, digits++) {
+			parts[p] = parts[p] * 10 + (text[pos] - '0');
+		}
+		if (digits == 0) return -1;
+		if (p < 2 && pos < textLength && text[pos] == ':') {
+			pos++;
+		}
+		else {
+			break;
+		}
+	}
+	if (parts[0] > 167 || parts[1] > 59 || parts[2] > 59) return -1;
+	seconds = parts[0] * 3600 + parts[1] * 60 + parts[2];
+	if (neg) seconds = -seconds;
+	return pos;
+}
+
+static int parseRuleNumber(const char* text, int textLength, int pos, uint16_t& value) {
+	int digits = 0;
+	value = 0;
+	for (; pos < textLength && text[pos] >= '0' && text[pos] <= '9' && digits < 4; pos++, digits++) {
+		value = value * 10 + (text[pos] - '0');
+	}
+	return (digits == 0) ? -1 : pos;
+}
+
+static int parseRuleTransition(const char* text, int textLength, int pos, WorldTimeAPITZif::PosixRule::Transition& tr) {
+	uint16_t v;
+	if (pos < textLength && text[pos] == 'M') {
+		tr.type = 'M';
+		uint16_t m, w, d;
+		if ((pos = parseRuleNumber(text, textLength, pos + 1, m)) < 0 || pos >= textLength || text[pos] != '.') return -1;
+		if ((pos = parseRuleNumber(text, textLength, pos + 1, w)) < 0 || pos >= textLength || text[pos] != '.') return -1;
+		if ((pos = parseRuleNumber(text, textLength, pos + 1, d)) < 0) return -1;
+		if (m < 1 || m > 12 || w < 1 || w > 5 || d > 6) return -1;
+		tr.month = (uint8_t)m;
+		tr.week = (uint8_t)w;
+		tr.day = (uint8_t)d;
+	}
+	else if (pos < textLength && text[pos] == 'J') {
+		tr.type = 'J';
+		if ((pos = parseRuleNumber(text, textLength, pos + 1, v)) < 0 || v < 1 || v > 365) return -1;
+		tr.yday = v;
+	}
+	else {
+		tr.type = 'N';
+		if ((pos = parseRuleNumber(text, textLength, pos, v)) < 0 || v > 365) return -1;
+		tr.yday = v;
+	}
+	tr.time = 7200; //Default time is 02:00:00
+	if (pos < textLength && text[pos] == '/') {
+		if ((pos = parseRuleTime(text, textLength, pos + 1, tr.time)) < 0) return -1;
+	}
+	return pos;
+}
+
+bool WorldTimeAPITZif::PosixRule::parse(const char* text, int textLength) {
+	int pos = parseRuleName(text, textLength, 0, stdName);
+	int32_t offset;
+	if (pos < 0 || (pos = parseRuleTime(text, textLength, pos, offset)) < 0) return false;
+	stdOffset = -offset; //POSIX offsets are positive west of Greenwich
+	hasDST = false;
+	dstName[0] = 0;
+	if (pos == textLength) {
+		dstOffset = stdOffset;
+		return true; //No DST
+	}
+
+	if ((pos = parseRuleName(text, textLength, pos, dstName)) < 0) return false;
+	dstOffset = stdOffset + 3600;
+	if (pos < textLength && text[pos] != ',') {
+		if ((pos = parseRuleTime(text, textLength, pos, offset)) < 0) return false;
+		dstOffset = -offset;
+	}
+	if (pos >= textLength || text[pos] != ',') return false; //Rules are always present in TZif footers
+	if ((pos = parseRuleTransition(text, textLength, pos + 1, start)) < 0) return false;
+	if (pos >= textLength || text[pos] != ',') return false;
+	if ((pos = parseRuleTransition(text, textLength, pos + 1, end)) < 0) return false;
+	hasDST = pos == textLength;
+	return hasDST;
+}
+
+int64_t WorldTimeAPITZif::PosixRule::transitionTime(const Transition& tr, int32_t year, int32_t offset) const {
+	int32_t days;
+	if (tr.type == 'M') {
+		days = WorldTimeAPICalendar::weekdayOfMonth(year, tr.month, tr.week, tr.day);
+	}
+	else if (tr.type == 'J') {
+		//Leap day is not counted
+		days = WorldTimeAPICalendar::daysFromCivil(year, 1, 1) + tr.yday - 1;
+		if (tr.yday >= 60 && WorldTimeAPICalendar::isLeap(year)) days++;
+	}
+	else {
+		days = WorldTimeAPICalendar::daysFromCivil(year, 1, 1) + tr.yday;
+	}
+	return (int64_t)days * 86400 + tr.time - offset;
+}
+
+void WorldTimeAPITZif::PosixRule::getState(int64_t unixTime, ZoneState& state) const {
+	state.stdOffset = stdOffset;
+	state.utcOffset = stdOffset;
+	state.dstOffset = 0;
+	state.isDST = false;
+	state.hasDST = hasDST;
+	state.dstFrom = 0;
+	state.dstUntil = 0;
+	memcpy(state.abbreviation, stdName, WTAPI_TZIF_ABR_SIZE);
+	if (!hasDST) {
+		return;
+	}
+	state.dstOffset = dstOffset - stdOffset;
+
+	int32_t days = WorldTimeAPICalendar::daysFromUnix(unixTime + stdOffset);
+	int32_t year;
+	uint8_t m, d;
+	WorldTimeAPICalendar::civilFromDays(days, year, m, d);
+
+	//First DST period, which ends after unixTime (on south hemisphere, DST period ends next year)
+	for (int32_t y = year - 1; y <= year + 1; y++) {
+		int64_t from = transitionTime(start, y, stdOffset);
+		int64_t until = transitionTime(end, y, dstOffset);
+		if (until <= from) {
+			until = transitionTime(end, y + 1, dstOffset);
+		}
+		if (until > unixTime) {
+			state.dstFrom = from;
+			state.dstUntil = until;
+			if (from <= unixTime) {
+				state.isDST = true;
+				state.utcOffset = dstOffset;
+				memcpy(state.abbreviation, dstName, WTAPI_TZIF_ABR_SIZE);
+			}
+			return;
+		}
+	}
+}
+
+#endif // WTAPI_TZIF
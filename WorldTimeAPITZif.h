@@ -0,0 +1,199 @@
+/**
+ * @file WorldTimeAPITZif.h
+ * @brief This file contains resolver of time zones from local tzdata (TZif files).
+ *
+ * @see WorldTimeAPITZif
+ */
+
+#ifndef WORLD_TIME_API_TZIF_H_
+#define WORLD_TIME_API_TZIF_H_
+
+#include "SimpleJSONParser.h"
+#include "WorldTimeAPICalendar.h"
+
+#if defined(SJSONP_UNDER_OS) && !(defined(_WIN64) || defined(_WIN32))
+//Local tzdata is available only on unix-like systems
+#define WTAPI_TZIF (1)
+#endif // SJSONP_UNDER_OS && !_WIN32
+
+#ifdef WTAPI_TZIF
+#include <string>
+#include <map>
+#include <mutex>
+
+#define WTAPI_TZIF_ABR_SIZE       (8)
+
+/**
+* @class WorldTimeAPITZif
+* @brief Resolves time zone informations from TZif files of local tzdata (usually /usr/share/zoneinfo).
+* Files are memory-mapped once and kept mapped. Transitions are found by binary search. For times after
+* last transition in file, POSIX TZ rule from footer of file is used.
+* @see <a href="https://datatracker.ietf.org/doc/html/rfc8536">RFC 8536</a>
+*/
+class WorldTimeAPITZif {
+public:
+
+	/**
+	* @struct ZoneState
+	* @brief Time zone informations at given time.
+	*/
+	struct ZoneState {
+		/**
+		* @brief Total offset from UTC in seconds (including DST).
+		*/
+		int32_t utcOffset;
+
+		/**
+		* @brief Standard offset from UTC in seconds.
+		*/
+		int32_t stdOffset;
+
+		/**
+		* @brief DST offset in seconds.
+		*/
+		int32_t dstOffset;
+
+		/**
+		* @brief True if DST is applied.
+		*/
+		bool isDST;
+
+		/**
+		* @brief True if dstFrom and dstUntil are valid. False for zones without DST.
+		*/
+		bool hasDST;
+
+		/**
+		* @brief Unix time of beginning of current or next DST period.
+		*/
+		int64_t dstFrom;
+
+		/**
+		* @brief Unix time of end of current or next DST period.
+		*/
+		int64_t dstUntil;
+
+		/**
+		* @brief Abbreviation of time zone, for example: "CEST".
+		*/
+		char abbreviation[WTAPI_TZIF_ABR_SIZE];
+	};
+
+	/**
+	* @brief Gets resolver shared by all WorldTimeAPI clients.
+	*/
+	static WorldTimeAPITZif& global();
+
+	WorldTimeAPITZif();
+	~WorldTimeAPITZif();
+
+	/**
+	* @brief Sets directory with TZif files.
+	* @param dir Path to directory. Default is "/usr/share/zoneinfo".
+	*/
+	void setDirectory(const char* dir);
+
+	/**
+	* @brief Gets time zone informations at given time.
+	* @param[in] tz Olson time zone name, for example: "Europe/Bratislava".
+	* @param[in] unixTime Unix time in seconds.
+	* @param[out] state Time zone informations.
+	* @return Returns true if time zone was found.
+	*/
+	bool lookup(const char* tz, int64_t unixTime, ZoneState& state);
+
+	/**
+	* @struct PosixRule
+	* @brief Parsed POSIX TZ rule, for example: "CET-1CEST,M3.5.0,M10.5.0/3".
+	*/
+	struct PosixRule {
+		/**
+		* @struct Transition
+		* @brief Date of transition. Type 'M' - Mm.w.d (day d of week w of month m),
+		* 'J' - Jn (day n without leap day), 'N' - n (zero based day of year).
+		*/
+		struct Transition {
+			char type;
+			uint8_t month;
+			uint8_t week;
+			uint8_t day;
+			uint16_t yday;
+			int32_t time; //Local time of transition in seconds
+		};
+
+		int32_t stdOffset;
+		int32_t dstOffset; //Total offset during DST
+		bool hasDST;
+		char stdName[WTAPI_TZIF_ABR_SIZE];
+		char dstName[WTAPI_TZIF_ABR_SIZE];
+		Transition start;
+		Transition end;
+
+		/**
+		* @brief Parses POSIX TZ rule.
+		* @return Returns true if rule was parsed.
+		*/
+		bool parse(const char* text, int textLength);
+
+		/**
+		* @brief Gets unix time of transition in given year.
+		*/
+		int64_t transitionTime(const Transition& tr, int32_t year, int32_t offset) const;
+
+		/**
+		* @brief Gets time zone state at given time.
+		*/
+		void getState(int64_t unixTime, ZoneState& state) const;
+	};
+
+protected:
+
+	/**
+	* @struct Zone
+	* @brief Memory mapped TZif file.
+	*/
+	struct Zone {
+		const uint8_t* map = NULL;
+		size_t mapSize = 0;
+
+		const uint8_t* times = NULL; //Transition times
+		uint8_t timeSize = 8;        //4 for version 1 files
+		uint32_t timeCount = 0;
+		const uint8_t* timeTypes = NULL;
+		const uint8_t* types = NULL; //Local time types, 6 bytes each
+		uint32_t typeCount = 0;
+		const char* abbrs = NULL;
+		uint32_t abbrCount = 0;
+
+		bool hasFooter = false;
+		PosixRule footer;
+
+		int64_t time(uint32_t i) const;
+		int32_t typeOffset(uint8_t type) const;
+		bool typeIsDST(uint8_t type) const;
+		const char* typeAbbr(uint8_t type) const;
+	};
+
+	/**
+	* @brief Opens and maps TZif file of time zone.
+	*/
+	const Zone* getZone(const char* tz);
+
+	/**
+	* @brief Parses mapped TZif file.
+	*/
+	static bool parseZone(Zone& zone);
+
+	/**
+	* @brief Gets time zone state from transition table.
+	*/
+	static void getState(const Zone& zone, int64_t unixTime, ZoneState& state);
+
+	std::string directory;
+	std::mutex mutex;
+	std::map<std::string, Zone*> zones;
+};
+
+#endif // WTAPI_TZIF
+
+#endif // !WORLD_TIME_API_TZIF_H_
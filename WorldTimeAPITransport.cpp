@@ -0,0 +1,401 @@
+#include "WorldTimeAPITransport.h"
+
+#if defined(SJSONP_UNDER_OS)
+#include <stdio.h>
+#if defined(_WIN64) || defined(_WIN32)
+#define popen _popen
+#define pclose _pclose
+#endif // _WIN32
+
+//Curl options, resolved address and URL have to fit to command
+#define WTAPI_CURL_COMMAND_SIZE   (WTAPI_URL_SIZE + WTAPI_DNS_HOST_SIZE + 192)
+#elif defined(ARDUINO)
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#include <HTTPClient.h>
+#endif
+#endif // SJSONP_UNDER_OS
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+WorldTimeAPI_HttpCode WorldTimeAPITransport::stream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+#if defined(SJSONP_UNDER_OS)
+	std::string body;
+#else
+	String body;
+#endif // SJSONP_UNDER_OS
+	WorldTimeAPI_HttpCode httpCode = get(url, body, retryAfter, timeout, dns);
+	if (httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK && body.length() > 0) {
+		onChunk(body.c_str(), body.length(), owner);
+	}
+	return httpCode;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPITransport::fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	response.clear();
+	uint32_t retryAfter = 0;
+	WorldTimeAPI_HttpCode httpCode = get(url, response.getBuffer(), &retryAfter, timeout, dns);
+	response.setBodyOnly(httpCode, retryAfter);
+	return httpCode;
+}
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#if defined(SJSONP_UNDER_OS)
+WorldTimeAPICurlTransport& WorldTimeAPICurlTransport::global() {
+	static WorldTimeAPICurlTransport transport;
+	return transport;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPICurlTransport::get(const char* url, std::string& resp, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	WorldTimeAPIResponse response;
+	WorldTimeAPI_HttpCode httpCode = fetch(url, response, timeout, dns);
+	WorldTimeAPIStringView body = response.getBody();
+	resp.assign(body.data, body.length);
+	if (retryAfter != NULL) {
+		*retryAfter = response.getRetryAfter();
+	}
+	return httpCode;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPICurlTransport::fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	response.clear();
+	if (!isSafeURL(url)) {
+		response.setError(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR); //URL would break out of quotes
+		return response.getHttpCode();
+	}
+	char host[WTAPI_DNS_HOST_SIZE];
+	uint16_t port = 0;
+	char address[64];
+	uint8_t addressCount = 0;
+	if (dns != NULL && WorldTimeAPIDNSCache::parseURL(url, host, sizeof(host), port)) {
+		addressCount = dns->resolve(host, 0, address, sizeof(address)); //When resolving fails, curl will try it
+	}
+
+	uint32_t start = WorldTimeAPIClock::now();
+	uint8_t addrIndex = 0;
+	while (true) {
+		uint32_t elapsed = WorldTimeAPIClock::elapsed(start);
+		if (elapsed >= timeout) {
+			response.setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT);
+			return response.getHttpCode();
+		}
+		uint32_t left = timeout - elapsed;
+
+		//Timeout of curl is in seconds with fractional part
+		char timeoutStr[16];
+		snprintf(timeoutStr, sizeof(timeoutStr), "%u.%03u", (unsigned)(left / 1000), (unsigned)(left % 1000));
+
+		//Command is built in fixed buffer, error output is redirected to output of curl
+		char cmd[WTAPI_CURL_COMMAND_SIZE];
+		int len;
+		if (addrIndex < addressCount) {
+			//Using cached address instead of resolving
+			len = snprintf(cmd, sizeof(cmd), "curl -isS --connect-timeout %s --max-time %s --resolve \"%s:%u:%s\" \"%s\" 2>&1",
+				timeoutStr, timeoutStr, host, (unsigned)port, address, url);
+		}
+		else {
+			len = snprintf(cmd, sizeof(cmd), "curl -isS --connect-timeout %s --max-time %s \"%s\" 2>&1", timeoutStr, timeoutStr, url);
+		}
+		if (len < 0 || len >= (int)sizeof(cmd)) {
+			response.setError(WorldTimeAPI_HttpCode::WTA_ERROR_ARGUMENT_ERROR); //URL is too long
+			return response.getHttpCode();
+		}
+
+		response.clear();
+		ssystem(cmd, response);
+
+		WorldTimeAPIStringView resp = response.getRaw();
+		if (resp.length > 5 && strncmp("curl:", resp.data, 5) == 0) {
+			//CURL error
+			int curlCode = 0;
+			if (strncmp("curl: (", resp.data, 7) == 0) {
+				for (size_t i = 7; i < resp.length && resp.data[i] >= '0' && resp.data[i] <= '9'; i++) {
+					curlCode = curlCode * 10 + (resp.data[i] - '0');
+				}
+			}
+
+			if (curlCode == 7 && addrIndex < addressCount) {
+				//Connection to this address failed, it is moved to the end, so next one is first now
+				dns->markFailed(host, address);
+				addrIndex++;
+				if (addrIndex < addressCount && dns->resolve(host, 0, address, sizeof(address)) > 0) {
+					continue;
+				}
+			}
+
+			response.setError(curlCode == 28 ? WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT : WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+			return response.getHttpCode();
+		}
+		break;
+	}
+
+	//Status, headers and body are indexed in place
+	return response.parse();
+}
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+WorldTimeAPIHTTPClientTransport& WorldTimeAPIHTTPClientTransport::global() {
+	static WorldTimeAPIHTTPClientTransport transport;
+	return transport;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIHTTPClientTransport::get(const char* url, String& resp, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	WorldTimeAPIResponse response;
+	WorldTimeAPI_HttpCode httpCode = fetch(url, response, timeout, dns);
+	WorldTimeAPIStringView body = response.getBody();
+	resp = "";
+	resp.concat(body.data, body.length);
+	if (retryAfter != NULL) {
+		*retryAfter = response.getRetryAfter();
+	}
+	return httpCode;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIHTTPClientTransport::fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	response.clear();
+	WiFiClient client;
+	HTTPClient http;
+	http.setTimeout(timeout > 0xFFFF ? 0xFFFF : timeout); //ESP8266 accepts only 16 bit timeout
+#ifdef ESP32
+	http.setConnectTimeout(timeout);
+#endif // ESP32
+
+	char host[WTAPI_DNS_HOST_SIZE];
+	uint16_t port = 0;
+	IPAddress address;
+	if (dns != NULL && WorldTimeAPIDNSCache::parseURL(url, host, sizeof(host), port) && dns->resolve(host, address)) {
+		//Connecting to cached address, HTTPClient reuses connected client, so it does not resolve host again
+		client.setTimeout(timeout);
+		if (!client.connect(address, port)) {
+			dns->markFailed(host);
+			response.setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+			return response.getHttpCode();
+		}
+		http.setReuse(true);
+	}
+
+	if (!http.begin(client, url)) {
+		response.setError(WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED);
+		return response.getHttpCode();
+	}
+	const char* headerKeys[] = { "Retry-After" };
+	http.collectHeaders(headerKeys, 1);
+	int httpCode = http.GET();
+
+	// httpCode will be negative on error
+	if (httpCode <= 0) {
+		response.setError((WorldTimeAPI_HttpCode)httpCode);
+		return response.getHttpCode();
+	}
+	String value = http.header(headerKeys[0]);
+	uint32_t retryAfter = WorldTimeAPI::parseRetryAfter(value.c_str(), (int)value.length());
+	WorldTimeAPIResponseWriter writer(response);
+	int written = http.writeToStream(&writer);
+	http.end();
+	if (written < 0) {
+		response.setError((WorldTimeAPI_HttpCode)written);
+		return response.getHttpCode();
+	}
+	response.setBodyOnly((WorldTimeAPI_HttpCode)httpCode, retryAfter);
+	return response.getHttpCode();
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIHTTPClientTransport::stream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) {
+	uint32_t start = WorldTimeAPIClock::now();
+	WiFiClient client;
+	HTTPClient http;
+	http.setTimeout(timeout > 0xFFFF ? 0xFFFF : timeout); //ESP8266 accepts only 16 bit timeout
+#ifdef ESP32
+	http.setConnectTimeout(timeout);
+#endif // ESP32
+	http.useHTTP10(true); //Body is not chunked, so it can be read from stream directly
+
+	char host[WTAPI_DNS_HOST_SIZE];
+	uint16_t port = 0;
+	IPAddress address;
+	if (dns != NULL && WorldTimeAPIDNSCache::parseURL(url, host, sizeof(host), port) && dns->resolve(host, address)) {
+		client.setTimeout(timeout);
+		if (!client.connect(address, port)) {
+			dns->markFailed(host);
+			return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+		}
+		http.setReuse(true);
+	}
+
+	if (!http.begin(client, url)) {
+		return WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_CONNECTION_FAILED;
+	}
+	const char* headerKeys[] = { "Retry-After" };
+	http.collectHeaders(headerKeys, 1);
+	int httpCode = http.GET();
+	if (httpCode > 0 && retryAfter != NULL) {
+		String value = http.header(headerKeys[0]);
+		*retryAfter = WorldTimeAPI::parseRetryAfter(value.c_str(), (int)value.length());
+	}
+	if (httpCode != WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK) {
+		http.end();
+		return (WorldTimeAPI_HttpCode)httpCode;
+	}
+
+	//Body is read in small parts, so memory usage does not depend on size of response
+	char buffer[WTAPI_LIST_LINE_SIZE];
+	int left = http.getSize(); //-1 if size is unknown
+	WiFiClient* stream = http.getStreamPtr();
+	while (left != 0 && (http.connected() || stream->available() > 0)) {
+		if (WorldTimeAPIClock::elapsed(start) >= timeout) {
+			httpCode = WorldTimeAPI_HttpCode::WTA_HTTP_ERROR_READ_TIMEOUT;
+			break;
+		}
+		int avail = stream->available();
+		if (avail <= 0) {
+			delay(1);
+			continue;
+		}
+		int len = stream->readBytes(buffer, avail < (int)sizeof(buffer) ? avail : (int)sizeof(buffer));
+		if (len <= 0) continue;
+		if (left > 0) left -= len;
+		if (!onChunk(buffer, (size_t)len, owner)) {
+			break; //Stopped by callback
+		}
+	}
+	http.end();
+	return (WorldTimeAPI_HttpCode)httpCode;
+}
+#endif // !SJSONP_UNDER_OS
+
+
+#if defined(SJSONP_UNDER_OS)
+/**
+* @brief Calls command (CMD) and retrieves it's result.
+* @param[in] command Command to call.
+* @param[out] output Response, to which output of command is appended.
+*/
+void WorldTimeAPICurlTransport::ssystem(const char* command, WorldTimeAPIResponse& output) {
+	//Output is read from pipe, so no temporary file is needed
+	FILE* pipe = popen(command, "r");
+	if (pipe == NULL) return;
+	char chunk[1024];
+	size_t len;
+	while ((len = fread(chunk, 1, sizeof(chunk), pipe)) > 0) {
+		if (!output.append(chunk, len)) break;
+	}
+	pclose(pipe);
+}
+
+bool WorldTimeAPICurlTransport::isSafeURL(const char* url) {
+	if (url == NULL || *url == '\0') return false;
+	for (const char* c = url; *c != '\0'; c++) {
+		if ((*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9')) continue;
+		//Unreserved, reserved (without '$') and percent sign of RFC 3986
+		if (strchr("-._~:/?#[]@!&'()*+,;=%", *c) == NULL) return false;
+	}
+	return true;
+}
+#endif // !SJSONP_UNDER_OS
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+WorldTimeAPIMemoryTransport::WorldTimeAPIMemoryTransport() :
+	count(0),
+	hasDefault(false),
+	requestCount(0)
+{
+}
+
+bool WorldTimeAPIMemoryTransport::add(const char* url, WorldTimeAPI_HttpCode httpCode, const char* body, uint32_t retryAfter) {
+	Response response;
+	response.url = url;
+	response.body = body != NULL ? body : "";
+	response.httpCode = httpCode;
+	response.retryAfter = retryAfter;
+	if (url == NULL) {
+		defaultResponse = response;
+		hasDefault = true;
+		return true;
+	}
+	for (uint8_t i = 0; i < count; i++) {
+		if (strcmp(responses[i].url, url) == 0) {
+			responses[i] = response; //Replacing response
+			return true;
+		}
+	}
+	if (count >= WTAPI_MEMORY_TRANSPORT_ENTRIES) {
+		return false;
+	}
+	responses[count++] = response;
+	return true;
+}
+
+void WorldTimeAPIMemoryTransport::clear() {
+	count = 0;
+	hasDefault = false;
+	requestCount = 0;
+}
+
+const WorldTimeAPIMemoryTransport::Response* WorldTimeAPIMemoryTransport::find(const char* url) const {
+	for (uint8_t i = 0; i < count; i++) {
+		if (strcmp(responses[i].url, url) == 0) {
+			return &responses[i];
+		}
+	}
+	return hasDefault ? &defaultResponse : NULL;
+}
+
+#if defined(SJSONP_UNDER_OS)
+WorldTimeAPI_HttpCode WorldTimeAPIMemoryTransport::get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t, WorldTimeAPIDNSCache*) {
+#else
+WorldTimeAPI_HttpCode WorldTimeAPIMemoryTransport::get(const char* url, String& body, uint32_t* retryAfter, uint32_t, WorldTimeAPIDNSCache*) {
+#endif // SJSONP_UNDER_OS
+	requestCount++;
+	if (retryAfter != NULL) {
+		*retryAfter = 0;
+	}
+	const Response* response = find(url);
+	if (response == NULL) {
+		body = "";
+		return WorldTimeAPI_HttpCode::WTA_HTTP_CODE_NOT_FOUND;
+	}
+	if (response->httpCode <= WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+		body = "";
+		return response->httpCode; //Simulated connection error
+	}
+	body = response->body;
+	if (retryAfter != NULL) {
+		*retryAfter = response->retryAfter;
+	}
+	return response->httpCode;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIMemoryTransport::stream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t* retryAfter, uint32_t, WorldTimeAPIDNSCache*) {
+	requestCount++;
+	if (retryAfter != NULL) {
+		*retryAfter = 0;
+	}
+	const Response* response = find(url);
+	if (response == NULL) {
+		return WorldTimeAPI_HttpCode::WTA_HTTP_CODE_NOT_FOUND;
+	}
+	if (retryAfter != NULL && response->httpCode > WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+		*retryAfter = response->retryAfter;
+	}
+	if (response->httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK && response->body[0] != 0) {
+		onChunk(response->body, strlen(response->body), owner);
+	}
+	return response->httpCode;
+}
+
+WorldTimeAPI_HttpCode WorldTimeAPIMemoryTransport::fetch(const char* url, WorldTimeAPIResponse& resp, uint32_t, WorldTimeAPIDNSCache*) {
+	requestCount++;
+	const Response* response = find(url);
+	if (response == NULL) {
+		resp.setError(WorldTimeAPI_HttpCode::WTA_HTTP_CODE_NOT_FOUND);
+	}
+	else if (response->httpCode <= WorldTimeAPI_HttpCode::WTA_HTTP_NO_CODE) {
+		resp.setError(response->httpCode); //Simulated connection error
+	}
+	else {
+		resp.setExternalBody(response->httpCode, response->retryAfter, response->body, strlen(response->body));
+	}
+	return resp.getHttpCode();
+}
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
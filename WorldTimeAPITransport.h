@@ -0,0 +1,273 @@
+/**
+ * @file WorldTimeAPITransport.h
+ * @brief This file contains transports, which send HTTP requests of WorldTimeAPI client.
+ *
+ * @see WorldTimeAPITransport
+ */
+
+#ifndef WORLD_TIME_API_TRANSPORT_H_
+#define WORLD_TIME_API_TRANSPORT_H_
+
+#include "WorldTimeAPI.h"
+#include "WorldTimeAPIResponse.h"
+
+#define WTAPI_MEMORY_TRANSPORT_ENTRIES  (16)
+
+/**
+* @class WorldTimeAPITransport
+* @brief Interface of HTTP transport used by WorldTimeAPI client. Transport sends GET request and
+* returns status and body of response. Transport can be used by multiple threads at once.
+* @see WorldTimeAPI::WorldTimeAPI(WorldTimeAPITransport*)
+*/
+class WorldTimeAPITransport {
+public:
+	virtual ~WorldTimeAPITransport() {}
+
+#if defined(SJSONP_UNDER_OS)
+	/**
+	* @brief Sends GET request.
+	* @param[in] url URL of request.
+	* @param[out] body Body of response.
+	* @param[out] retryAfter Value of Retry-After header in seconds or 0 if it was not found. Can be NULL.
+	* @param[in] timeout Timeout of request in milliseconds.
+	* @param[in] dns Cache of resolved addresses or NULL if host should be resolved by transport.
+	* @return Returns HTTP code of response or negative error code.
+	*/
+	virtual WorldTimeAPI_HttpCode get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) = 0;
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+	/**
+	* @brief Sends GET request.
+	* @param[in] url URL of request.
+	* @param[out] body Body of response.
+	* @param[out] retryAfter Value of Retry-After header in seconds or 0 if it was not found. Can be NULL.
+	* @param[in] timeout Timeout of request in milliseconds.
+	* @param[in] dns Cache of resolved addresses or NULL if host should be resolved by transport.
+	* @return Returns HTTP code of response or negative error code.
+	*/
+	virtual WorldTimeAPI_HttpCode get(const char* url, String& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) = 0;
+#endif // SJSONP_UNDER_OS
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+	/**
+	* @brief Sends GET request and passes body of successful response (HTTP code 200) to callback while
+	* it is received. Bodies of other responses are discarded. Default implementation receives whole body
+	* by get() and passes it in one part.
+	* @param[in] url URL of request.
+	* @param[in] onChunk Callback, which receives parts of body. When it returns false, receiving is stopped.
+	* @param[in] owner Pointer passed to callback.
+	* @param[out] retryAfter Value of Retry-After header in seconds or 0 if it was not found. Can be NULL.
+	* @param[in] timeout Timeout of request in milliseconds.
+	* @param[in] dns Cache of resolved addresses or NULL if host should be resolved by transport.
+	* @return Returns HTTP code of response or negative error code.
+	*/
+	virtual WorldTimeAPI_HttpCode stream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns);
+
+	/**
+	* @brief Sends GET request and stores response to reusable receive buffer, so body can be parsed
+	* without copying. Default implementation receives body by get() directly to buffer of response,
+	* transports, which receive raw response, store whole response and index its headers.
+	* @param[in] url URL of request.
+	* @param[out] response Response, its buffer is reused.
+	* @param[in] timeout Timeout of request in milliseconds.
+	* @param[in] dns Cache of resolved addresses or NULL if host should be resolved by transport.
+	* @return Returns HTTP code of response or negative error code.
+	*/
+	virtual WorldTimeAPI_HttpCode fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns);
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+	/**
+	* @brief Marks transport as trusted. JSON received by trusted transport (for example from own proxy
+	* or replayed responses) is parsed by SimpleJSONTrusted policy, which skips validation. Transport is not trusted by default.
+	*/
+	inline void setTrusted(bool trusted_) {
+		trusted = trusted_;
+	}
+
+	/**
+	* @brief Returns true if responses of this transport are parsed without validation.
+	*/
+	inline bool isTrusted() const {
+		return trusted;
+	}
+
+protected:
+	bool trusted = false;
+};
+
+#if defined(SJSONP_UNDER_OS)
+/**
+* @class WorldTimeAPICurlTransport
+* @brief Transport, which runs curl command. Default transport on OS.
+*/
+class WorldTimeAPICurlTransport : public WorldTimeAPITransport {
+public:
+	/**
+	* @brief Gets transport shared by all WorldTimeAPI clients.
+	*/
+	static WorldTimeAPICurlTransport& global();
+
+	WorldTimeAPI_HttpCode get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+	/**
+	* @brief Stores output of curl (headers and body) to arena of response and indexes it, body is not copied.
+	* Command is run by shell, so URL with characters outside of RFC 3986 or with '$' is rejected
+	* with WTA_ERROR_ARGUMENT_ERROR.
+	*/
+	WorldTimeAPI_HttpCode fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+protected:
+	/**
+	* @brief Calls command (CMD) and retrieves it's result.
+	* @param[in] command Command to call. Error output is included only if command redirects it.
+	* @param[out] output Response, to which output of command is appended.
+	*/
+	static void ssystem(const char* command, WorldTimeAPIResponse& output);
+
+	/**
+	* @brief Checks, if URL can be quoted in command. Only characters allowed by RFC 3986 are accepted,
+	* except '$', which is expanded by shell also inside of quotes.
+	*/
+	static bool isSafeURL(const char* url);
+};
+#elif (defined(ESP8266) || defined(ESP32)) && defined(ARDUINO)
+/**
+* @class WorldTimeAPIResponseWriter
+* @brief Stream, which appends written data to arena of response. HTTPClient::writeToStream() decodes
+* body (also chunked body) to it, so body is not received to String.
+*/
+class WorldTimeAPIResponseWriter : public Stream {
+public:
+	WorldTimeAPIResponseWriter(WorldTimeAPIResponse& response_) : response(response_) {}
+
+	size_t write(uint8_t c) override {
+		return response.append((const char*)&c, 1) ? 1 : 0;
+	}
+
+	size_t write(const uint8_t* buffer, size_t size) override {
+		return response.append((const char*)buffer, size) ? size : 0;
+	}
+
+	int available() override {
+		return 0;
+	}
+
+	int read() override {
+		return -1;
+	}
+
+	int peek() override {
+		return -1;
+	}
+
+protected:
+	WorldTimeAPIResponse& response;
+};
+
+/**
+* @class WorldTimeAPIHTTPClientTransport
+* @brief Transport, which uses HTTPClient of arduino core. Default transport on ESP8266 and ESP32.
+*/
+class WorldTimeAPIHTTPClientTransport : public WorldTimeAPITransport {
+public:
+	/**
+	* @brief Gets transport shared by all WorldTimeAPI clients.
+	*/
+	static WorldTimeAPIHTTPClientTransport& global();
+
+	WorldTimeAPI_HttpCode get(const char* url, String& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+	/**
+	* @brief Stores body to arena of response while it is received, String is not used.
+	*/
+	WorldTimeAPI_HttpCode fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+	/**
+	* @brief Sends GET request and passes body to callback in small parts, which are read from stream of connection.
+	* HTTP/1.0 is requested, so body is not chunked.
+	*/
+	WorldTimeAPI_HttpCode stream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+};
+#endif // SJSONP_UNDER_OS
+
+#if defined(SJSONP_UNDER_OS) || ((defined(ESP8266) || defined(ESP32)) && defined(ARDUINO))
+/**
+* @class WorldTimeAPIMemoryTransport
+* @brief Transport, which serves canned responses from memory without network. It is intended for
+* tests and benchmarks of client and parser.
+*
+* @code
+* WorldTimeAPIMemoryTransport transport;
+* transport.add("http://worldtimeapi.org/api/timezone/Europe/Bratislava", WTA_HTTP_CODE_OK, "{\"abbreviation\":\"CEST\", ...}");
+* WorldTimeAPI api(&transport);
+* @endcode
+* @note URLs and bodies are not copied, they have to exist while transport is used. Responses have to be
+* added before transport is used, add() is not synchronized with get().
+*/
+class WorldTimeAPIMemoryTransport : public WorldTimeAPITransport {
+public:
+	WorldTimeAPIMemoryTransport();
+
+	/**
+	* @brief Adds response for URL.
+	* @param url URL of request or NULL to set response for all other URLs.
+	* @param httpCode HTTP code of response or negative error code (for example WTA_HTTP_ERROR_CONNECTION_FAILED).
+	* @param body Body of response.
+	* @param retryAfter Value of Retry-After header in seconds.
+	* @return Returns false if there is no space for another response.
+	*/
+	bool add(const char* url, WorldTimeAPI_HttpCode httpCode, const char* body, uint32_t retryAfter = 0);
+
+	/**
+	* @brief Removes all responses.
+	*/
+	void clear();
+
+	/**
+	* @brief Gets count of served requests.
+	*/
+	inline uint32_t getRequestCount() const {
+		return requestCount;
+	}
+
+#if defined(SJSONP_UNDER_OS)
+	WorldTimeAPI_HttpCode get(const char* url, std::string& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+#else
+	WorldTimeAPI_HttpCode get(const char* url, String& body, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+#endif // SJSONP_UNDER_OS
+
+	/**
+	* @brief Passes canned body to callback without copying it.
+	*/
+	WorldTimeAPI_HttpCode stream(const char* url, WorldTimeAPI_ChunkCallback onChunk, void* owner, uint32_t* retryAfter, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+	/**
+	* @brief Sets canned body as body of response without copying it.
+	*/
+	WorldTimeAPI_HttpCode fetch(const char* url, WorldTimeAPIResponse& response, uint32_t timeout, WorldTimeAPIDNSCache* dns) override;
+
+protected:
+	struct Response {
+		const char* url;
+		const char* body;
+		WorldTimeAPI_HttpCode httpCode;
+		uint32_t retryAfter;
+	};
+
+	/**
+	* @brief Finds response for URL or NULL if there is no response.
+	*/
+	const Response* find(const char* url) const;
+
+	Response responses[WTAPI_MEMORY_TRANSPORT_ENTRIES];
+	uint8_t count;
+	bool hasDefault;
+	Response defaultResponse;
+#ifdef WTAPI_THREAD_SAFE
+	std::atomic<uint32_t> requestCount;
+#else
+	uint32_t requestCount;
+#endif // WTAPI_THREAD_SAFE
+};
+#endif // SJSONP_UNDER_OS || ESP8266 || ESP32
+
+#endif // !WORLD_TIME_API_TRANSPORT_H_
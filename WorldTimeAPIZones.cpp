@@ -0,0 +1,29 @@
+#include "WorldTimeAPIZones.h"
+
+#ifdef WTAPI_TZ_TABLE
+#include <string.h>
+
+constexpr const char* const WorldTimeAPIZones::names[WTAPI_TZ_COUNT + 1];
+
+WorldTimeAPI_TzId WorldTimeAPIZones::find(const char* name) {
+	if (name == NULL) {
+		return WorldTimeAPI_TzId::Invalid;
+	}
+	uint16_t lo = 1;
+	uint16_t hi = WTAPI_TZ_COUNT;
+	while (lo <= hi) {
+		uint16_t mid = (lo + hi) / 2;
+		int cmp = strcmp(names[mid], name);
+		if (cmp == 0) {
+			return (WorldTimeAPI_TzId)mid;
+		}
+		if (cmp < 0) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid - 1;
+		}
+	}
+	return WorldTimeAPI_TzId::Invalid;
+}
+#endif // WTAPI_TZ_TABLE
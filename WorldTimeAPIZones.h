@@ -0,0 +1,1266 @@
+/**
+ * @file WorldTimeAPIZones.h
+ * @brief This file contains table of IANA time zone names (tzdata 2025b).
+ * Generated by extras/generate_zones.py, do not edit.
+ *
+ * @see WorldTimeAPIZones
+ */
+
+#ifndef WORLD_TIME_API_ZONES_H_
+#define WORLD_TIME_API_ZONES_H_
+
+#include "SimpleJSONParser.h"
+
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+//Table is kept in flash, on ESP8266 it would be copied to RAM
+#define WTAPI_TZ_TABLE (1)
+#endif // SJSONP_UNDER_OS || ESP32
+
+#ifdef WTAPI_TZ_TABLE
+
+#define WTAPI_TZ_TABLE_VERSION    "2025b"
+#define WTAPI_TZ_COUNT            (598)
+
+/**
+* @brief IDs of IANA time zones. In names, '/' is replaced by '_', '+' by 'p' and '-' by 'm' before digit
+* or by '_' otherwise, for example: Europe/Bratislava - WorldTimeAPI_TzId::Europe_Bratislava, Etc/GMT+1 - WorldTimeAPI_TzId::Etc_GMTp1.
+*/
+enum class WorldTimeAPI_TzId : uint16_t {
+	Invalid = 0,
+	Africa_Abidjan = 1,
+	Africa_Accra = 2,
+	Africa_Addis_Ababa = 3,
+	Africa_Algiers = 4,
+	Africa_Asmara = 5,
+	Africa_Asmera = 6,
+	Africa_Bamako = 7,
+	Africa_Bangui = 8,
+	Africa_Banjul = 9,
+	Africa_Bissau = 10,
+	Africa_Blantyre = 11,
+	Africa_Brazzaville = 12,
+	Africa_Bujumbura = 13,
+	Africa_Cairo = 14,
+	Africa_Casablanca = 15,
+	Africa_Ceuta = 16,
+	Africa_Conakry = 17,
+	Africa_Dakar = 18,
+	Africa_Dar_es_Salaam = 19,
+	Africa_Djibouti = 20,
+	Africa_Douala = 21,
+	Africa_El_Aaiun = 22,
+	Africa_Freetown = 23,
+	Africa_Gaborone = 24,
+	Africa_Harare = 25,
+	Africa_Johannesburg = 26,
+	Africa_Juba = 27,
+	Africa_Kampala = 28,
+	Africa_Khartoum = 29,
+	Africa_Kigali = 30,
+	Africa_Kinshasa = 31,
+	Africa_Lagos = 32,
+	Africa_Libreville = 33,
+	Africa_Lome = 34,
+	Africa_Luanda = 35,
+	Africa_Lubumbashi = 36,
+	Africa_Lusaka = 37,
+	Africa_Malabo = 38,
+	Africa_Maputo = 39,
+	Africa_Maseru = 40,
+	Africa_Mbabane = 41,
+	Africa_Mogadishu = 42,
+	Africa_Monrovia = 43,
+	Africa_Nairobi = 44,
+	Africa_Ndjamena = 45,
+	Africa_Niamey = 46,
+	Africa_Nouakchott = 47,
+	Africa_Ouagadougou = 48,
+	Africa_Porto_Novo = 49,
+	Africa_Sao_Tome = 50,
+	Africa_Timbuktu = 51,
+	Africa_Tripoli = 52,
+	Africa_Tunis = 53,
+	Africa_Windhoek = 54,
+	America_Adak = 55,
+	America_Anchorage = 56,
+	America_Anguilla = 57,
+	America_Antigua = 58,
+	America_Araguaina = 59,
+	America_Argentina_Buenos_Aires = 60,
+	America_Argentina_Catamarca = 61,
+	America_Argentina_ComodRivadavia = 62,
+	America_Argentina_Cordoba = 63,
+	America_Argentina_Jujuy = 64,
+	America_Argentina_La_Rioja = 65,
+	America_Argentina_Mendoza = 66,
+	America_Argentina_Rio_Gallegos = 67,
+	America_Argentina_Salta = 68,
+	America_Argentina_San_Juan = 69,
+	America_Argentina_San_Luis = 70,
+	America_Argentina_Tucuman = 71,
+	America_Argentina_Ushuaia = 72,
+	America_Aruba = 73,
+	America_Asuncion = 74,
+	America_Atikokan = 75,
+	America_Atka = 76,
+	America_Bahia = 77,
+	America_Bahia_Banderas = 78,
+	America_Barbados = 79,
+	America_Belem = 80,
+	America_Belize = 81,
+	America_Blanc_Sablon = 82,
+	America_Boa_Vista = 83,
+	America_Bogota = 84,
+	America_Boise = 85,
+	America_Buenos_Aires = 86,
+	America_Cambridge_Bay = 87,
+	America_Campo_Grande = 88,
+	America_Cancun = 89,
+	America_Caracas = 90,
+	America_Catamarca = 91,
+	America_Cayenne = 92,
+	America_Cayman = 93,
+	America_Chicago = 94,
+	America_Chihuahua = 95,
+	America_Ciudad_Juarez = 96,
+	America_Coral_Harbour = 97,
+	America_Cordoba = 98,
+	America_Costa_Rica = 99,
+	America_Coyhaique = 100,
+	America_Creston = 101,
+	America_Cuiaba = 102,
+	America_Curacao = 103,
+	America_Danmarkshavn = 104,
+	America_Dawson = 105,
+	America_Dawson_Creek = 106,
+	America_Denver = 107,
+	America_Detroit = 108,
+	America_Dominica = 109,
+	America_Edmonton = 110,
+	America_Eirunepe = 111,
+	America_El_Salvador = 112,
+	America_Ensenada = 113,
+	America_Fort_Nelson = 114,
+	America_Fort_Wayne = 115,
+	America_Fortaleza = 116,
+	America_Glace_Bay = 117,
+	America_Godthab = 118,
+	America_Goose_Bay = 119,
+	America_Grand_Turk = 120,
+	America_Grenada = 121,
+	America_Guadeloupe = 122,
+	America_Guatemala = 123,
+	America_Guayaquil = 124,
+	America_Guyana = 125,
+	America_Halifax = 126,
+	America_Havana = 127,
+	America_Hermosillo = 128,
+	America_Indiana_Indianapolis = 129,
+	America_Indiana_Knox = 130,
+	America_Indiana_Marengo = 131,
+	America_Indiana_Petersburg = 132,
+	America_Indiana_Tell_City = 133,
+	America_Indiana_Vevay = 134,
+	America_Indiana_Vincennes = 135,
+	America_Indiana_Winamac = 136,
+	America_Indianapolis = 137,
+	America_Inuvik = 138,
+	America_Iqaluit = 139,
+	America_Jamaica = 140,
+	America_Jujuy = 141,
+	America_Juneau = 142,
+	America_Kentucky_Louisville = 143,
+	America_Kentucky_Monticello = 144,
+	America_Knox_IN = 145,
+	America_Kralendijk = 146,
+	America_La_Paz = 147,
+	America_Lima = 148,
+	America_Los_Angeles = 149,
+	America_Louisville = 150,
+	America_Lower_Princes = 151,
+	America_Maceio = 152,
+	America_Managua = 153,
+	America_Manaus = 154,
+	America_Marigot = 155,
+	America_Martinique = 156,
+	America_Matamoros = 157,
+	America_Mazatlan = 158,
+	America_Mendoza = 159,
+	America_Menominee = 160,
+	America_Merida = 161,
+	America_Metlakatla = 162,
+	America_Mexico_City = 163,
+	America_Miquelon = 164,
+	America_Moncton = 165,
+	America_Monterrey = 166,
+	America_Montevideo = 167,
+	America_Montreal = 168,
+	America_Montserrat = 169,
+	America_Nassau = 170,
+	America_New_York = 171,
+	America_Nipigon = 172,
+	America_Nome = 173,
+	America_Noronha = 174,
+	America_North_Dakota_Beulah = 175,
+	America_North_Dakota_Center = 176,
+	America_North_Dakota_New_Salem = 177,
+	America_Nuuk = 178,
+	America_Ojinaga = 179,
+	America_Panama = 180,
+	America_Pangnirtung = 181,
+	America_Paramaribo = 182,
+	America_Phoenix = 183,
+	America_Port_au_Prince = 184,
+	America_Port_of_Spain = 185,
+	America_Porto_Acre = 186,
+	America_Porto_Velho = 187,
+	America_Puerto_Rico = 188,
+	America_Punta_Arenas = 189,
+	America_Rainy_River = 190,
+	America_Rankin_Inlet = 191,
+	America_Recife = 192,
+	America_Regina = 193,
+	America_Resolute = 194,
+	America_Rio_Branco = 195,
+	America_Rosario = 196,
+	America_Santa_Isabel = 197,
+	America_Santarem = 198,
+	America_Santiago = 199,
+	America_Santo_Domingo = 200,
+	America_Sao_Paulo = 201,
+	America_Scoresbysund = 202,
+	America_Shiprock = 203,
+	America_Sitka = 204,
+	America_St_Barthelemy = 205,
+	America_St_Johns = 206,
+	America_St_Kitts = 207,
+	America_St_Lucia = 208,
+	America_St_Thomas = 209,
+	America_St_Vincent = 210,
+	America_Swift_Current = 211,
+	America_Tegucigalpa = 212,
+	America_Thule = 213,
+	America_Thunder_Bay = 214,
+	America_Tijuana = 215,
+	America_Toronto = 216,
+	America_Tortola = 217,
+	America_Vancouver = 218,
+	America_Virgin = 219,
+	America_Whitehorse = 220,
+	America_Winnipeg = 221,
+	America_Yakutat = 222,
+	America_Yellowknife = 223,
+	Antarctica_Casey = 224,
+	Antarctica_Davis = 225,
+	Antarctica_DumontDUrville = 226,
+	Antarctica_Macquarie = 227,
+	Antarctica_Mawson = 228,
+	Antarctica_McMurdo = 229,
+	Antarctica_Palmer = 230,
+	Antarctica_Rothera = 231,
+	Antarctica_South_Pole = 232,
+	Antarctica_Syowa = 233,
+	Antarctica_Troll = 234,
+	Antarctica_Vostok = 235,
+	Arctic_Longyearbyen = 236,
+	Asia_Aden = 237,
+	Asia_Almaty = 238,
+	Asia_Amman = 239,
+	Asia_Anadyr = 240,
+	Asia_Aqtau = 241,
+	Asia_Aqtobe = 242,
+	Asia_Ashgabat = 243,
+	Asia_Ashkhabad = 244,
+	Asia_Atyrau = 245,
+	Asia_Baghdad = 246,
+	Asia_Bahrain = 247,
+	Asia_Baku = 248,
+	Asia_Bangkok = 249,
+	Asia_Barnaul = 250,
+	Asia_Beirut = 251,
+	Asia_Bishkek = 252,
+	Asia_Brunei = 253,
+	Asia_Calcutta = 254,
+	Asia_Chita = 255,
+	Asia_Choibalsan = 256,
+	Asia_Chongqing = 257,
+	Asia_Chungking = 258,
+	Asia_Colombo = 259,
+	Asia_Dacca = 260,
+	Asia_Damascus = 261,
+	Asia_Dhaka = 262,
+	Asia_Dili = 263,
+	Asia_Dubai = 264,
+	Asia_Dushanbe = 265,
+	Asia_Famagusta = 266,
+	Asia_Gaza = 267,
+	Asia_Harbin = 268,
+	Asia_Hebron = 269,
+	Asia_Ho_Chi_Minh = 270,
+	Asia_Hong_Kong = 271,
+	Asia_Hovd = 272,
+	Asia_Irkutsk = 273,
+	Asia_Istanbul = 274,
+	Asia_Jakarta = 275,
+	Asia_Jayapura = 276,
+	Asia_Jerusalem = 277,
+	Asia_Kabul = 278,
+	Asia_Kamchatka = 279,
+	Asia_Karachi = 280,
+	Asia_Kashgar = 281,
+	Asia_Kathmandu = 282,
+	Asia_Katmandu = 283,
+	Asia_Khandyga = 284,
+	Asia_Kolkata = 285,
+	Asia_Krasnoyarsk = 286,
+	Asia_Kuala_Lumpur = 287,
+	Asia_Kuching = 288,
+	Asia_Kuwait = 289,
+	Asia_Macao = 290,
+	Asia_Macau = 291,
+	Asia_Magadan = 292,
+	Asia_Makassar = 293,
+	Asia_Manila = 294,
+	Asia_Muscat = 295,
+	Asia_Nicosia = 296,
+	Asia_Novokuznetsk = 297,
+	Asia_Novosibirsk = 298,
+	Asia_Omsk = 299,
+	Asia_Oral = 300,
+	Asia_Phnom_Penh = 301,
+	Asia_Pontianak = 302,
+	Asia_Pyongyang = 303,
+	Asia_Qatar = 304,
+	Asia_Qostanay = 305,
+	Asia_Qyzylorda = 306,
+	Asia_Rangoon = 307,
+	Asia_Riyadh = 308,
+	Asia_Saigon = 309,
+	Asia_Sakhalin = 310,
+	Asia_Samarkand = 311,
+	Asia_Seoul = 312,
+	Asia_Shanghai = 313,
+	Asia_Singapore = 314,
+	Asia_Srednekolymsk = 315,
+	Asia_Taipei = 316,
+	Asia_Tashkent = 317,
+	Asia_Tbilisi = 318,
+	Asia_Tehran = 319,
+	Asia_Tel_Aviv = 320,
+	Asia_Thimbu = 321,
+	Asia_Thimphu = 322,
+	Asia_Tokyo = 323,
+	Asia_Tomsk = 324,
+	Asia_Ujung_Pandang = 325,
+	Asia_Ulaanbaatar = 326,
+	Asia_Ulan_Bator = 327,
+	Asia_Urumqi = 328,
+	Asia_Ust_Nera = 329,
+	Asia_Vientiane = 330,
+	Asia_Vladivostok = 331,
+	Asia_Yakutsk = 332,
+	Asia_Yangon = 333,
+	Asia_Yekaterinburg = 334,
+	Asia_Yerevan = 335,
+	Atlantic_Azores = 336,
+	Atlantic_Bermuda = 337,
+	Atlantic_Canary = 338,
+	Atlantic_Cape_Verde = 339,
+	Atlantic_Faeroe = 340,
+	Atlantic_Faroe = 341,
+	Atlantic_Jan_Mayen = 342,
+	Atlantic_Madeira = 343,
+	Atlantic_Reykjavik = 344,
+	Atlantic_South_Georgia = 345,
+	Atlantic_St_Helena = 346,
+	Atlantic_Stanley = 347,
+	Australia_ACT = 348,
+	Australia_Adelaide = 349,
+	Australia_Brisbane = 350,
+	Australia_Broken_Hill = 351,
+	Australia_Canberra = 352,
+	Australia_Currie = 353,
+	Australia_Darwin = 354,
+	Australia_Eucla = 355,
+	Australia_Hobart = 356,
+	Australia_LHI = 357,
+	Australia_Lindeman = 358,
+	Australia_Lord_Howe = 359,
+	Australia_Melbourne = 360,
+	Australia_NSW = 361,
+	Australia_North = 362,
+	Australia_Perth = 363,
+	Australia_Queensland = 364,
+	Australia_South = 365,
+	Australia_Sydney = 366,
+	Australia_Tasmania = 367,
+	Australia_Victoria = 368,
+	Australia_West = 369,
+	Australia_Yancowinna = 370,
+	Brazil_Acre = 371,
+	Brazil_DeNoronha = 372,
+	Brazil_East = 373,
+	Brazil_West = 374,
+	CET = 375,
+	CST6CDT = 376,
+	Canada_Atlantic = 377,
+	Canada_Central = 378,
+	Canada_Eastern = 379,
+	Canada_Mountain = 380,
+	Canada_Newfoundland = 381,
+	Canada_Pacific = 382,
+	Canada_Saskatchewan = 383,
+	Canada_Yukon = 384,
+	Chile_Continental = 385,
+	Chile_EasterIsland = 386,
+	Cuba = 387,
+	EET = 388,
+	EST = 389,
+	EST5EDT = 390,
+	Egypt = 391,
+	Eire = 392,
+	Etc_GMT = 393,
+	Etc_GMTp0 = 394,
+	Etc_GMTp1 = 395,
+	Etc_GMTp10 = 396,
+	Etc_GMTp11 = 397,
+	Etc_GMTp12 = 398,
+	Etc_GMTp2 = 399,
+	Etc_GMTp3 = 400,
+	Etc_GMTp4 = 401,
+	Etc_GMTp5 = 402,
+	Etc_GMTp6 = 403,
+	Etc_GMTp7 = 404,
+	Etc_GMTp8 = 405,
+	Etc_GMTp9 = 406,
+	Etc_GMTm0 = 407,
+	Etc_GMTm1 = 408,
+	Etc_GMTm10 = 409,
+	Etc_GMTm11 = 410,
+	Etc_GMTm12 = 411,
+	Etc_GMTm13 = 412,
+	Etc_GMTm14 = 413,
+	Etc_GMTm2 = 414,
+	Etc_GMTm3 = 415,
+	Etc_GMTm4 = 416,
+	Etc_GMTm5 = 417,
+	Etc_GMTm6 = 418,
+	Etc_GMTm7 = 419,
+	Etc_GMTm8 = 420,
+	Etc_GMTm9 = 421,
+	Etc_GMT0 = 422,
+	Etc_Greenwich = 423,
+	Etc_UCT = 424,
+	Etc_UTC = 425,
+	Etc_Universal = 426,
+	Etc_Zulu = 427,
+	Europe_Amsterdam = 428,
+	Europe_Andorra = 429,
+	Europe_Astrakhan = 430,
+	Europe_Athens = 431,
+	Europe_Belfast = 432,
+	Europe_Belgrade = 433,
+	Europe_Berlin = 434,
+	Europe_Bratislava = 435,
+	Europe_Brussels = 436,
+	Europe_Bucharest = 437,
+	Europe_Budapest = 438,
+	Europe_Busingen = 439,
+	Europe_Chisinau = 440,
+	Europe_Copenhagen = 441,
+	Europe_Dublin = 442,
+	Europe_Gibraltar = 443,
+	Europe_Guernsey = 444,
+	Europe_Helsinki = 445,
+	Europe_Isle_of_Man = 446,
+	Europe_Istanbul = 447,
+	Europe_Jersey = 448,
+	Europe_Kaliningrad = 449,
+	Europe_Kiev = 450,
+	Europe_Kirov = 451,
+	Europe_Kyiv = 452,
+	Europe_Lisbon = 453,
+	Europe_Ljubljana = 454,
+	Europe_London = 455,
+	Europe_Luxembourg = 456,
+	Europe_Madrid = 457,
+	Europe_Malta = 458,
+	Europe_Mariehamn = 459,
+	Europe_Minsk = 460,
+	Europe_Monaco = 461,
+	Europe_Moscow = 462,
+	Europe_Nicosia = 463,
+	Europe_Oslo = 464,
+	Europe_Paris = 465,
+	Europe_Podgorica = 466,
+	Europe_Prague = 467,
+	Europe_Riga = 468,
+	Europe_Rome = 469,
+	Europe_Samara = 470,
+	Europe_San_Marino = 471,
+	Europe_Sarajevo = 472,
+	Europe_Saratov = 473,
+	Europe_Simferopol = 474,
+	Europe_Skopje = 475,
+	Europe_Sofia = 476,
+	Europe_Stockholm = 477,
+	Europe_Tallinn = 478,
+	Europe_Tirane = 479,
+	Europe_Tiraspol = 480,
+	Europe_Ulyanovsk = 481,
+	Europe_Uzhgorod = 482,
+	Europe_Vaduz = 483,
+	Europe_Vatican = 484,
+	Europe_Vienna = 485,
+	Europe_Vilnius = 486,
+	Europe_Volgograd = 487,
+	Europe_Warsaw = 488,
+	Europe_Zagreb = 489,
+	Europe_Zaporozhye = 490,
+	Europe_Zurich = 491,
+	Factory = 492,
+	GB = 493,
+	GB_Eire = 494,
+	GMT = 495,
+	GMTp0 = 496,
+	GMTm0 = 497,
+	GMT0 = 498,
+	Greenwich = 499,
+	HST = 500,
+	Hongkong = 501,
+	Iceland = 502,
+	Indian_Antananarivo = 503,
+	Indian_Chagos = 504,
+	Indian_Christmas = 505,
+	Indian_Cocos = 506,
+	Indian_Comoro = 507,
+	Indian_Kerguelen = 508,
+	Indian_Mahe = 509,
+	Indian_Maldives = 510,
+	Indian_Mauritius = 511,
+	Indian_Mayotte = 512,
+	Indian_Reunion = 513,
+	Iran = 514,
+	Israel = 515,
+	Jamaica = 516,
+	Japan = 517,
+	Kwajalein = 518,
+	Libya = 519,
+	MET = 520,
+	MST = 521,
+	MST7MDT = 522,
+	Mexico_BajaNorte = 523,
+	Mexico_BajaSur = 524,
+	Mexico_General = 525,
+	NZ = 526,
+	NZ_CHAT = 527,
+	Navajo = 528,
+	PRC = 529,
+	PST8PDT = 530,
+	Pacific_Apia = 531,
+	Pacific_Auckland = 532,
+	Pacific_Bougainville = 533,
+	Pacific_Chatham = 534,
+	Pacific_Chuuk = 535,
+	Pacific_Easter = 536,
+	Pacific_Efate = 537,
+	Pacific_Enderbury = 538,
+	Pacific_Fakaofo = 539,
+	Pacific_Fiji = 540,
+	Pacific_Funafuti = 541,
+	Pacific_Galapagos = 542,
+	Pacific_Gambier = 543,
+	Pacific_Guadalcanal = 544,
+	Pacific_Guam = 545,
+	Pacific_Honolulu = 546,
+	Pacific_Johnston = 547,
+	Pacific_Kanton = 548,
+	Pacific_Kiritimati = 549,
+	Pacific_Kosrae = 550,
+	Pacific_Kwajalein = 551,
+	Pacific_Majuro = 552,
+	Pacific_Marquesas = 553,
+	Pacific_Midway = 554,
+	Pacific_Nauru = 555,
+	Pacific_Niue = 556,
+	Pacific_Norfolk = 557,
+	Pacific_Noumea = 558,
+	Pacific_Pago_Pago = 559,
+	Pacific_Palau = 560,
+	Pacific_Pitcairn = 561,
+	Pacific_Pohnpei = 562,
+	Pacific_Ponape = 563,
+	Pacific_Port_Moresby = 564,
+	Pacific_Rarotonga = 565,
+	Pacific_Saipan = 566,
+	Pacific_Samoa = 567,
+	Pacific_Tahiti = 568,
+	Pacific_Tarawa = 569,
+	Pacific_Tongatapu = 570,
+	Pacific_Truk = 571,
+	Pacific_Wake = 572,
+	Pacific_Wallis = 573,
+	Pacific_Yap = 574,
+	Poland = 575,
+	Portugal = 576,
+	ROC = 577,
+	ROK = 578,
+	Singapore = 579,
+	Turkey = 580,
+	UCT = 581,
+	US_Alaska = 582,
+	US_Aleutian = 583,
+	US_Arizona = 584,
+	US_Central = 585,
+	US_East_Indiana = 586,
+	US_Eastern = 587,
+	US_Hawaii = 588,
+	US_Indiana_Starke = 589,
+	US_Michigan = 590,
+	US_Mountain = 591,
+	US_Pacific = 592,
+	US_Samoa = 593,
+	UTC = 594,
+	Universal = 595,
+	W_SU = 596,
+	WET = 597,
+	Zulu = 598
+};
+
+/**
+* @class WorldTimeAPIZones
+* @brief Sorted table of IANA time zone names. ID of time zone is index to that table.
+*/
+class WorldTimeAPIZones {
+public:
+	/**
+	* @brief Time zone names sorted by strcmp(), first item is empty (invalid ID).
+	*/
+	static constexpr const char* const names[WTAPI_TZ_COUNT + 1] = {
+		"",
+		"Africa/Abidjan",
+		"Africa/Accra",
+		"Africa/Addis_Ababa",
+		"Africa/Algiers",
+		"Africa/Asmara",
+		"Africa/Asmera",
+		"Africa/Bamako",
+		"Africa/Bangui",
+		"Africa/Banjul",
+		"Africa/Bissau",
+		"Africa/Blantyre",
+		"Africa/Brazzaville",
+		"Africa/Bujumbura",
+		"Africa/Cairo",
+		"Africa/Casablanca",
+		"Africa/Ceuta",
+		"Africa/Conakry",
+		"Africa/Dakar",
+		"Africa/Dar_es_Salaam",
+		"Africa/Djibouti",
+		"Africa/Douala",
+		"Africa/El_Aaiun",
+		"Africa/Freetown",
+		"Africa/Gaborone",
+		"Africa/Harare",
+		"Africa/Johannesburg",
+		"Africa/Juba",
+		"Africa/Kampala",
+		"Africa/Khartoum",
+		"Africa/Kigali",
+		"Africa/Kinshasa",
+		"Africa/Lagos",
+		"Africa/Libreville",
+		"Africa/Lome",
+		"Africa/Luanda",
+		"Africa/Lubumbashi",
+		"Africa/Lusaka",
+		"Africa/Malabo",
+		"Africa/Maputo",
+		"Africa/Maseru",
+		"Africa/Mbabane",
+		"Africa/Mogadishu",
+		"Africa/Monrovia",
+		"Africa/Nairobi",
+		"Africa/Ndjamena",
+		"Africa/Niamey",
+		"Africa/Nouakchott",
+		"Africa/Ouagadougou",
+		"Africa/Porto-Novo",
+		"Africa/Sao_Tome",
+		"Africa/Timbuktu",
+		"Africa/Tripoli",
+		"Africa/Tunis",
+		"Africa/Windhoek",
+		"America/Adak",
+		"America/Anchorage",
+		"America/Anguilla",
+		"America/Antigua",
+		"America/Araguaina",
+		"America/Argentina/Buenos_Aires",
+		"America/Argentina/Catamarca",
+		"America/Argentina/ComodRivadavia",
+		"America/Argentina/Cordoba",
+		"America/Argentina/Jujuy",
+		"America/Argentina/La_Rioja",
+		"America/Argentina/Mendoza",
+		"America/Argentina/Rio_Gallegos",
+		"America/Argentina/Salta",
+		"America/Argentina/San_Juan",
+		"America/Argentina/San_Luis",
+		"America/Argentina/Tucuman",
+		"America/Argentina/Ushuaia",
+		"America/Aruba",
+		"America/Asuncion",
+		"America/Atikokan",
+		"America/Atka",
+		"America/Bahia",
+		"America/Bahia_Banderas",
+		"America/Barbados",
+		"America/Belem",
+		"America/Belize",
+		"America/Blanc-Sablon",
+		"America/Boa_Vista",
+		"America/Bogota",
+		"America/Boise",
+		"America/Buenos_Aires",
+		"America/Cambridge_Bay",
+		"America/Campo_Grande",
+		"America/Cancun",
+		"America/Caracas",
+		"America/Catamarca",
+		"America/Cayenne",
+		"America/Cayman",
+		"America/Chicago",
+		"America/Chihuahua",
+		"America/Ciudad_Juarez",
+		"America/Coral_Harbour",
+		"America/Cordoba",
+		"America/Costa_Rica",
+		"America/Coyhaique",
+		"America/Creston",
+		"America/Cuiaba",
+		"America/Curacao",
+		"America/Danmarkshavn",
+		"America/Dawson",
+		"America/Dawson_Creek",
+		"America/Denver",
+		"America/Detroit",
+		"America/Dominica",
+		"America/Edmonton",
+		"America/Eirunepe",
+		"America/El_Salvador",
+		"America/Ensenada",
+		"America/Fort_Nelson",
+		"America/Fort_Wayne",
+		"America/Fortaleza",
+		"America/Glace_Bay",
+		"America/Godthab",
+		"America/Goose_Bay",
+		"America/Grand_Turk",
+		"America/Grenada",
+		"America/Guadeloupe",
+		"America/Guatemala",
+		"America/Guayaquil",
+		"America/Guyana",
+		"America/Halifax",
+		"America/Havana",
+		"America/Hermosillo",
+		"America/Indiana/Indianapolis",
+		"America/Indiana/Knox",
+		"America/Indiana/Marengo",
+		"America/Indiana/Petersburg",
+		"America/Indiana/Tell_City",
+		"America/Indiana/Vevay",
+		"America/Indiana/Vincennes",
+		"America/Indiana/Winamac",
+		"America/Indianapolis",
+		"America/Inuvik",
+		"America/Iqaluit",
+		"America/Jamaica",
+		"America/Jujuy",
+		"America/Juneau",
+		"America/Kentucky/Louisville",
+		"America/Kentucky/Monticello",
+		"America/Knox_IN",
+		"America/Kralendijk",
+		"America/La_Paz",
+		"America/Lima",
+		"America/Los_Angeles",
+		"America/Louisville",
+		"America/Lower_Princes",
+		"America/Maceio",
+		"America/Managua",
+		"America/Manaus",
+		"America/Marigot",
+		"America/Martinique",
+		"America/Matamoros",
+		"America/Mazatlan",
+		"America/Mendoza",
+		"America/Menominee",
+		"America/Merida",
+		"America/Metlakatla",
+		"America/Mexico_City",
+		"America/Miquelon",
+		"America/Moncton",
+		"America/Monterrey",
+		"America/Montevideo",
+		"America/Montreal",
+		"America/Montserrat",
+		"America/Nassau",
+		"America/New_York",
+		"America/Nipigon",
+		"America/Nome",
+		"America/Noronha",
+		"America/North_Dakota/Beulah",
+		"America/North_Dakota/Center",
+		"America/North_Dakota/New_Salem",
+		"America/Nuuk",
+		"America/Ojinaga",
+		"America/Panama",
+		"America/Pangnirtung",
+		"America/Paramaribo",
+		"America/Phoenix",
+		"America/Port-au-Prince",
+		"America/Port_of_Spain",
+		"America/Porto_Acre",
+		"America/Porto_Velho",
+		"America/Puerto_Rico",
+		"America/Punta_Arenas",
+		"America/Rainy_River",
+		"America/Rankin_Inlet",
+		"America/Recife",
+		"America/Regina",
+		"America/Resolute",
+		"America/Rio_Branco",
+		"America/Rosario",
+		"America/Santa_Isabel",
+		"America/Santarem",
+		"America/Santiago",
+		"America/Santo_Domingo",
+		"America/Sao_Paulo",
+		"America/Scoresbysund",
+		"America/Shiprock",
+		"America/Sitka",
+		"America/St_Barthelemy",
+		"America/St_Johns",
+		"America/St_Kitts",
+		"America/St_Lucia",
+		"America/St_Thomas",
+		"America/St_Vincent",
+		"America/Swift_Current",
+		"America/Tegucigalpa",
+		"America/Thule",
+		"America/Thunder_Bay",
+		"America/Tijuana",
+		"America/Toronto",
+		"America/Tortola",
+		"America/Vancouver",
+		"America/Virgin",
+		"America/Whitehorse",
+		"America/Winnipeg",
+		"America/Yakutat",
+		"America/Yellowknife",
+		"Antarctica/Casey",
+		"Antarctica/Davis",
+		"Antarctica/DumontDUrville",
+		"Antarctica/Macquarie",
+		"Antarctica/Mawson",
+		"Antarctica/McMurdo",
+		"Antarctica/Palmer",
+		"Antarctica/Rothera",
+		"Antarctica/South_Pole",
+		"Antarctica/Syowa",
+		"Antarctica/Troll",
+		"Antarctica/Vostok",
+		"Arctic/Longyearbyen",
+		"Asia/Aden",
+		"Asia/Almaty",
+		"Asia/Amman",
+		"Asia/Anadyr",
+		"Asia/Aqtau",
+		"Asia/Aqtobe",
+		"Asia/Ashgabat",
+		"Asia/Ashkhabad",
+		"Asia/Atyrau",
+		"Asia/Baghdad",
+		"Asia/Bahrain",
+		"Asia/Baku",
+		"Asia/Bangkok",
+		"Asia/Barnaul",
+		"Asia/Beirut",
+		"Asia/Bishkek",
+		"Asia/Brunei",
+		"Asia/Calcutta",
+		"Asia/Chita",
+		"Asia/Choibalsan",
+		"Asia/Chongqing",
+		"Asia/Chungking",
+		"Asia/Colombo",
+		"Asia/Dacca",
+		"Asia/Damascus",
+		"Asia/Dhaka",
+		"Asia/Dili",
+		"Asia/Dubai",
+		"Asia/Dushanbe",
+		"Asia/Famagusta",
+		"Asia/Gaza",
+		"Asia/Harbin",
+		"Asia/Hebron",
+		"Asia/Ho_Chi_Minh",
+		"Asia/Hong_Kong",
+		"Asia/Hovd",
+		"Asia/Irkutsk",
+		"Asia/Istanbul",
+		"Asia/Jakarta",
+		"Asia/Jayapura",
+		"Asia/Jerusalem",
+		"Asia/Kabul",
+		"Asia/Kamchatka",
+		"Asia/Karachi",
+		"Asia/Kashgar",
+		"Asia/Kathmandu",
+		"Asia/Katmandu",
+		"Asia/Khandyga",
+		"Asia/Kolkata",
+		"Asia/Krasnoyarsk",
+		"Asia/Kuala_Lumpur",
+		"Asia/Kuching",
+		"Asia/Kuwait",
+		"Asia/Macao",
+		"Asia/Macau",
+		"Asia/Magadan",
+		"Asia/Makassar",
+		"Asia/Manila",
+		"Asia/Muscat",
+		"Asia/Nicosia",
+		"Asia/Novokuznetsk",
+		"Asia/Novosibirsk",
+		"Asia/Omsk",
+		"Asia/Oral",
+		"Asia/Phnom_Penh",
+		"Asia/Pontianak",
+		"Asia/Pyongyang",
+		"Asia/Qatar",
+		"Asia/Qostanay",
+		"Asia/Qyzylorda",
+		"Asia/Rangoon",
+		"Asia/Riyadh",
+		"Asia/Saigon",
+		"Asia/Sakhalin",
+		"Asia/Samarkand",
+		"Asia/Seoul",
+		"Asia/Shanghai",
+		"Asia/Singapore",
+		"Asia/Srednekolymsk",
+		"Asia/Taipei",
+		"Asia/Tashkent",
+		"Asia/Tbilisi",
+		"Asia/Tehran",
+		"Asia/Tel_Aviv",
+		"Asia/Thimbu",
+		"Asia/Thimphu",
+		"Asia/Tokyo",
+		"Asia/Tomsk",
+		"Asia/Ujung_Pandang",
+		"Asia/Ulaanbaatar",
+		"Asia/Ulan_Bator",
+		"Asia/Urumqi",
+		"Asia/Ust-Nera",
+		"Asia/Vientiane",
+		"Asia/Vladivostok",
+		"Asia/Yakutsk",
+		"Asia/Yangon",
+		"Asia/Yekaterinburg",
+		"Asia/Yerevan",
+		"Atlantic/Azores",
+		"Atlantic/Bermuda",
+		"Atlantic/Canary",
+		"Atlantic/Cape_Verde",
+		"Atlantic/Faeroe",
+		"Atlantic/Faroe",
+		"Atlantic/Jan_Mayen",
+		"Atlantic/Madeira",
+		"Atlantic/Reykjavik",
+		"Atlantic/South_Georgia",
+		"Atlantic/St_Helena",
+		"Atlantic/Stanley",
+		"Australia/ACT",
+		"Australia/Adelaide",
+		"Australia/Brisbane",
+		"Australia/Broken_Hill",
+		"Australia/Canberra",
+		"Australia/Currie",
+		"Australia/Darwin",
+		"Australia/Eucla",
+		"Australia/Hobart",
+		"Australia/LHI",
+		"Australia/Lindeman",
+		"Australia/Lord_Howe",
+		"Australia/Melbourne",
+		"Australia/NSW",
+		"Australia/North",
+		"Australia/Perth",
+		"Australia/Queensland",
+		"Australia/South",
+		"Australia/Sydney",
+		"Australia/Tasmania",
+		"Australia/Victoria",
+		"Australia/West",
+		"Australia/Yancowinna",
+		"Brazil/Acre",
+		"Brazil/DeNoronha",
+		"Brazil/East",
+		"Brazil/West",
+		"CET",
+		"CST6CDT",
+		"Canada/Atlantic",
+		"Canada/Central",
+		"Canada/Eastern",
+		"Canada/Mountain",
+		"Canada/Newfoundland",
+		"Canada/Pacific",
+		"Canada/Saskatchewan",
+		"Canada/Yukon",
+		"Chile/Continental",
+		"Chile/EasterIsland",
+		"Cuba",
+		"EET",
+		"EST",
+		"EST5EDT",
+		"Egypt",
+		"Eire",
+		"Etc/GMT",
+		"Etc/GMT+0",
+		"Etc/GMT+1",
+		"Etc/GMT+10",
+		"Etc/GMT+11",
+		"Etc/GMT+12",
+		"Etc/GMT+2",
+		"Etc/GMT+3",
+		"Etc/GMT+4",
+		"Etc/GMT+5",
+		"Etc/GMT+6",
+		"Etc/GMT+7",
+		"Etc/GMT+8",
+		"Etc/GMT+9",
+		"Etc/GMT-0",
+		"Etc/GMT-1",
+		"Etc/GMT-10",
+		"Etc/GMT-11",
+		"Etc/GMT-12",
+		"Etc/GMT-13",
+		"Etc/GMT-14",
+		"Etc/GMT-2",
+		"Etc/GMT-3",
+		"Etc/GMT-4",
+		"Etc/GMT-5",
+		"Etc/GMT-6",
+		"Etc/GMT-7",
+		"Etc/GMT-8",
+		"Etc/GMT-9",
+		"Etc/GMT0",
+		"Etc/Greenwich",
+		"Etc/UCT",
+		"Etc/UTC",
+		"Etc/Universal",
+		"Etc/Zulu",
+		"Europe/Amsterdam",
+		"Europe/Andorra",
+		"Europe/Astrakhan",
+		"Europe/Athens",
+		"Europe/Belfast",
+		"Europe/Belgrade",
+		"Europe/Berlin",
+		"Europe/Bratislava",
+		"Europe/Brussels",
+		"Europe/Bucharest",
+		"Europe/Budapest",
+		"Europe/Busingen",
+		"Europe/Chisinau",
+		"Europe/Copenhagen",
+		"Europe/Dublin",
+		"Europe/Gibraltar",
+		"Europe/Guernsey",
+		"Europe/Helsinki",
+		"Europe/Isle_of_Man",
+		"Europe/Istanbul",
+		"Europe/Jersey",
+		"Europe/Kaliningrad",
+		"Europe/Kiev",
+		"Europe/Kirov",
+		"Europe/Kyiv",
+		"Europe/Lisbon",
+		"Europe/Ljubljana",
+		"Europe/London",
+		"Europe/Luxembourg",
+		"Europe/Madrid",
+		"Europe/Malta",
+		"Europe/Mariehamn",
+		"Europe/Minsk",
+		"Europe/Monaco",
+		"Europe/Moscow",
+		"Europe/Nicosia",
+		"Europe/Oslo",
+		"Europe/Paris",
+		"Europe/Podgorica",
+		"Europe/Prague",
+		"Europe/Riga",
+		"Europe/Rome",
+		"Europe/Samara",
+		"Europe/San_Marino",
+		"Europe/Sarajevo",
+		"Europe/Saratov",
+		"Europe/Simferopol",
+		"Europe/Skopje",
+		"Europe/Sofia",
+		"Europe/Stockholm",
+		"Europe/Tallinn",
+		"Europe/Tirane",
+		"Europe/Tiraspol",
+		"Europe/Ulyanovsk",
+		"Europe/Uzhgorod",
+		"Europe/Vaduz",
+		"Europe/Vatican",
+		"Europe/Vienna",
+		"Europe/Vilnius",
+		"Europe/Volgograd",
+		"Europe/Warsaw",
+		"Europe/Zagreb",
+		"Europe/Zaporozhye",
+		"Europe/Zurich",
+		"Factory",
+		"GB",
+		"GB-Eire",
+		"GMT",
+		"GMT+0",
+		"GMT-0",
+		"GMT0",
+		"Greenwich",
+		"HST",
+		"Hongkong",
+		"Iceland",
+		"Indian/Antananarivo",
+		"Indian/Chagos",
+		"Indian/Christmas",
+		"Indian/Cocos",
+		"Indian/Comoro",
+		"Indian/Kerguelen",
+		"Indian/Mahe",
+		"Indian/Maldives",
+		"Indian/Mauritius",
+		"Indian/Mayotte",
+		"Indian/Reunion",
+		"Iran",
+		"Israel",
+		"Jamaica",
+		"Japan",
+		"Kwajalein",
+		"Libya",
+		"MET",
+		"MST",
+		"MST7MDT",
+		"Mexico/BajaNorte",
+		"Mexico/BajaSur",
+		"Mexico/General",
+		"NZ",
+		"NZ-CHAT",
+		"Navajo",
+		"PRC",
+		"PST8PDT",
+		"Pacific/Apia",
+		"Pacific/Auckland",
+		"Pacific/Bougainville",
+		"Pacific/Chatham",
+		"Pacific/Chuuk",
+		"Pacific/Easter",
+		"Pacific/Efate",
+		"Pacific/Enderbury",
+		"Pacific/Fakaofo",
+		"Pacific/Fiji",
+		"Pacific/Funafuti",
+		"Pacific/Galapagos",
+		"Pacific/Gambier",
+		"Pacific/Guadalcanal",
+		"Pacific/Guam",
+		"Pacific/Honolulu",
+		"Pacific/Johnston",
+		"Pacific/Kanton",
+		"Pacific/Kiritimati",
+		"Pacific/Kosrae",
+		"Pacific/Kwajalein",
+		"Pacific/Majuro",
+		"Pacific/Marquesas",
+		"Pacific/Midway",
+		"Pacific/Nauru",
+		"Pacific/Niue",
+		"Pacific/Norfolk",
+		"Pacific/Noumea",
+		"Pacific/Pago_Pago",
+		"Pacific/Palau",
+		"Pacific/Pitcairn",
+		"Pacific/Pohnpei",
+		"Pacific/Ponape",
+		"Pacific/Port_Moresby",
+		"Pacific/Rarotonga",
+		"Pacific/Saipan",
+		"Pacific/Samoa",
+		"Pacific/Tahiti",
+		"Pacific/Tarawa",
+		"Pacific/Tongatapu",
+		"Pacific/Truk",
+		"Pacific/Wake",
+		"Pacific/Wallis",
+		"Pacific/Yap",
+		"Poland",
+		"Portugal",
+		"ROC",
+		"ROK",
+		"Singapore",
+		"Turkey",
+		"UCT",
+		"US/Alaska",
+		"US/Aleutian",
+		"US/Arizona",
+		"US/Central",
+		"US/East-Indiana",
+		"US/Eastern",
+		"US/Hawaii",
+		"US/Indiana-Starke",
+		"US/Michigan",
+		"US/Mountain",
+		"US/Pacific",
+		"US/Samoa",
+		"UTC",
+		"Universal",
+		"W-SU",
+		"WET",
+		"Zulu"
+	};
+
+	/**
+	* @brief Gets name of time zone.
+	* @return Returns Olson time zone name or NULL if ID is invalid.
+	*/
+	static constexpr const char* name(WorldTimeAPI_TzId id) {
+		return ((uint16_t)id == 0 || (uint16_t)id > WTAPI_TZ_COUNT) ? NULL : names[(uint16_t)id];
+	}
+
+	/**
+	* @brief Returns true if ID is valid.
+	*/
+	static constexpr bool isValid(WorldTimeAPI_TzId id) {
+		return (uint16_t)id != 0 && (uint16_t)id <= WTAPI_TZ_COUNT;
+	}
+
+	/**
+	* @brief Finds ID of time zone by name (binary search).
+	* @param name Olson time zone name, for example: "Europe/Bratislava".
+	* @return Returns ID of time zone or WorldTimeAPI_TzId::Invalid if name is unknown.
+	*/
+	static WorldTimeAPI_TzId find(const char* name);
+};
+
+#endif // WTAPI_TZ_TABLE
+
+#endif // !WORLD_TIME_API_ZONES_H_
@@ -0,0 +1,60 @@
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#else
+#error "This board is not supported."
+#endif
+
+#include "DateTime.h"
+#include "WorldTimeAPILookup.h"
+
+//Blinks LED while time zone is requested, lookup is advanced by poll() in every iteration of loop.
+
+#ifndef LED_BUILTIN
+#define LED_BUILTIN 2
+#endif
+
+WorldTimeAPILookup lookup;
+uint32_t lastBlink = 0;
+bool ledOn = false;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println();
+  pinMode(LED_BUILTIN, OUTPUT);
+
+  WiFi.begin("ssid", "password"); //Set SSID and password of your WiFi
+
+  //Connecting to WiFi
+  Serial.print("Connecting");
+  while (WiFi.status() != WL_CONNECTED)
+  {
+    delay(500);
+    Serial.print(".");
+  }
+  Serial.println();
+
+  lookup.startByTimeZone("Europe/Bratislava");
+}
+
+void loop() {
+  if (lookup.poll() == WTA_LOOKUP_DONE) {
+    const WorldTimeAPIResult& res = lookup.getResult();
+    if (res.hasError()) {
+      Serial.print("Error occured: ");
+      Serial.println((int)res.httpCode);
+    }
+    else {
+      Serial.println(res.datetime.toString());
+    }
+    lookup.cancel(); //Lookup is idle now, so it is not printed again
+  }
+
+  //Other work of loop is not blocked by lookup
+  if (millis() - lastBlink >= 100) {
+    lastBlink = millis();
+    ledOn = !ledOn;
+    digitalWrite(LED_BUILTIN, ledOn ? HIGH : LOW);
+  }
+}
@@ -0,0 +1,51 @@
+#include "DateTime.h"
+#include "WorldTimeAPI.h"
+
+//Compares parsing speed of JSON and plain text responses. No WiFi connection is needed.
+
+const char* jsonResponse = "{\"abbreviation\":\"CEST\",\"client_ip\":\"185.142.49.50\",\"datetime\":\"2022-06-16T13:57:27.659132+02:00\",\"day_of_week\":4,\"day_of_year\":167,\"dst\":true,\"dst_from\":\"2022-03-27T01:00:00+00:00\",\"dst_offset\":3600,\"dst_until\":\"2022-10-30T01:00:00+00:00\",\"raw_offset\":3600,\"timezone\":\"Europe/Bratislava\",\"unixtime\":1655380647,\"utc_datetime\":\"2022-06-16T11:57:27.659132+00:00\",\"utc_offset\":\"+02:00\",\"week_number\":24}";
+
+const char* textResponse = "abbreviation: CEST\n"
+  "client_ip: 185.142.49.50\n"
+  "datetime: 2022-06-16T13:57:27.659132+02:00\n"
+  "day_of_week: 4\n"
+  "day_of_year: 167\n"
+  "dst: true\n"
+  "dst_from: 2022-03-27T01:00:00+00:00\n"
+  "dst_offset: 3600\n"
+  "dst_until: 2022-10-30T01:00:00+00:00\n"
+  "raw_offset: 3600\n"
+  "timezone: Europe/Bratislava\n"
+  "unixtime: 1655380647\n"
+  "utc_datetime: 2022-06-16T11:57:27.659132+00:00\n"
+  "utc_offset: +02:00\n"
+  "week_number: 24\n";
+
+WorldTimeAPIResult res;
+
+void benchmark(const char* name, const char* response, WorldTimeAPI_Format format) {
+  const int count = 1000;
+  int length = strlen(response);
+  uint32_t t1 = micros();
+  for (int i = 0; i < count; i++) {
+    WorldTimeAPI::parseResponse(response, length, format, res);
+  }
+  t1 = micros() - t1;
+
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print((float)t1 / count);
+  Serial.print("us per response, result: ");
+  Serial.println((int)res.httpCode);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println();
+
+  benchmark("JSON", jsonResponse, WTA_FORMAT_JSON);
+  benchmark("Text", textResponse, WTA_FORMAT_TEXT);
+}
+
+void loop() {
+}
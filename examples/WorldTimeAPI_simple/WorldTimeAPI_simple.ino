@@ -43,13 +43,13 @@ void setup() {
     Serial.println("us");
     
     Serial.print("Timezone: ");
-    Serial.println(res.timezone);
+    Serial.println(res.timezone());
     
     Serial.print("Abbreviation: ");
     Serial.println(res.abbreviation);
     
     Serial.print("Client IP: ");
-    Serial.println(res.client_ip.toString());
+    Serial.println(res.client_ip().toString());
     
     //Printing time every 1 second
     //Time may not be accurate - to obtain accurate time, use ntp server.
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Generates WorldTimeAPIZones.h and WorldTimeAPIZones.cpp from tzdata.zi of IANA time zone database.
+
+Usage: python3 generate_zones.py [path to tzdata.zi]
+
+IDs are indexes to table sorted by name (0 is invalid ID), so they are stable only for
+the same version of tzdata. Zones and links (backward compatible names) are included.
+"""
+
+import os
+import re
+import sys
+
+HEADER = '''/**
+ * @file WorldTimeAPIZones.h
+ * @brief This file contains table of IANA time zone names (tzdata {version}).
+ * Generated by extras/generate_zones.py, do not edit.
+ *
+ * @see WorldTimeAPIZones
+ */
+
+#ifndef WORLD_TIME_API_ZONES_H_
+#define WORLD_TIME_API_ZONES_H_
+
+#include "SimpleJSONParser.h"
+
+#if defined(SJSONP_UNDER_OS) || (defined(ESP32) && defined(ARDUINO))
+//Table is kept in flash, on ESP8266 it would be copied to RAM
+#define WTAPI_TZ_TABLE (1)
+#endif // SJSONP_UNDER_OS || ESP32
+
+#ifdef WTAPI_TZ_TABLE
+
+#define WTAPI_TZ_TABLE_VERSION    "{version}"
+#define WTAPI_TZ_COUNT            ({count})
+
+/**
+* @brief IDs of IANA time zones. In names, '/' is replaced by '_', '+' by 'p' and '-' by 'm' before digit
+* or by '_' otherwise, for example: Europe/Bratislava - WorldTimeAPI_TzId::Europe_Bratislava, Etc/GMT+1 - WorldTimeAPI_TzId::Etc_GMTp1.
+*/
+enum class WorldTimeAPI_TzId : uint16_t {{
+	Invalid = 0,
+{enum}
+}};
+
+/**
+* @class WorldTimeAPIZones
+* @brief Sorted table of IANA time zone names. ID of time zone is index to that table.
+*/
+class WorldTimeAPIZones {{
+public:
+	/**
+	* @brief Time zone names sorted by strcmp(), first item is empty (invalid ID).
+	*/
+	static constexpr const char* const names[WTAPI_TZ_COUNT + 1] = {{
+		"",
+{names}
+	}};
+
+	/**
+	* @brief Gets name of time zone.
+	* @return Returns Olson time zone name or NULL if ID is invalid.
+	*/
+	static constexpr const char* name(WorldTimeAPI_TzId id) {{
+		return ((uint16_t)id == 0 || (uint16_t)id > WTAPI_TZ_COUNT) ? NULL : names[(uint16_t)id];
+	}}
+
+	/**
+	* @brief Returns true if ID is valid.
+	*/
+	static constexpr bool isValid(WorldTimeAPI_TzId id) {{
+		return (uint16_t)id != 0 && (uint16_t)id <= WTAPI_TZ_COUNT;
+	}}
+
+	/**
+	* @brief Finds ID of time zone by name (binary search).
+	* @param name Olson time zone name, for example: "Europe/Bratislava".
+	* @return Returns ID of time zone or WorldTimeAPI_TzId::Invalid if name is unknown.
+	*/
+	static WorldTimeAPI_TzId find(const char* name);
+}};
+
+#endif // WTAPI_TZ_TABLE
+
+#endif // !WORLD_TIME_API_ZONES_H_
+'''
+
+SOURCE = '''#include "WorldTimeAPIZones.h"
+
+#ifdef WTAPI_TZ_TABLE
+#include <string.h>
+
+constexpr const char* const WorldTimeAPIZones::names[WTAPI_TZ_COUNT + 1];
+
+WorldTimeAPI_TzId WorldTimeAPIZones::find(const char* name) {
+	if (name == NULL) {
+		return WorldTimeAPI_TzId::Invalid;
+	}
+	uint16_t lo = 1;
+	uint16_t hi = WTAPI_TZ_COUNT;
+	while (lo <= hi) {
+		uint16_t mid = (lo + hi) / 2;
+		int cmp = strcmp(names[mid], name);
+		if (cmp == 0) {
+			return (WorldTimeAPI_TzId)mid;
+		}
+		if (cmp < 0) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid - 1;
+		}
+	}
+	return WorldTimeAPI_TzId::Invalid;
+}
+#endif // WTAPI_TZ_TABLE
+'''
+
+
+def identifier(name):
+	ident = re.sub(r'-(?=\d)', 'm', name)
+	ident = ident.replace('+', 'p').replace('/', '_').replace('-', '_')
+	return ident
+
+
+def main():
+	path = sys.argv[1] if len(sys.argv) > 1 else '/usr/share/zoneinfo/tzdata.zi'
+	version = 'unknown'
+	names = set()
+	with open(path, encoding='utf-8') as f:
+		for line in f:
+			fields = line.split()
+			if not fields:
+				continue
+			if fields[0] == '#' and len(fields) >= 3 and fields[1] == 'version':
+				version = fields[2]
+			elif fields[0] == 'Z':
+				names.add(fields[1])
+			elif fields[0] == 'L':
+				names.add(fields[2])
+	names = sorted(names)
+	idents = [identifier(n) for n in names]
+	if len(set(idents)) != len(idents):
+		sys.exit('Identifiers of time zones are not unique')
+
+	out = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+	enum = ',\n'.join('\t%s = %d' % (ident, i + 1) for i, ident in enumerate(idents))
+	table = ',\n'.join('\t\t"%s"' % n for n in names)
+	with open(os.path.join(out, 'WorldTimeAPIZones.h'), 'w', newline='\r\n') as f:
+		f.write(HEADER.format(version=version, count=len(names), enum=enum, names=table))
+	with open(os.path.join(out, 'WorldTimeAPIZones.cpp'), 'w', newline='\r\n') as f:
+		f.write(SOURCE)
+
+
+if __name__ == '__main__':
+	main()
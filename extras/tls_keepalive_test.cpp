@@ -0,0 +1,80 @@
+/**
+ * @file tls_keepalive_test.cpp
+ * @brief Checks reuse of kept-alive connections and resumption of TLS sessions by WorldTimeAPIOpenSSLTransport
+ * against local TLS server.
+ * It is started by tls_keepalive_test.py, which runs the server.
+ *
+ * Usage: tls_keepalive_test <port> <CA file>
+ */
+
+#include "WorldTimeAPITLS.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failures = 0;
+
+/**
+* @brief Sends request and checks its result and whether connection was reused.
+*/
+static void check(WorldTimeAPIOpenSSLTransport& tls, const char* name, const char* url, bool expectOk, bool expectReused) {
+	uint32_t reusedBefore = tls.getReusedCount();
+	std::string body;
+	WorldTimeAPI_HttpCode httpCode = tls.get(url, body, NULL, 3000, NULL);
+	bool ok = httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK && body.find("\"timezone\":\"Europe/Bratislava\"") != std::string::npos;
+	bool reused = tls.getReusedCount() != reusedBefore;
+	bool passed = (ok == expectOk) && (!expectOk || reused == expectReused);
+	printf("%s %-40s code=%d reused=%d\n", passed ? "PASS" : "FAIL", name, (int)httpCode, (int)reused);
+	if (!passed) failures++;
+}
+
+/**
+* @brief Sends request over new connection and checks, whether cached TLS session was resumed.
+*/
+static void checkHandshake(WorldTimeAPIOpenSSLTransport& tls, const char* name, const char* url, bool expectResumed) {
+	uint32_t handshakesBefore = tls.getHandshakeCount();
+	uint32_t resumedBefore = tls.getResumedCount();
+	uint32_t reusedBefore = tls.getReusedCount();
+	std::string body;
+	WorldTimeAPI_HttpCode httpCode = tls.get(url, body, NULL, 3000, NULL);
+	bool ok = httpCode == WorldTimeAPI_HttpCode::WTA_HTTP_CODE_OK && body.find("\"timezone\":\"Europe/Bratislava\"") != std::string::npos;
+	uint32_t handshakes = tls.getHandshakeCount() - handshakesBefore;
+	uint32_t resumed = tls.getResumedCount() - resumedBefore;
+	bool passed = ok && tls.getReusedCount() == reusedBefore && handshakes == (expectResumed ? 0u : 1u) && resumed == (expectResumed ? 1u : 0u);
+	printf("%s %-40s code=%d handshakes=%u resumed=%u\n", passed ? "PASS" : "FAIL", name, (int)httpCode, (unsigned)handshakes, (unsigned)resumed);
+	if (!passed) failures++;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		printf("Usage: %s <port> <CA file>\n", argv[0]);
+		return 2;
+	}
+	WorldTimeAPIOpenSSLTransport tls;
+	if (!tls.setCAFile(argv[2])) {
+		printf("Cannot load %s\n", argv[2]);
+		return 2;
+	}
+	std::string base = std::string("https://127.0.0.1:") + argv[1];
+
+	check(tls, "content-length", (base + "/plain").c_str(), true, false);
+	check(tls, "content-length, reused", (base + "/plain").c_str(), true, true);
+	check(tls, "last chunk split from end", (base + "/split").c_str(), true, true);
+	check(tls, "after split last chunk", (base + "/plain").c_str(), true, true);
+	check(tls, "chunked with trailers", (base + "/trailer").c_str(), true, true);
+	check(tls, "after trailers", (base + "/plain").c_str(), true, true);
+	check(tls, "data after body", (base + "/extra").c_str(), true, true);
+	check(tls, "after data after body, new connection", (base + "/plain").c_str(), true, false);
+	check(tls, "invalid chunk size", (base + "/badchunk").c_str(), false, false);
+	check(tls, "after invalid chunk, new connection", (base + "/plain").c_str(), true, false);
+
+	//Idle connection is closed, but session of host stays cached
+	tls.setKeepAlive(0);
+	checkHandshake(tls, "keep-alive disabled, session resumed", (base + "/plain").c_str(), true);
+	tls.setKeepAlive(WTAPI_TLS_MAX_IDLE);
+	tls.clear();
+	checkHandshake(tls, "after clear, full handshake", (base + "/plain").c_str(), false);
+
+	printf("%s\n", failures == 0 ? "All tests passed" : "Some tests failed");
+	return failures == 0 ? 0 : 1;
+}
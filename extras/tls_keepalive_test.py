@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Runs tls_keepalive_test.cpp against local TLS server, which sends responses split or framed in ways,
+which broke reuse of kept-alive connections (last chunk split from final CRLF, trailers, data after body).
+
+Usage: python3 tls_keepalive_test.py
+
+Self-signed certificate is created by openssl command. Test is compiled by $CXX (default g++) with
+$CXXFLAGS and $LDFLAGS, so include path of DateTime library can be given, for example:
+CXXFLAGS="-I/path/to/DateTime/src" LDFLAGS="/path/to/DateTime/src/DateTime.cpp" python3 tls_keepalive_test.py
+"""
+
+import glob
+import os
+import shlex
+import socketserver
+import ssl
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+BODY = (b'{"abbreviation":"CEST","client_ip":"185.142.49.50","datetime":"2022-06-16T13:57:27.659132+02:00",'
+        b'"day_of_week":4,"day_of_year":167,"dst":true,"dst_from":"2022-03-27T01:00:00+00:00","dst_offset":3600,'
+        b'"dst_until":"2022-10-30T01:00:00+00:00","raw_offset":3600,"timezone":"Europe/Bratislava",'
+        b'"unixtime":1655380647,"utc_datetime":"2022-06-16T11:57:27.659132+00:00","utc_offset":"+02:00","week_number":24}')
+
+
+def chunks(body, size=100):
+    return b''.join(b'%x\r\n' % len(body[i:i + size]) + body[i:i + size] + b'\r\n' for i in range(0, len(body), size))
+
+
+class Handler(socketserver.StreamRequestHandler):
+    """Minimal HTTP/1.1 server, each write is sent in separate TLS record."""
+
+    def send(self, data, pause=0.0):
+        self.wfile.write(data)
+        self.wfile.flush()
+        if pause:
+            time.sleep(pause)
+
+    def handle(self):
+        while True:
+            request = self.rfile.readline()
+            if not request:
+                return
+            while self.rfile.readline() not in (b'\r\n', b'\n', b''):
+                pass
+            path = request.split(b' ')[1]
+            chunked = b'HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n'
+            if path == b'/split':
+                self.send(chunked + chunks(BODY) + b'0\r\n', 0.1)
+                self.send(b'\r\n')
+            elif path == b'/trailer':
+                self.send(chunked + chunks(BODY) + b'0\r\nX-Checksum: 1\r\n', 0.1)
+                self.send(b'X-Other: 2\r\n\r\n')
+            elif path == b'/badchunk':
+                self.send(chunked + b'zz\r\n' + BODY + b'\r\n0\r\n\r\n')
+            elif path == b'/extra':
+                self.send(b'HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n' % len(BODY) + BODY + b'garbage')
+            else:
+                self.send(b'HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n' % len(BODY) + BODY)
+
+
+class Server(socketserver.ThreadingTCPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    work = tempfile.mkdtemp()
+    cert = os.path.join(work, 'cert.pem')
+    key = os.path.join(work, 'key.pem')
+    subprocess.run(['openssl', 'req', '-x509', '-newkey', 'rsa:2048', '-nodes', '-days', '1', '-subj', '/CN=127.0.0.1',
+                    '-addext', 'subjectAltName=IP:127.0.0.1', '-keyout', key, '-out', cert],
+                   check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+    binary = os.path.join(work, 'tls_keepalive_test')
+    sources = sorted(glob.glob(os.path.join(root, '*.cpp'))) + [os.path.join(root, 'extras', 'tls_keepalive_test.cpp')]
+    command = ([os.environ.get('CXX', 'g++'), '-std=c++17', '-DWTAPI_USE_OPENSSL', '-pthread', '-I' + root]
+               + shlex.split(os.environ.get('CXXFLAGS', '')) + sources + ['-o', binary]
+               + shlex.split(os.environ.get('LDFLAGS', '')) + ['-lssl', '-lcrypto'])
+    subprocess.run(command, check=True)
+
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.load_cert_chain(cert, key)
+    server = Server(('127.0.0.1', 0), Handler)
+    server.socket = context.wrap_socket(server.socket, server_side=True)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+
+    result = subprocess.run([binary, str(server.server_address[1]), cert])
+    server.shutdown()
+    return result.returncode
+
+
+if __name__ == '__main__':
+    sys.exit(main())